@@ -49,15 +49,19 @@ public:
 
 // Derived class: Savings Account
 class SavingsAccount : public Account {
+public:
+    static const int DEFAULT_MAX_WITHDRAWALS = 20;
+
 private:
     double interestRate;
     double minimumBalance;
     int withdrawalCount;
-    static const int MAX_WITHDRAWALS = 20;
+    int maxWithdrawals;                     // Per month (MAX_WITHDRAWAL_PER_MONTH in bank_config.txt)
 
 public:
     // Constructor
-    SavingsAccount(string accNum, string custId, double initialBalance, double intRate = 0.04);
+    SavingsAccount(string accNum, string custId, double initialBalance, double intRate = 0.04,
+                   int monthlyWithdrawals = DEFAULT_MAX_WITHDRAWALS);
     
     // Override virtual functions
     void deposit(double amount) override;
@@ -69,6 +73,12 @@ public:
     void applyInterest();
     double getInterestRate() const;
     int getRemainingWithdrawals() const;
+    int getMaxWithdrawals() const;
+    void setMaxWithdrawals(int limit);
+    double getMinimumBalance() const;
+    void setMinimumBalance(double minimum);
+    int getWithdrawalCount() const;
+    void setWithdrawalCount(int count);     // Restores a count saved before a rolled-back withdrawal
     void resetWithdrawalCount();
 };
 
@@ -93,7 +103,13 @@ public:
     double getAvailableBalance() const;
     void setOverdraftLimit(double limit);
     double getOverdraftLimit() const;
+    double getTransactionFee() const;
+    void setTransactionFee(double fee);
+    int getFreeTransactions() const;
+    void setFreeTransactions(int count);
     void chargeFee();
+    int getTransactionCount() const;
+    void setTransactionCount(int count);    // Restores a count saved before a rolled-back transaction
     void resetTransactionCount();
 };
 
@@ -0,0 +1,368 @@
+#ifndef ASYNC_H
+#define ASYNC_H
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include "ThreadPool.h"
+
+using namespace std;
+
+// C++20 coroutine support for the asynchronous Bank API.
+//
+// A Task<T> is a lazily started coroutine returning T: it runs when awaited
+// (co_await task), driven by syncWait(task) from ordinary code, or detached
+// with spawn(task). Suspension points in this codebase are lock acquisition
+// (AsyncMutex) and WAL durability (TransactionManager::waitForDurableCommit);
+// both resume the coroutine on the async executor, so a waiting request holds
+// no thread.
+
+template <typename T> class Task;
+
+// Executor that suspended coroutines are resumed on (created on first use)
+ThreadPool& getAsyncExecutor();
+
+// =============================================================================
+// TASK
+// =============================================================================
+
+// Promise state shared by every Task: who to resume when done, and any exception
+class TaskPromiseBase {
+public:
+    coroutine_handle<> continuation;
+    exception_ptr exception;
+
+    // Hands control straight back to the awaiting coroutine (no stack growth)
+    struct FinalAwaiter {
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        template <typename Promise>
+        coroutine_handle<> await_suspend(coroutine_handle<Promise> handle) noexcept {
+            coroutine_handle<> next = handle.promise().continuation;
+            return next ? next : noop_coroutine();
+        }
+
+        void await_resume() noexcept {
+        }
+    };
+
+    suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() noexcept {
+        return {};
+    }
+
+    void unhandled_exception() noexcept {
+        exception = current_exception();
+    }
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    optional<T> value;
+
+    Task<T> get_return_object() noexcept;
+
+    template <typename Value>
+    void return_value(Value&& result) {
+        value.emplace(forward<Value>(result));
+    }
+
+    T takeResult() {
+        if (exception) {
+            rethrow_exception(exception);
+        }
+        return move(*value);
+    }
+};
+
+template <>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {
+    }
+
+    void takeResult() {
+        if (exception) {
+            rethrow_exception(exception);
+        }
+    }
+};
+
+// Lazily started, move-only coroutine handle
+template <typename T>
+class Task {
+public:
+    using promise_type = TaskPromise<T>;
+
+private:
+    coroutine_handle<promise_type> handle;
+
+public:
+    explicit Task(coroutine_handle<promise_type> coroutine) : handle(coroutine) {
+    }
+
+    Task(Task&& other) noexcept : handle(exchange(other.handle, nullptr)) {
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task& other) = delete;
+    Task& operator=(const Task& other) = delete;
+
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    // Awaiting starts the task and resumes the awaiter with its result
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    coroutine_handle<> await_suspend(coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    T await_resume() {
+        return handle.promise().takeResult();
+    }
+};
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+// =============================================================================
+// RUNNING TASKS
+// =============================================================================
+
+// Blocks until signalled; the bridge between coroutines and blocking callers
+class CompletionLatch {
+private:
+    mutex latchMutex;
+    condition_variable latchSignal;
+    bool done = false;
+
+public:
+    void signal() {
+        lock_guard<mutex> lock(latchMutex);
+        done = true;
+        latchSignal.notify_all();
+    }
+
+    void wait() {
+        unique_lock<mutex> lock(latchMutex);
+        latchSignal.wait(lock, [this] { return done; });
+    }
+};
+
+// Eagerly started, self-destroying coroutine used by syncWait and spawn
+class DetachedTask {
+public:
+    struct promise_type {
+        DetachedTask get_return_object() noexcept {
+            return {};
+        }
+
+        suspend_never initial_suspend() noexcept {
+            return {};
+        }
+
+        suspend_never final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() noexcept {
+        }
+
+        void unhandled_exception() noexcept;
+    };
+};
+
+// Run task to completion on the calling thread's behalf and return its result
+template <typename T>
+T syncWait(Task<T> task) {
+    CompletionLatch latch;
+    exception_ptr failure;
+    optional<conditional_t<is_void_v<T>, bool, T>> result;
+    auto runner = [&]() -> DetachedTask {
+        try {
+            if constexpr (is_void_v<T>) {
+                co_await move(task);
+                result.emplace(true);
+            } else {
+                result.emplace(co_await move(task));
+            }
+        } catch (...) {
+            failure = current_exception();
+        }
+        latch.signal();
+    };
+    runner();
+    latch.wait();
+    if (failure) {
+        rethrow_exception(failure);
+    }
+    if constexpr (!is_void_v<T>) {
+        return move(*result);
+    }
+}
+
+// Start task without waiting for it (exceptions are reported and dropped)
+void spawn(Task<void> task);
+
+// co_await resumeOn(pool): continue the coroutine on one of pool's workers
+struct ResumeOnAwaiter {
+    ThreadPool& pool;
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(coroutine_handle<> handle) {
+        pool.submit([handle] { handle.resume(); });
+    }
+
+    void await_resume() const noexcept {
+    }
+};
+
+inline ResumeOnAwaiter resumeOn(ThreadPool& pool) {
+    return ResumeOnAwaiter{pool};
+}
+
+// co_await whenCalled(start): start(resume) begins an operation that calls
+// resume() exactly once, from any thread, when it completes; the coroutine
+// continues on the async executor
+struct CallbackAwaiter {
+    function<void(function<void()>)> start;
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(coroutine_handle<> handle) {
+        start([handle] { getAsyncExecutor().submit([handle] { handle.resume(); }); });
+    }
+
+    void await_resume() const noexcept {
+    }
+};
+
+inline CallbackAwaiter whenCalled(function<void(function<void()>)> start) {
+    return CallbackAwaiter{move(start)};
+}
+
+// =============================================================================
+// ASYNC MUTEX
+// =============================================================================
+
+class AsyncMutex;
+
+// Ownership of an AsyncMutex; releases it on destruction
+class AsyncLockGuard {
+private:
+    AsyncMutex* owner;
+
+public:
+    explicit AsyncLockGuard(AsyncMutex* mutexToRelease = nullptr) : owner(mutexToRelease) {
+    }
+
+    AsyncLockGuard(AsyncLockGuard&& other) noexcept : owner(exchange(other.owner, nullptr)) {
+    }
+
+    AsyncLockGuard& operator=(AsyncLockGuard&& other) noexcept;
+    AsyncLockGuard(const AsyncLockGuard& other) = delete;
+    AsyncLockGuard& operator=(const AsyncLockGuard& other) = delete;
+
+    ~AsyncLockGuard() {
+        unlock();
+    }
+
+    // Release early
+    void unlock();
+
+    bool ownsLock() const {
+        return owner != nullptr;
+    }
+};
+
+// Mutex whose lock() suspends the coroutine instead of blocking the thread.
+// Waiters are served FIFO; unlock() hands ownership directly to the next
+// waiter and resumes it on the async executor.
+class AsyncMutex {
+private:
+    mutex stateMutex;
+    bool locked = false;
+    deque<coroutine_handle<>> waiters;
+
+public:
+    AsyncMutex() = default;
+    AsyncMutex(const AsyncMutex& other) = delete;
+    AsyncMutex& operator=(const AsyncMutex& other) = delete;
+
+    struct LockAwaiter {
+        AsyncMutex& target;
+
+        bool await_ready() {
+            return target.tryAcquire();
+        }
+
+        bool await_suspend(coroutine_handle<> handle) {
+            return target.enqueue(handle);
+        }
+
+        AsyncLockGuard await_resume() noexcept {
+            return AsyncLockGuard(&target);
+        }
+    };
+
+    // co_await mutex.lock() yields an AsyncLockGuard
+    LockAwaiter lock() {
+        return LockAwaiter{*this};
+    }
+
+    // Acquire without waiting (empty guard if the mutex is held)
+    AsyncLockGuard tryLock() {
+        return AsyncLockGuard(tryAcquire() ? this : nullptr);
+    }
+
+    // Block the calling thread until the lock is its own, queued FIFO with the
+    // coroutines (for ordinary threads; not from the async executor itself)
+    AsyncLockGuard lockBlocking();
+
+    // Internal: take the lock if free; queue handle otherwise (false = got it after all)
+    bool tryAcquire();
+    bool enqueue(coroutine_handle<> handle);
+    void release();
+};
+
+#endif // ASYNC_H
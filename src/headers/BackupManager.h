@@ -0,0 +1,78 @@
+#ifndef BACKUPMANAGER_H
+#define BACKUPMANAGER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include "Transaction.h"
+#include "LedgerSnapshot.h"
+
+using namespace std;
+
+// One backup set listed in the manifest
+struct BackupEntry {
+    int sequence = 0;
+    bool full = false;              // FULL = whole ledger, INCR = records changed since the previous set
+    string fileName;
+    size_t recordCount = 0;
+    string createdAt;
+};
+
+// Incremental transaction backups. Each set is a file of Transaction records
+// (see Transaction::toRecord); backup/manifest.txt lists the chain in order.
+// Restoring applies the newest full set at or before the target sequence,
+// then every incremental set after it, later records replacing earlier ones.
+class BackupManager {
+private:
+    string backupDirectory;
+    vector<BackupEntry> manifest;
+
+    string getManifestPath() const;
+    bool loadManifest();
+    bool appendManifest(const BackupEntry& entry) const;
+
+public:
+    // Constructor (reads the existing manifest, if any)
+    BackupManager(string directory = "backup/");
+
+    // Write a new backup set; fills in the manifest entry on success.
+    // maxBytesPerSecond > 0 paces the writes so a background backup does not
+    // compete with the WAL for disk bandwidth.
+    bool writeBackup(const vector<const Transaction*>& records, bool full, BackupEntry& entry,
+                     size_t maxBytesPerSecond = 0);
+
+    // Rebuild the ledger as of a backup set (-1 = latest)
+    bool restore(TransactionMap& transactions, int upToSequence = -1) const;
+
+    // Manifest queries
+    const vector<BackupEntry>& getManifest() const;
+    int getIncrementalsSinceFull() const;
+    string getBackupDirectory() const;
+
+    // Display functions
+    void displayManifest() const;
+};
+
+// Backup set being written in the background (TransactionManager::startBackup).
+// The records point into snapshot, which keeps them alive and unchanged while
+// the ledger goes on committing.
+struct BackupJob {
+    BackupManager manager;
+    shared_ptr<const LedgerSnapshot> snapshot;
+    vector<const Transaction*> records;
+    vector<string> journal;                 // IDs covered; handed back to the ledger if the write fails
+    bool full = false;
+    size_t maxBytesPerSecond = 0;
+    BackupEntry entry;
+    bool succeeded = false;
+    atomic<bool> finished{false};
+    thread writer;
+
+    BackupJob(string directory) : manager(move(directory)) {
+    }
+};
+
+#endif // BACKUPMANAGER_H
@@ -9,6 +9,13 @@
 #include "Customer.h"
 #include "Transaction.h"
 #include "Utilities.h"
+#include "MonthEndProcessor.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include "MetricsExporter.h"
+#include "Async.h"
+#include "LedgerSnapshot.h"
+#include "ConfigManager.h"
 
 using namespace std;
 
@@ -31,12 +38,32 @@ private:
     double minCheckingBalance;
     double defaultOverdraftLimit;
     double savingsInterestRate;
+    unique_ptr<ConfigManager> configManager;            // config/*.txt, reloaded when the files change
+    unique_ptr<ConfigReader> configReader;              // Version check on each operation (no lock)
+    
+    // Apply a newer config snapshot to the fields above, every account and the
+    // transaction limits (BankConfiguration.cpp). Called at the start of each
+    // operation; does nothing until loadConfiguration() has been called.
+    void syncConfiguration();
+    void applyConfiguration(const BankConfig& config);
+    void configureAccount(Account* account);            // Fee, free transactions, minimum balance, ...
     
     // System statistics
     double totalDeposits;
     double totalWithdrawals;
     int totalCustomersCreated;
     int totalAccountsCreated;
+    
+    // Monitoring endpoint. bank.total_balance and bank.accounts are recounted
+    // when the exporter starts and after month-end; deposits, withdrawals and
+    // transfers move bank.total_balance by what they changed.
+    unique_ptr<MetricsExporter> metricsExporter;
+    void publishAccountGauges() const;                  // Recount both gauges (BankMonitoring.cpp)
+    static void adjustTotalBalanceGauge(double delta);  // After one operation moves money
+
+    // Serializes concurrent callers: the asynchronous operations co_await it
+    // without blocking executor threads, BankServer workers block on it
+    AsyncMutex asyncLock;
 
 public:
     // Constructor and Destructor
@@ -62,13 +89,31 @@ public:
     vector<Account*> getCustomerAccounts(string customerId) const;
     bool transferAccountOwnership(string accountNumber, string newCustomerId);
     
-    // Transaction Operations
-    bool deposit(string accountNumber, double amount, string description = "Deposit");
-    bool withdraw(string accountNumber, double amount, string description = "Withdrawal");
+    // Transaction Operations (BankTransactions.cpp). A non-empty idempotencyKey
+    // makes the call safe to retry: a key already committed within its TTL
+    // returns true without moving any money again.
+    bool deposit(string accountNumber, double amount, string description = "Deposit",
+                 string idempotencyKey = "");
+    bool withdraw(string accountNumber, double amount, string description = "Withdrawal",
+                  string idempotencyKey = "");
     bool transfer(string fromAccount, string toAccount, double amount, 
-                 string description = "Transfer");
+                 string description = "Transfer", string idempotencyKey = "");
     bool applyInterestToSavingsAccounts();
     bool chargeMonthlyFees();
+    MonthEndSummary runMonthEndProcessing(const MonthEndOptions& options = MonthEndOptions()); // Fee defaults to TRANSACTION_FEE
+
+    // Asynchronous Transaction Operations (co_await bank.transferAsync(...)): they
+    // suspend rather than block while waiting for the bank or for the WAL fsync, and
+    // complete once the change is durable. Not to be mixed with concurrent sync calls.
+    Task<bool> depositAsync(string accountNumber, double amount, string description = "Deposit",
+                            string idempotencyKey = "");
+    Task<bool> withdrawAsync(string accountNumber, double amount, string description = "Withdrawal",
+                             string idempotencyKey = "");
+    Task<bool> transferAsync(string fromAccount, string toAccount, double amount,
+                             string description = "Transfer", string idempotencyKey = "");
+    Task<double> getAccountBalanceAsync(string accountNumber);
+    Task<bool> waitForDurableCommits();                 // False if the WAL could not be synced
+    AsyncMutex& getOperationLock();                     // Hold around sync calls made alongside the async ones
     
     // Account Services
     bool freezeAccount(string accountNumber, string reason);
@@ -83,9 +128,15 @@ public:
                                                     int limit = 100) const;
     double getAccountNetFlow(string accountNumber, string startDate = "", 
                            string endDate = "") const;
+    shared_ptr<const LedgerSnapshot> getLedgerSnapshot() const; // Pinned version for reports (LedgerSnapshot.h)
     
     // System Administration
-    void displaySystemStatistics() const;
+    void displaySystemStatistics() const;                   // Includes per-operation latency (Metrics)
+    bool writePerformanceStatistics(string filename = "logs/performance_stats.json") const;
+    void startExecutionTrace();                             // Record load/save/reindex/query/export/batch spans
+    bool writeExecutionTrace(string filename = "logs/execution_trace.json");
+    bool startMetricsExporter(int port = MetricsExporter::DEFAULT_PORT);  // Prometheus text on 127.0.0.1
+    void stopMetricsExporter();
     void displayAllCustomers() const;
     void displayAllAccounts() const;
     void displayLargeTransactions(double minAmount) const;
@@ -103,6 +154,10 @@ public:
     void setMinimumBalances(double savingsMin, double checkingMin);
     void setDefaultOverdraftLimit(double limit);
     void setSavingsInterestRate(double rate);
+    bool loadConfiguration(string bankConfigFile = "config/bank_config.txt",
+                           string adminSettingsFile = "config/admin_settings.txt"); // Load, apply and watch
+    shared_ptr<const BankConfig> getConfiguration() const;  // Defaults until a configuration is loaded
+    bool reloadConfiguration();                             // Normally done by the file watcher
     void displaySystemConfiguration() const;
     
     // Data Persistence
@@ -0,0 +1,106 @@
+#ifndef BANKPROTOCOL_H
+#define BANKPROTOCOL_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Operations a BankServer client can request
+enum class BankOperation : uint8_t {
+    PING = 1,
+    BALANCE = 2,
+    DEPOSIT = 3,
+    WITHDRAW = 4,
+    TRANSFER = 5,
+    HISTORY = 6
+};
+
+// Outcome of a request
+enum class ReplyStatus : uint16_t {
+    OK = 0,
+    REJECTED = 1,               // Bank refused it (funds, limits, frozen account...)
+    UNKNOWN_ACCOUNT = 2,
+    BAD_REQUEST = 3,            // Malformed arguments
+    UNKNOWN_OPERATION = 4,
+    NOT_DURABLE = 5             // Applied, but the write-ahead log could not be synced
+};
+
+// One decoded request. The strings are views into the buffer the request was
+// decoded from (a text line or a binary frame) and are only valid while it is.
+struct BankRequest {
+    uint64_t requestId = 0;
+    BankOperation operation = BankOperation::PING;
+    string_view account;
+    string_view toAccount;                  // TRANSFER only
+    string_view description;                // Optional; empty = the Bank default
+    string_view idempotencyKey;             // DEPOSIT/WITHDRAW/TRANSFER; optional client retry key
+    double amount = 0.0;
+    uint32_t limit = 50;                    // HISTORY only
+};
+
+// One history row in a reply
+struct HistoryEntry {
+    string transactionId;
+    uint8_t transactionType = 0;            // TransactionType value
+    double amount = 0.0;
+    double balanceAfter = 0.0;
+    string timestamp;
+};
+
+// Result of executing a request
+struct BankReply {
+    ReplyStatus status = ReplyStatus::OK;
+    double balance = 0.0;                   // BALANCE/DEPOSIT/WITHDRAW/TRANSFER (source account)
+    vector<HistoryEntry> history;           // HISTORY
+    string message;                         // Error detail
+};
+
+// Length-prefixed binary framing (all integers little-endian, doubles as IEEE-754 bits).
+//
+//   header (16 bytes): u8 magic 0xB1 | u8 operation | u16 status (0 in requests)
+//                      | u32 frame length including the header | u64 request id
+//   request payloads:  BALANCE   str account
+//                      DEPOSIT   f64 amount, str account, str description, str idempotency key
+//                      WITHDRAW  f64 amount, str account, str description, str idempotency key
+//                      TRANSFER  f64 amount, str from, str to, str description, str idempotency key
+//                      HISTORY   u32 limit, str account
+//   reply payloads:    OK balance replies  f64 balance
+//                      OK HISTORY          u32 count, count x (str id, u8 type, f64 amount,
+//                                          f64 balance after, str timestamp)
+//                      errors              str message
+//   str = u16 length + bytes
+//
+// An empty idempotency key means none. A retried request with the same key is
+// answered OK without moving money again; frames without the key field (older
+// clients) are accepted as having none.
+//
+// The magic byte is never valid text, so a server can tell a binary client
+// from a text one by the first byte it sends. Request ids are echoed back, so
+// replies may arrive in any order.
+class BinaryProtocol {
+public:
+    static const uint8_t MAGIC = 0xB1;
+    static const size_t HEADER_SIZE = 16;
+    static const size_t MAX_FRAME_SIZE = 1 << 20;
+    static const size_t INCOMPLETE = 0;
+    static const size_t MALFORMED = static_cast<size_t>(-1);
+
+    // Size of the frame at the start of buffer (INCOMPLETE, or MALFORMED if it is
+    // not a frame or declares more than maxSize bytes)
+    static size_t frameSize(string_view buffer, size_t maxSize = MAX_FRAME_SIZE);
+
+    // Decode a request frame; the request's strings point into frame
+    static bool decodeRequest(string_view frame, BankRequest& request);
+
+    // Append an encoded frame to out
+    static void encodeRequest(string& out, const BankRequest& request);
+    static void encodeReply(string& out, BankOperation operation, uint64_t requestId, const BankReply& reply);
+
+    // Decode a reply frame (client side)
+    static bool decodeReply(string_view frame, BankOperation& operation, uint64_t& requestId, BankReply& reply);
+};
+
+#endif // BANKPROTOCOL_H
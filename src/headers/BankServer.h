@@ -0,0 +1,114 @@
+#ifndef BANKSERVER_H
+#define BANKSERVER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include "ThreadPool.h"
+#include "BankProtocol.h"
+
+using namespace std;
+
+class Bank;
+class ServerReactor;
+
+// Server configuration
+struct BankServerOptions {
+    string bindAddress = "127.0.0.1";
+    int port = 7878;                        // 0 = pick a free port (see getPort())
+    string unixSocketPath;                  // Also listen on this Unix socket when set
+    size_t reactorCount = 0;                // Event-loop threads (0 = up to 4, one per core)
+    size_t workerCount = 0;                 // Request threads (0 = one per core)
+    size_t maxConnections = 10000;
+    size_t maxRequestBytes = 4096;          // Longest accepted request line or binary frame
+    size_t maxBufferedBytes = 65536;        // Unprocessed input per connection before reads pause
+    size_t maxPipelinedBatches = 16;        // Binary frame batches in flight per connection
+};
+
+// Event-driven front end for Bank. An acceptor thread hands new connections
+// round-robin to reactor threads, each running its own epoll loop; complete
+// requests are executed on a worker pool and the responses are handed back to
+// the owning reactor to write.
+//
+// A connection speaks the binary protocol (BankProtocol.h) if its first byte
+// is BinaryProtocol::MAGIC, otherwise the text protocol. Binary clients may
+// pipeline freely: every complete frame in the receive buffer becomes one
+// batch, executed under a single bank lock, and replies are matched by
+// request id. Text connections have one request in flight, answered in order.
+//
+// Text protocol: one request per line, one "OK ..." or "ERR ..." response line
+// (HISTORY is followed by one line per transaction).
+//   PING
+//   BALANCE  <account>
+//   DEPOSIT  <account> <amount> [key=<idempotency key>] [description]
+//   WITHDRAW <account> <amount> [key=<idempotency key>] [description]
+//   TRANSFER <from> <to> <amount> [key=<idempotency key>] [description]
+//   HISTORY  <account> [limit]
+//   QUIT
+//
+// Bank is not thread-safe, so workers hold the Bank's operation lock (the one
+// its async operations use) around every Bank call; parsing, formatting and
+// all socket I/O run outside it. DEPOSIT, WITHDRAW and TRANSFER are answered
+// OK only once the write-ahead log holds them on disk (the wait happens after
+// the lock is released, so concurrent requests share one fsync); if the sync
+// fails they are answered "ERR not durable" (ReplyStatus::NOT_DURABLE).
+class BankServer {
+public:
+    static constexpr uint32_t MAX_HISTORY_ROWS = 1000; // Keeps HISTORY replies within one frame
+
+private:
+    Bank& bank;
+    BankServerOptions options;
+    ThreadPool workers;
+    vector<unique_ptr<ServerReactor>> reactors;
+    vector<int> listenSockets;
+    int stopEvent;                          // eventfd that wakes the acceptor
+    int port;
+    thread acceptThread;
+    atomic<bool> running;
+    atomic<size_t> openConnections;
+
+    void acceptLoop();
+    BankReply execute(const BankRequest& request);
+    bool listenTcp();
+    bool listenUnix();
+
+public:
+    BankServer(Bank& servedBank, const BankServerOptions& serverOptions = BankServerOptions());
+    ~BankServer();
+
+    // Prevent copying (threads hold a pointer to this server)
+    BankServer(const BankServer& other) = delete;
+    BankServer& operator=(const BankServer& other) = delete;
+
+    // Open the listening sockets and start the reactor threads
+    bool start();
+
+    // Stop accepting, finish in-flight requests and close every connection
+    void stop();
+
+    bool isRunning() const;
+    int getPort() const;
+    size_t getOpenConnectionCount() const;
+    const BankServerOptions& getOptions() const;
+
+    // Execute one request line and return the full response (including the trailing newline)
+    string handleRequest(const string& request);
+
+    // Execute a batch of complete binary frames and return the encoded replies
+    string handleFrames(const string& frames);
+
+    // Called by reactors as connections open and close
+    void connectionOpened();
+    void connectionClosed();
+    bool acceptsMoreConnections() const;
+
+    // Queue work for the worker pool; done(response) runs on a worker thread
+    void dispatch(string request, function<void(string)> done);
+    void dispatchFrames(string frames, function<void(string)> done);
+};
+
+#endif // BANKSERVER_H
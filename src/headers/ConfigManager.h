@@ -0,0 +1,120 @@
+#ifndef CONFIGMANAGER_H
+#define CONFIGMANAGER_H
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include "LimitEngine.h"
+
+using namespace std;
+
+// Typed contents of config/bank_config.txt and config/admin_settings.txt.
+// Keys missing from the files keep these defaults.
+struct BankConfig {
+    // bank_config.txt
+    double minSavingsBalance = 500.0;           // MIN_SAVINGS_BALANCE
+    double minCheckingBalance = 100.0;          // MIN_CHECKING_BALANCE
+    double savingsInterestRate = 0.04;          // SAVINGS_INTEREST_RATE
+    double loanInterestRate = 0.08;             // LOAN_INTEREST_RATE
+    LimitRules limits;                          // MAX_DAILY_WITHDRAWAL, MAX_TRANSFER_AMOUNT, MAX_WITHDRAWAL_PER_MONTH, ...
+    double overdraftLimit = 500.0;              // OVERDRAFT_LIMIT
+    double transactionFee = 2.50;               // TRANSACTION_FEE
+    double monthlyMaintenanceFee = 2.50;        // MONTHLY_MAINTENANCE_FEE (checking, charged at month end)
+    int freeTransactions = 10;                  // FREE_TRANSACTIONS (checking, per month)
+    int sessionTimeoutSeconds = 1800;           // SESSION_TIMEOUT
+    int maxLoginAttempts = 3;                   // MAX_LOGIN_ATTEMPTS
+    int backupIntervalHours = 24;               // BACKUP_INTERVAL
+
+    // admin_settings.txt
+    string adminUsername = "admin";             // ADMIN_USERNAME
+    string adminPasswordHash;                   // ADMIN_PASSWORD_HASH (SHA-256, hex)
+    int passwordMinLength = 8;                  // PASSWORD_MIN_LENGTH
+    bool requireSpecialChars = true;            // REQUIRE_SPECIAL_CHARS
+    int adminSessionTimeoutSeconds = 3600;      // SESSION_TIMEOUT
+    bool autoBackup = true;                     // AUTO_BACKUP
+    int logRetentionDays = 30;                  // LOG_RETENTION_DAYS
+    uint64_t maxLogSizeBytes = 10 << 20;        // MAX_LOG_SIZE (KB/MB/GB suffixes accepted)
+
+    uint64_t version = 0;                       // Set by ConfigManager; 0 = defaults, never loaded
+};
+
+// Loads the config files into an immutable BankConfig and publishes it as a
+// shared snapshot. A reload builds a complete new snapshot and swaps it in;
+// readers keep whichever snapshot they hold, so they never see a half-applied
+// change and never wait for a reload. A file that fails to parse or validate
+// is reported and the previous snapshot stays in force.
+//
+// startWatching() polls the files' modification times on a background thread
+// and reloads when either changes, so edits take effect without a restart.
+class ConfigManager {
+private:
+    string bankConfigPath;
+    string adminSettingsPath;
+    atomic<shared_ptr<const BankConfig>> snapshot;
+    atomic<uint64_t> version;                   // snapshot's version, readable without touching it
+    mutex reloadMutex;                          // One load at a time (caller or watcher)
+    string loadedStamp;                         // File sizes and modification times at the last load
+
+    // Watcher thread
+    thread watchThread;
+    mutex watchMutex;
+    condition_variable watchSignal;
+    bool watchStopping;
+
+    string getFileStamp() const;
+    void watchLoop(chrono::milliseconds interval);
+
+public:
+    ConfigManager(string bankConfigFile = "config/bank_config.txt",
+                  string adminSettingsFile = "config/admin_settings.txt");
+    ~ConfigManager();
+
+    // Prevent copying (the watcher thread holds a pointer to this manager)
+    ConfigManager(const ConfigManager& other) = delete;
+    ConfigManager& operator=(const ConfigManager& other) = delete;
+
+    // Parse both files and publish them; false (previous snapshot kept) on error
+    bool load();
+
+    // Reload whenever a file changes, checking every interval
+    void startWatching(chrono::milliseconds interval = chrono::milliseconds(2000));
+    void stopWatching();
+    bool isWatching() const;
+
+    // Current snapshot (never null; defaults until the first successful load)
+    shared_ptr<const BankConfig> get() const;
+    uint64_t getVersion() const;
+
+    // Parse a KEY=VALUE file into config (only the keys it recognizes)
+    static bool parseBankConfig(const string& path, BankConfig& config);
+    static bool parseAdminSettings(const string& path, BankConfig& config);
+};
+
+// Cached view of a ConfigManager for a hot path owned by one thread: get()
+// is a single atomic load of the version until a reload publishes a new
+// snapshot, which it then picks up on the next call.
+class ConfigReader {
+private:
+    const ConfigManager* manager;
+    shared_ptr<const BankConfig> cached;
+
+public:
+    explicit ConfigReader(const ConfigManager& source);
+
+    // Current config (refreshed first if a reload has happened)
+    const BankConfig& get();
+
+    // Snapshot picked up by the last get() or refresh(), without a version check
+    // (stays valid while callers iterate over it)
+    const BankConfig& current() const;
+
+    // Pick up a newer snapshot; true if there was one
+    bool refresh();
+};
+
+#endif // CONFIGMANAGER_H
@@ -0,0 +1,58 @@
+#ifndef CUSTOMERSUMMARIES_H
+#define CUSTOMERSUMMARIES_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include "Transaction.h"
+#include "TransactionRollups.h"
+
+using namespace std;
+
+// Enough of a transaction to list it on a dashboard
+struct RecentTransaction {
+    string transactionId;
+    TransactionType type = TransactionType::UNKNOWN;
+    double amount = 0.0;
+    string date;                                        // YYYY-MM-DD
+};
+
+// Lifetime totals for one customer across all of their accounts, plus the
+// most recent transactions in a fixed-size ring
+struct CustomerSummary {
+    static const size_t RECENT_CAPACITY = 8;
+
+    array<RollupTotals, TRANSACTION_TYPE_COUNT> typeTotals{};
+    array<RecentTransaction, RECENT_CAPACITY> recent;
+    size_t recentNext = 0;                              // Ring slot the next transaction goes to
+    size_t recentCount = 0;
+
+    void add(const Transaction& transaction);
+    void addRecent(RecentTransaction entry);
+    RollupTotals getTotal() const;
+    vector<RecentTransaction> getRecent(size_t limit = RECENT_CAPACITY) const;  // Newest first
+};
+
+// Per-customer summaries maintained by TransactionManager on every new
+// transaction (every status counts, as in the ledger-wide statistics), so a
+// customer's lifetime totals are one hash lookup however long their history.
+class CustomerSummaries {
+private:
+    unordered_map<string, CustomerSummary> customers;   // CustomerId -> summary
+
+public:
+    void add(const Transaction& transaction);
+    void merge(const CustomerSummaries& other);         // other's rows are older than this one's
+    void clear();
+
+    const CustomerSummary* find(const string& customerId) const;
+    size_t size() const;
+
+    // Persistence ("T <customer> <type> <count> <amount> <net>" and
+    // "R <customer> <id> <type> <amount> <date>" lines, recent rows oldest first)
+    bool save(const string& path) const;
+    bool load(const string& path);
+};
+
+#endif // CUSTOMERSUMMARIES_H
@@ -0,0 +1,75 @@
+#ifndef IDEMPOTENCYTABLE_H
+#define IDEMPOTENCYTABLE_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <ctime>
+
+using namespace std;
+
+// Remembers which transaction each client idempotency key produced, so a
+// retried request returns the original result instead of committing again.
+//
+// Keys are spread over independently locked shards. In front of them sit two
+// Bloom filters (current and previous generation, swapped every TTL): a key
+// in neither has never been seen within the TTL, which is the common case and
+// costs a few bit tests with no lock. Entries expire after the TTL; each shard
+// drops expired entries lazily and in a periodic sweep.
+class IdempotencyTable {
+public:
+    static const size_t SHARD_COUNT = 16;
+    static const size_t HASH_COUNT = 4;             // Bloom filter probes per key
+
+private:
+    struct Entry {
+        string result;
+        time_t expiresAt;
+    };
+
+    struct Shard {
+        mutex lock;
+        unordered_map<string, Entry> entries;
+        size_t insertsSinceSweep = 0;
+    };
+
+    time_t ttlSeconds;
+    array<Shard, SHARD_COUNT> shards;
+    size_t filterMask;                              // Bits per filter - 1 (power of two)
+    array<unique_ptr<atomic<uint64_t>[]>, 2> filters;
+    atomic<size_t> currentFilter;
+    atomic<time_t> filterRotatedAt;
+    mutex rotateMutex;
+
+    Shard& getShard(size_t hash);
+    bool filterContains(size_t filter, size_t hash) const;
+    void filterAdd(size_t filter, size_t hash);
+    void rotateFiltersIfDue(time_t now);
+
+public:
+    // ttl: how long a key is remembered; expectedKeys sizes the filters (~10 bits per key)
+    IdempotencyTable(time_t ttl = 24 * 60 * 60, size_t expectedKeys = 1 << 20);
+
+    // Prevent copying (atomics and mutexes)
+    IdempotencyTable(const IdempotencyTable& other) = delete;
+    IdempotencyTable& operator=(const IdempotencyTable& other) = delete;
+
+    // Look up a key; true (with its result) if it was recorded within the TTL
+    bool find(const string& key, string& result);
+
+    // Record the result for a key first seen at createdAt
+    void remember(const string& key, const string& result, time_t createdAt = time(nullptr));
+
+    // Drop a key whose result no longer stands (a retry then commits again)
+    void forget(const string& key);
+
+    void clear();
+    size_t size();
+    time_t getTtl() const;
+};
+
+#endif // IDEMPOTENCYTABLE_H
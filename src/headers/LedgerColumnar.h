@@ -0,0 +1,136 @@
+#ifndef LEDGERCOLUMNAR_H
+#define LEDGERCOLUMNAR_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include "Transaction.h"
+
+using namespace std;
+
+// =============================================================================
+// COLUMNAR LEDGER FORMAT
+// =============================================================================
+//
+// Self-contained columnar file laid out like Parquet: the rows are split into
+// row groups, each row group stores one contiguous chunk per column, and a
+// footer at the end of the file describes the schema, the byte range of every
+// column chunk and per-chunk min/max statistics. A reader only needs the footer
+// to seek straight to the columns it wants and can skip row groups by their
+// statistics.
+//
+//   "BLCOL001" | row group 0 chunks | row group 1 chunks | ... | footer | u64 footer size | "BLCOL001"
+//
+// Column chunk encodings (integers and doubles little-endian on every host):
+//   FLOAT64 / UINT8  PLAIN       raw values, one after another
+//   STRING           PLAIN       u32 offsets[rows + 1], then the string bytes
+//   STRING           DICTIONARY  u32 entries, u32 offsets[entries + 1], entry bytes,
+//                                then u32 dictionary index per row
+//   STRING           PREFIX      per row: varint bytes shared with the previous value,
+//                                varint suffix length, suffix bytes (front coding)
+//
+// The writer stores each string chunk in whichever encoding is smallest:
+// dictionary for repeated values (descriptions, account numbers), prefix for
+// sorted or near-sorted ones (transaction IDs, timestamps).
+
+// Physical column type
+enum class ColumnType : uint8_t {
+    FLOAT64,
+    UINT8,
+    STRING
+};
+
+// Column chunk encoding
+enum class ColumnEncoding : uint8_t {
+    PLAIN,
+    DICTIONARY,
+    PREFIX
+};
+
+// Ledger columns in file order
+enum class LedgerColumn : uint8_t {
+    TRANSACTION_ID,
+    ACCOUNT_NUMBER,
+    RELATED_ACCOUNT,
+    TRANSACTION_TYPE,
+    AMOUNT,
+    BALANCE_BEFORE,
+    BALANCE_AFTER,
+    TIMESTAMP,
+    DESCRIPTION,
+    STATUS,
+    CUSTOMER_ID,
+    SESSION_ID,
+    NOTES
+};
+
+const size_t LEDGER_COLUMN_COUNT = static_cast<size_t>(LedgerColumn::NOTES) + 1;
+
+// Footer metadata for one column chunk
+struct ColumnChunkInfo {
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    ColumnEncoding encoding = ColumnEncoding::PLAIN;
+    double minValue = 0.0;          // FLOAT64 / UINT8 statistics
+    double maxValue = 0.0;
+    string minString;               // STRING statistics
+    string maxString;
+};
+
+// Footer metadata for one row group
+struct RowGroupInfo {
+    uint64_t rowCount = 0;
+    vector<ColumnChunkInfo> columns;
+};
+
+// Writes the ledger in the columnar format
+class ColumnarLedgerWriter {
+private:
+    size_t rowGroupSize;
+
+    void writeRowGroup(ofstream& file, const vector<const Transaction*>& rows,
+                       size_t begin, size_t end, RowGroupInfo& info) const;
+
+public:
+    // Constructor
+    ColumnarLedgerWriter(size_t rowsPerGroup = 1048576);
+
+    // Write rows (in the given order) to a columnar file
+    bool write(const string& filename, const vector<const Transaction*>& rows) const;
+};
+
+// Reads columnar ledger files, touching only the requested columns
+class ColumnarLedgerReader {
+private:
+    string filename;
+    mutable ifstream file;
+    vector<RowGroupInfo> rowGroups;
+    bool valid;
+
+    bool readChunk(size_t rowGroup, LedgerColumn column, vector<char>& buffer) const;
+
+public:
+    // Constructor (reads and validates the footer)
+    ColumnarLedgerReader(const string& path);
+
+    // File information
+    bool isValid() const;
+    uint64_t getRowCount() const;
+    size_t getRowGroupCount() const;
+    const RowGroupInfo& getRowGroup(size_t rowGroup) const;
+
+    // Column access (one row group at a time)
+    bool readDoubleColumn(size_t rowGroup, LedgerColumn column, vector<double>& values) const;
+    bool readByteColumn(size_t rowGroup, LedgerColumn column, vector<uint8_t>& values) const;
+    bool readStringColumn(size_t rowGroup, LedgerColumn column, vector<string>& values) const;
+
+    // Rebuild full transactions for one row group (reads every column)
+    bool readTransactions(size_t rowGroup, vector<Transaction>& transactions) const;
+
+    // Schema helpers
+    static string getColumnName(LedgerColumn column);
+    static ColumnType getColumnType(LedgerColumn column);
+};
+
+#endif // LEDGERCOLUMNAR_H
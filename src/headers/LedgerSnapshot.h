@@ -0,0 +1,70 @@
+#ifndef LEDGERSNAPSHOT_H
+#define LEDGERSNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include "Transaction.h"
+
+using namespace std;
+
+// One immutable slice of the ledger: consecutive transactions in ID order.
+// Shared between every snapshot taken while the slice did not change. The
+// account index is built on the first history query that reaches the chunk,
+// so snapshots taken only for checkpoints and backups never pay for it.
+struct LedgerChunk {
+    vector<Transaction> rows;
+
+    // Positions in rows of an account's transactions, in ID order (null if none)
+    const vector<uint32_t>* findAccountRows(const string& accountNumber) const;
+
+private:
+    mutable once_flag accountIndexBuilt;
+    mutable unordered_map<string, vector<uint32_t>> accountRows;
+};
+
+// Consistent, read-only view of the ledger at one version (multi-version reads).
+//
+// TransactionManager::getSnapshot() pins the current version in time
+// proportional to the chunks changed or released since the previous snapshot
+// (the manager holds chunks only weakly, while some snapshot pins them); the holder
+// can then scan it on any thread while commits continue against the live
+// ledger. Chunks are reference counted, so an old version is reclaimed as soon
+// as the last reader holding it lets go (no reader ever waits for a writer).
+class LedgerSnapshot {
+private:
+    uint64_t version;                                   // Commits applied when it was taken
+    size_t rowCount;
+    vector<shared_ptr<const LedgerChunk>> chunks;
+
+public:
+    LedgerSnapshot(uint64_t ledgerVersion, vector<shared_ptr<const LedgerChunk>> ledgerChunks);
+
+    // Getters
+    uint64_t getVersion() const;
+    size_t size() const;
+    const vector<shared_ptr<const LedgerChunk>>& getChunks() const;
+
+    // Visit every transaction in ID order
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        for (const shared_ptr<const LedgerChunk>& chunk : chunks) {
+            for (const Transaction& transaction : chunk->rows) {
+                visit(transaction);
+            }
+        }
+    }
+
+    // Queries with the same results as their TransactionManager namesakes (live rows only)
+    const Transaction* findTransaction(const string& transactionId) const;
+    vector<Transaction> getAccountHistory(const string& accountNumber, int limit = 50) const;
+    vector<Transaction> getTransactionsByDateRange(const string& startDate, const string& endDate) const;
+    map<string, double> getLastKnownBalances() const;
+    TransactionStatistics computeStatistics() const;
+};
+
+#endif // LEDGERSNAPSHOT_H
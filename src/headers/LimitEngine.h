@@ -0,0 +1,105 @@
+#ifndef LIMITENGINE_H
+#define LIMITENGINE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <ctime>
+#include "Transaction.h"
+#include "Account.h"
+
+using namespace std;
+
+// Velocity limits (0 = no limit); ConfigManager fills them from config/bank_config.txt
+struct LimitRules {
+    double maxDailyWithdrawal = 5000.0;     // MAX_DAILY_WITHDRAWAL: amount per rolling 24 hours
+    int maxDailyWithdrawalCount = 0;        // MAX_DAILY_WITHDRAWAL_COUNT: withdrawals per rolling 24 hours
+    double maxTransferAmount = 10000.0;     // MAX_TRANSFER_AMOUNT: any single transfer
+    double maxDailyTransfer = 0.0;          // MAX_DAILY_TRANSFER: amount transferred out per rolling 24 hours
+    int maxWithdrawalsPerMonth = SavingsAccount::DEFAULT_MAX_WITHDRAWALS; // MAX_WITHDRAWAL_PER_MONTH: savings accounts
+};
+
+// Which limit a request would break
+enum class LimitViolation {
+    NONE,
+    DAILY_WITHDRAWAL_AMOUNT,
+    DAILY_WITHDRAWAL_COUNT,
+    TRANSFER_AMOUNT,
+    DAILY_TRANSFER_AMOUNT
+};
+
+string limitViolationToString(LimitViolation violation);
+
+// Count and amount over the last bucketCount * bucketSeconds seconds, kept as
+// a ring of buckets with running totals: adding and reading are O(1), and
+// each bucket is cleared once as time moves past it.
+class SlidingWindow {
+private:
+    struct Bucket {
+        int64_t count = 0;
+        double amount = 0.0;
+    };
+
+    vector<Bucket> buckets;
+    time_t bucketSeconds;
+    int64_t newestBucket;                   // Absolute bucket number (time / bucketSeconds)
+    int64_t count;
+    double amount;
+
+    void advance(int64_t bucket);
+
+public:
+    SlidingWindow(size_t bucketCount, time_t bucketSeconds);
+
+    // Add (or, with negative values, remove) an event; events older than the window are ignored
+    void add(time_t when, int64_t eventCount, double eventAmount);
+
+    int64_t getCount(time_t now);
+    double getAmount(time_t now);
+};
+
+// Per-account rolling-window limit enforcement. TransactionManager feeds it
+// every committed withdrawal and outgoing transfer (and takes them back out
+// when they fail, are cancelled or are reversed); check() answers from the
+// windows without touching the ledger. Not thread-safe: callers serialize
+// access like the rest of TransactionManager.
+//
+// The "rolling 24 hours" is the current hour plus the 24 before it, so every
+// event of the last 24 hours counts and an event may keep counting for up to
+// an hour longer: a limit can only err on the strict side.
+class LimitEngine {
+public:
+    static const size_t DAY_BUCKETS = 25;               // One per hour (current hour + 24)
+    static const time_t DAY_BUCKET_SECONDS = 60 * 60;
+
+private:
+    struct AccountWindows {
+        SlidingWindow withdrawals;
+        SlidingWindow transfers;
+
+        AccountWindows();
+    };
+
+    LimitRules rules;
+    unordered_map<string, AccountWindows> accounts;
+
+    void apply(const Transaction& transaction, int direction);
+
+public:
+    explicit LimitEngine(const LimitRules& limitRules = LimitRules());
+
+    // Would this withdrawal or outgoing transfer break a limit? (other types always pass)
+    LimitViolation check(const string& accountNumber, TransactionType type, double amount,
+                         time_t now = time(nullptr));
+
+    // Commit hooks (only PENDING and COMPLETED rows count toward limits)
+    void add(const Transaction& transaction);
+    void changeStatus(const Transaction& transaction, TransactionStatus previousStatus);
+    void clear();
+
+    const LimitRules& getRules() const;
+    void setRules(const LimitRules& limitRules);
+};
+
+#endif // LIMITENGINE_H
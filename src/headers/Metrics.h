@@ -0,0 +1,159 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <string>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory_resource>
+
+using namespace std;
+
+// Log-linear latency histogram (HDR style): exact below 128 ns, then 64
+// sub-buckets per power of two, so any recorded value is within 1.6% of its
+// bucket. Covers up to 2^42 ns (~73 minutes); larger values land in the top
+// bucket. Written by one thread, read by any (relaxed atomics, no locks).
+class LatencyHistogram {
+public:
+    static const size_t BUCKET_COUNT = 128 + 35 * 64;
+
+private:
+    array<atomic<uint64_t>, BUCKET_COUNT> buckets;
+    atomic<uint64_t> count;
+    atomic<uint64_t> sum;
+    atomic<uint64_t> minimum;
+    atomic<uint64_t> maximum;
+
+public:
+    LatencyHistogram();
+
+    // Record one value (nanoseconds); only the owning thread may call this
+    void record(uint64_t nanoseconds);
+
+    // Add another histogram's contents into this one
+    void merge(const LatencyHistogram& other);
+
+    // Forget everything recorded
+    void clear();
+
+    // Queries
+    uint64_t getCount() const;
+    uint64_t getSum() const;
+    uint64_t getMin() const;
+    uint64_t getMax() const;
+    uint64_t getPercentile(double fraction) const;
+
+    // Bucket mapping
+    static size_t bucketFor(uint64_t value);
+    static uint64_t bucketUpperBound(size_t bucket);
+};
+
+// Merged view of one operation or counter, produced by Metrics::snapshot()
+struct OperationStats {
+    string name;
+    uint64_t count = 0;
+    uint64_t totalNanoseconds = 0;
+    uint64_t minNanoseconds = 0;
+    uint64_t maxNanoseconds = 0;
+    uint64_t p50 = 0, p90 = 0, p99 = 0, p999 = 0;
+};
+
+struct CounterStats {
+    string name;
+    uint64_t value = 0;
+};
+
+struct GaugeStats {
+    string name;
+    double value = 0.0;
+};
+
+// Process-wide latency histograms and counters. Every thread records into its
+// own histograms (created on first use), so recording is a couple of relaxed
+// stores with no shared cache lines; snapshot() merges all threads on demand.
+// Operations, counters and gauges are registered once by name and then
+// addressed by id. Gauges are process-wide values (sizes, depths, bytes) kept
+// in a single atomic each; their owners push updates, readers never block them.
+class Metrics {
+public:
+    static const size_t MAX_METRICS = 256;
+
+    // Registration (idempotent: the same name returns the same id)
+    static size_t registerOperation(const string& name);
+    static size_t registerCounter(const string& name);
+    static size_t registerGauge(const string& name);
+
+    // Recording
+    static void recordLatency(size_t operation, uint64_t nanoseconds);
+    static void incrementCounter(size_t counter, uint64_t delta = 1);
+    static void setGauge(size_t gauge, double value);
+    static void addGauge(size_t gauge, double delta);
+
+    // Global switch (recording is on by default)
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    // Merge all threads
+    static vector<OperationStats> snapshotOperations();
+    static vector<CounterStats> snapshotCounters();
+    static vector<GaugeStats> snapshotGauges();
+
+    // Output
+    static void displayStatistics();
+    static bool writeStatisticsFile(const string& filename);
+
+    // Drop everything recorded so far (registrations and gauges are kept)
+    static void reset();
+};
+
+// Times the enclosing scope into an operation histogram
+class ScopedLatency {
+private:
+    size_t operation;
+    bool active;
+    chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedLatency(size_t operationId)
+        : operation(operationId), active(Metrics::isEnabled()) {
+        if (active) {
+            start = chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedLatency() {
+        if (active) {
+            auto elapsed = chrono::steady_clock::now() - start;
+            Metrics::recordLatency(operation, static_cast<uint64_t>(
+                chrono::duration_cast<chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    ScopedLatency(const ScopedLatency& other) = delete;
+    ScopedLatency& operator=(const ScopedLatency& other) = delete;
+};
+
+// Memory resource that reports the bytes it hands out from upstream as a gauge
+// (wrap a pool's upstream to see how much memory the pool holds)
+class CountingMemoryResource : public pmr::memory_resource {
+private:
+    pmr::memory_resource* upstream;
+    size_t gauge;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const pmr::memory_resource& other) const noexcept override;
+
+public:
+    CountingMemoryResource(pmr::memory_resource* upstreamResource, const string& gaugeName);
+};
+
+// Time the rest of the enclosing function as operation "name" (registered on first call)
+#define METRICS_TIME_SCOPE(name) \
+    static const size_t metricsOperationId = Metrics::registerOperation(name); \
+    ScopedLatency metricsScopedLatency(metricsOperationId)
+
+#endif // METRICS_H
@@ -0,0 +1,49 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <string>
+#include <thread>
+#include <atomic>
+
+using namespace std;
+
+// Serves the Metrics registry in the Prometheus text exposition format
+// (GET /metrics) from a background thread on a loopback TCP port. Each scrape
+// reads the same merged snapshots as displayStatistics(), so it never takes a
+// lock that the recording threads use.
+//
+//   banking_operation_latency_seconds{operation="...",quantile="0.99"}  summary
+//   banking_<counter>_total                                              counter
+//   banking_<gauge>                                                      gauge
+class MetricsExporter {
+public:
+    static const int DEFAULT_PORT = 9464;
+
+private:
+    thread serverThread;
+    atomic<bool> stopping;
+    int listenSocket;
+    int port;
+
+    void serveLoop();
+    void handleConnection(int connection) const;
+
+public:
+    MetricsExporter();
+    ~MetricsExporter();
+
+    // Prevent copying (the server thread holds a pointer to this exporter)
+    MetricsExporter(const MetricsExporter& other) = delete;
+    MetricsExporter& operator=(const MetricsExporter& other) = delete;
+
+    // Listen on bindAddress:port (port 0 = pick a free port; see getPort())
+    bool start(int listenPort = DEFAULT_PORT, const string& bindAddress = "127.0.0.1");
+    void stop();
+    bool isRunning() const;
+    int getPort() const;
+
+    // Render the current metrics as Prometheus text
+    static string renderPrometheus();
+};
+
+#endif // METRICSEXPORTER_H
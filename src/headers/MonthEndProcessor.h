@@ -0,0 +1,73 @@
+#ifndef MONTHENDPROCESSOR_H
+#define MONTHENDPROCESSOR_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "Account.h"
+#include "Transaction.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+// Which month-end steps to run and how to report progress
+struct MonthEndOptions {
+    bool chargeFees = true;                 // Monthly maintenance fee on checking accounts
+    bool applyInterest = true;              // Monthly interest on savings accounts
+    bool resetCounters = true;              // Withdrawal / transaction counters
+    double monthlyFee = -1.0;               // < 0: MONTHLY_MAINTENANCE_FEE from bank_config.txt (Bank) or its default
+    size_t progressInterval = 10000;        // Accounts between progress reports (0 = off)
+    function<void(size_t processed, size_t total)> progressCallback;
+};
+
+// Outcome of one month-end run
+struct MonthEndSummary {
+    size_t accountsProcessed = 0;
+    size_t feesCharged = 0;
+    size_t feesSkipped = 0;                 // Insufficient available balance
+    size_t interestCredits = 0;
+    size_t countersReset = 0;
+    double totalFees = 0.0;
+    double totalInterest = 0.0;
+    size_t ledgerEntries = 0;
+    size_t threadsUsed = 0;
+    double elapsedSeconds = 0.0;
+    double accountsPerSecond = 0.0;
+};
+
+// Runs fees, interest and counter resets for every account, spreading partitions
+// over the TransactionManager's worker pool. Workers only compute each
+// partition's ledger entries; the entries are committed as one batch, and only
+// then are the recorded entries' balances applied and the counters reset, so no
+// balance changes without its ledger row.
+// The caller must hold exclusive access to the accounts for the duration of run().
+class MonthEndProcessor {
+private:
+    // Balance change waiting for its ledger entry to be recorded
+    struct PendingChange {
+        Account* account;
+        TransactionType transactionType;
+        double amount;
+        double balanceAfter;
+    };
+
+    TransactionManager& transactionManager;
+
+    // Compute one partition's fees and interest (runs on a worker thread; reads only)
+    void processPartition(const vector<Account*>& accounts, size_t begin, size_t end,
+                          const MonthEndOptions& options, MonthEndSummary& partial,
+                          vector<LedgerEntry>& entries, vector<PendingChange>& changes) const;
+
+public:
+    // Constructor
+    explicit MonthEndProcessor(TransactionManager& txnManager);
+
+    // Run all enabled month-end steps over the given accounts (an exception
+    // thrown while computing a partition is rethrown here, before anything changed)
+    MonthEndSummary run(const vector<Account*>& accounts, const MonthEndOptions& options = MonthEndOptions());
+
+    // Display functions
+    static void displaySummary(const MonthEndSummary& summary);
+};
+
+#endif // MONTHENDPROCESSOR_H
@@ -0,0 +1,117 @@
+#ifndef RECOVERYMANAGER_H
+#define RECOVERYMANAGER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include "Transaction.h"
+#include "LedgerSnapshot.h"
+
+using namespace std;
+
+// When to take checkpoints and how hard to push commits to disk
+struct RecoveryOptions {
+    size_t checkpointEveryTransactions = 100000;    // Commits between checkpoints
+    int checkpointIntervalSeconds = 300;            // ...or this much time, whichever comes first
+    bool syncEveryCommit = false;                   // fsync the WAL on every commit (slower, no loss window)
+};
+
+// Crash recovery through a write-ahead log plus periodic checkpoints.
+//
+// Every committed change is appended to the current WAL generation
+// (<ledger>.wal.NNNNNN) as a full Transaction record, so replay is an upsert.
+// Each WAL record carries its length and a CRC-32; replay stops at the first
+// record that fails either check (the torn tail of a crash).
+// A checkpoint rotates the WAL to a new generation and hands a snapshot of the
+// ledger to a background thread, which writes <ledger>.checkpoint (tagged with
+// the new generation) and only then deletes the older WAL files. Startup loads
+// the checkpoint and replays the WAL generations at or after its tag, so the
+// replay work is bounded by the checkpoint interval, not the ledger size.
+//
+// Without syncEveryCommit, callers that need durability register with
+// whenDurable(); a sync thread covers every waiter with one fsync (group
+// commit), so waiting costs no thread and concurrent commits share the flush.
+class RecoveryManager {
+private:
+    string ledgerPath;
+    RecoveryOptions options;
+
+    // Write-ahead log state (writer thread only)
+    FILE* walFile;
+    uint64_t walGeneration;
+    size_t commitsSinceCheckpoint;
+    chrono::steady_clock::time_point lastCheckpointTime;
+    size_t replayedRecords;
+    mutex walMutex;                                 // walFile swaps vs. the sync thread
+    atomic<uint64_t> appendedRecords;               // Records written to the WAL
+    atomic<uint64_t> durableRecords;                // ...of which known to be on disk
+    atomic<bool> syncFailed;                        // An fsync failed: nothing after it is durable
+
+    // Group commit state
+    thread syncThread;
+    mutex syncMutex;
+    condition_variable syncSignal;
+    vector<pair<uint64_t, function<void(bool)>>> durabilityWaiters;
+    bool syncStopping;
+
+    // Background checkpoint state
+    thread checkpointThread;
+    mutable mutex checkpointMutex;
+    condition_variable checkpointSignal;
+    shared_ptr<const LedgerSnapshot> pendingSnapshot;
+    uint64_t pendingGeneration;
+    bool checkpointInProgress;
+    bool stopping;
+
+    void checkpointLoop();
+    void syncLoop();
+    void reportSyncFailure(int error);
+    void abandonWalSegment(long recordStart);
+    bool writeCheckpoint(const LedgerSnapshot& snapshot, uint64_t generation) const;
+    bool openWal(uint64_t generation);
+    vector<uint64_t> findWalGenerations() const;
+    string getWalPath(uint64_t generation) const;
+    string getCheckpointPath() const;
+
+public:
+    // Constructor and Destructor (the destructor waits for an in-flight checkpoint)
+    RecoveryManager(string ledgerFile, RecoveryOptions recoveryOptions = RecoveryOptions());
+    ~RecoveryManager();
+
+    RecoveryManager(const RecoveryManager& other) = delete;
+    RecoveryManager& operator=(const RecoveryManager& other) = delete;
+
+    // Load the last checkpoint and replay the WAL tail; returns false when neither exists
+    bool recover(TransactionMap& transactions);
+
+    // Commit logging and checkpointing (called from the thread that mutates the ledger);
+    // logCommit returns false when the record is not in the WAL, and the commit must
+    // then not be applied
+    bool logCommit(const Transaction& transaction);
+    bool isCheckpointDue() const;
+    bool beginCheckpoint(shared_ptr<const LedgerSnapshot> snapshot);
+    void waitForCheckpoint();
+
+    // Durability (any thread): isDurable() is true once every logged commit is on
+    // disk; whenDurable(done) runs done(true) on the sync thread once the commits
+    // logged so far are (immediately on the caller's thread if they already are).
+    // A failed fsync is permanent (the kernel may have dropped the dirty pages):
+    // from then on nothing is reported durable and waiters get done(false).
+    bool isDurable() const;
+    void whenDurable(function<void(bool)> done);
+
+    // Statistics
+    size_t getReplayedRecordCount() const;
+    uint64_t getWalGeneration() const;
+};
+
+#endif // RECOVERYMANAGER_H
@@ -0,0 +1,53 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+// Fixed-size pool of worker threads used by the batch jobs (month-end processing,
+// statistics, exports and reindexing) to spread per-account/per-transaction loops
+// across all available cores
+class ThreadPool {
+private:
+    vector<thread> workers;
+    queue<function<void()>> tasks;
+    mutex queueMutex;
+    condition_variable taskAvailable;
+    condition_variable tasksFinished;
+    size_t activeTasks;
+    bool stopping;
+
+    void workerLoop(size_t workerIndex);
+
+public:
+    // Constructor (0 = one worker per hardware thread)
+    ThreadPool(size_t threadCount = 0);
+
+    // Destructor (finishes queued tasks, then joins the workers)
+    ~ThreadPool();
+
+    // Prevent copying (workers hold a pointer to this pool)
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    // Task submission (an exception escaping a task is reported and dropped)
+    void submit(function<void()> task);
+    void waitForAll();
+
+    // Split [0, count) into one contiguous range per worker and run body(begin, end, partition)
+    // on each of them, returning once every range is done. If body throws, the first exception
+    // is rethrown here after the other ranges finish. Must not be called from a worker.
+    void parallelFor(size_t count, const function<void(size_t, size_t, size_t)>& body);
+
+    // Getters
+    size_t getThreadCount() const;
+    static size_t getDefaultThreadCount();
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,65 @@
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+using namespace std;
+
+// Optional span tracing in Chrome trace-event format (load the output in
+// chrome://tracing or ui.perfetto.dev). Tracing is off until start() is
+// called; while off, a TraceSpan costs one relaxed load. Spans are appended to
+// a per-thread buffer (bounded, see MAX_EVENTS_PER_THREAD) and only gathered
+// when the trace is written.
+class Tracing {
+public:
+    static const size_t MAX_EVENTS_PER_THREAD = 1000000;
+
+    // Begin a new trace (clears earlier events) / stop recording
+    static void start();
+    static void stop();
+    static bool isEnabled();
+
+    // Record a finished span; name and category must be string literals (they are not copied)
+    static void recordSpan(const char* name, const char* category,
+                           chrono::steady_clock::time_point begin, chrono::steady_clock::time_point end);
+
+    // Name the calling thread in the trace (e.g. "checkpoint", "worker 3")
+    static void setThreadName(const string& name);
+
+    // Write every recorded span as Chrome trace-event JSON
+    static bool writeChromeTrace(const string& filename);
+
+    // Number of spans dropped because a thread buffer was full
+    static size_t getDroppedSpanCount();
+};
+
+// Records the enclosing scope as a span when tracing is on
+class TraceSpan {
+private:
+    const char* name;
+    const char* category;
+    bool active;
+    chrono::steady_clock::time_point begin;
+
+public:
+    TraceSpan(const char* spanName, const char* spanCategory)
+        : name(spanName), category(spanCategory), active(Tracing::isEnabled()) {
+        if (active) {
+            begin = chrono::steady_clock::now();
+        }
+    }
+
+    ~TraceSpan() {
+        if (active) {
+            Tracing::recordSpan(name, category, begin, chrono::steady_clock::now());
+        }
+    }
+
+    TraceSpan(const TraceSpan& other) = delete;
+    TraceSpan& operator=(const TraceSpan& other) = delete;
+};
+
+#endif // TRACING_H
@@ -2,9 +2,16 @@
 #define TRANSACTION_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <iostream>
+#include "Metrics.h"
+#include "Async.h"
 
 using namespace std;
 
@@ -30,6 +37,22 @@ enum class TransactionStatus {
     REVERSED
 };
 
+// Secondary indexes kept by TransactionManager (ALL = every index)
+enum class TransactionIndex {
+    ACCOUNT,
+    CUSTOMER,
+    DATE,
+    ALL
+};
+
+// Number of values in each enumeration (used to size per-type/per-status tables)
+const size_t TRANSACTION_TYPE_COUNT = static_cast<size_t>(TransactionType::UNKNOWN) + 1;
+const size_t TRANSACTION_STATUS_COUNT = static_cast<size_t>(TransactionStatus::REVERSED) + 1;
+
+// Enum to string conversions
+string transactionTypeToString(TransactionType type);
+string transactionStatusToString(TransactionStatus status);
+
 class Transaction {
 private:
     string transactionId;
@@ -45,20 +68,25 @@ private:
     string customerId;
     string sessionId;               // For tracking user sessions
     string notes;                   // Additional transaction notes
+    string idempotencyKey;          // Client retry key (empty if none); see IdempotencyTable.h
 
 public:
     // Constructors
     Transaction();
     Transaction(string txnId, string accNum, TransactionType type, double amt, 
                string desc, double beforeBal, double afterBal, string custId);
+    Transaction(string txnId, string accNum, string relatedAccNum, TransactionType type, double amt,
+               string time, string desc, double beforeBal, double afterBal, TransactionStatus txnStatus,
+               string custId, string session, string txnNotes,
+               string key = "");                                     // Restore a persisted record as-is
     
-    // Getters
-    string getTransactionId() const;
-    string getAccountNumber() const;
+    // Getters (stored fields are returned by reference; fields with display defaults by value)
+    const string& getTransactionId() const;
+    const string& getAccountNumber() const;
     string getRelatedAccountNumber() const;
     TransactionType getTransactionType() const;
     double getAmount() const;
-    string getTimestamp() const;
+    const string& getTimestamp() const;
     string getDescription() const;
     double getBalanceBefore() const;
     double getBalanceAfter() const;
@@ -66,12 +94,14 @@ public:
     string getCustomerId() const;
     string getSessionId() const;
     string getNotes() const;
+    const string& getIdempotencyKey() const;
     
     // Setters
     void setStatus(TransactionStatus newStatus);
     void setRelatedAccountNumber(string relatedAccNum);
     void setSessionId(string sessionId);
     void setNotes(string notes);
+    void setIdempotencyKey(string key);
     void setBalanceAfter(double balance);
     
     // Utility functions
@@ -85,40 +115,211 @@ public:
     void displayTransaction() const;
     void displayTransactionSummary() const;
     
+    // Lossless single-line record (tab separated, escaped) used by backups and logs
+    string toRecord() const;
+    static bool fromRecord(const string& record, Transaction& transaction);
+    
     // Comparison operators (for sorting)
     bool operator<(const Transaction& other) const;
     bool operator==(const Transaction& other) const;
 };
 
+// Ledger entry produced by batch jobs; the transaction ID is assigned when the batch is committed
+struct LedgerEntry {
+    string accountNumber;
+    TransactionType transactionType;
+    double amount;
+    string description;
+    double balanceBefore;
+    double balanceAfter;
+    string customerId;
+};
+
+// Ledger-wide aggregates produced by TransactionManager::computeStatistics()
+struct TransactionStatistics {
+    size_t totalTransactions = 0;
+    double totalVolume = 0.0;                                   // Sum of net amounts
+    array<size_t, TRANSACTION_STATUS_COUNT> statusCounts{};
+    array<double, TRANSACTION_STATUS_COUNT> statusAmounts{};
+    array<size_t, TRANSACTION_TYPE_COUNT> typeCounts{};
+    array<double, TRANSACTION_TYPE_COUNT> typeAmounts{};
+
+    void add(const Transaction& transaction);
+    void merge(const TransactionStatistics& other);
+};
+
+// Orders ledger keys of any string type (std::string and pmr::string alike)
+struct LedgerKeyLess {
+    using is_transparent = void;
+    bool operator()(string_view a, string_view b) const noexcept { return a < b; }
+};
+
+// Ledger containers. Their nodes, and the characters of the pmr::string keys
+// and index values in them, are drawn from TransactionManager's pools (IDs
+// and most keys are longer than the 15 characters std::string keeps inline).
+// The Transaction values still keep their own fields on the heap.
+typedef pmr::map<pmr::string, Transaction, LedgerKeyLess> TransactionMap;          // TransactionId -> Transaction
+typedef pmr::multimap<pmr::string, pmr::string, LedgerKeyLess> TransactionIndexMap; // Key -> TransactionId
+
+// Insert or replace a transaction under its ID (the key is allocated from the map's pool)
+const Transaction& storeTransaction(TransactionMap& transactions, Transaction transaction);
+
+class ThreadPool;
+class TransactionArchive;
+class TransactionRollups;
+class CustomerSummaries;
+struct CustomerSummary;
+class IdempotencyTable;
+class LimitEngine;
+class RecoveryManager;
+class LedgerSnapshot;
+struct LedgerChunk;
+struct BackupJob;
+
 // Transaction Manager class for handling transaction processing and history
 class TransactionManager {
 private:
-    map<string, Transaction> transactionHistory;        // TransactionId -> Transaction
-    multimap<string, string> accountTransactions;       // AccountNumber -> TransactionId
-    multimap<string, string> customerTransactions;      // CustomerId -> TransactionId
-    multimap<string, string> dateTransactions;          // Date -> TransactionId
+    // Upstream wrappers reporting each pool's memory as a gauge (memory.<container>_bytes)
+    CountingMemoryResource historyMemory;
+    CountingMemoryResource accountIndexMemory;
+    CountingMemoryResource customerIndexMemory;
+    CountingMemoryResource dateIndexMemory;
+
+    // Node pools, one per container. The index pools are synchronized because a
+    // reindex builds parts of one index on several workers at once.
+    // Declared before the containers: they must outlive them.
+    pmr::unsynchronized_pool_resource historyPool;
+    pmr::synchronized_pool_resource accountIndexPool;
+    pmr::synchronized_pool_resource customerIndexPool;
+    pmr::synchronized_pool_resource dateIndexPool;
+    
+    TransactionMap transactionHistory;                  // TransactionId -> Transaction
+    TransactionIndexMap accountTransactions;            // AccountNumber -> TransactionId
+    TransactionIndexMap customerTransactions;           // CustomerId -> TransactionId
+    TransactionIndexMap dateTransactions;               // Date -> TransactionId
     int nextTransactionNumber;
     string logFilePath;
+    unique_ptr<ThreadPool> workerPool;                  // Parallel scans (created by the constructor)
+    unique_ptr<TransactionArchive> archive;             // Cold tier for archived transactions
+    unique_ptr<TransactionRollups> rollups;             // Daily/monthly totals, live and archived rows
+    unique_ptr<TransactionRollups> archivedRollups;     // Archived rows only (saved with the archive)
+    unique_ptr<CustomerSummaries> customerSummaries;    // Per-customer lifetime totals, live and archived
+    unique_ptr<CustomerSummaries> archivedCustomerSummaries;
+    unique_ptr<IdempotencyTable> idempotencyKeys;       // Request key -> transaction ID, within the TTL
+    unique_ptr<LimitEngine> limits;                     // Rolling-window withdrawal/transfer totals per account
+    
+    // Incremental backup state (IDs changed since the last backup set)
+    mutable vector<string> backupJournal;
+    mutable bool backupJournalOverflowed;               // Journal hit its cap: the next set must be FULL
+    mutable string lastBackupDirectory;                 // Empty until a full set has been taken
+    mutable unique_ptr<BackupJob> backupJob;            // Set being written in the background
+    
+    unique_ptr<RecoveryManager> recovery;               // Write-ahead log and checkpoints
+
+    // Multi-version read state: the layout of the last snapshot's chunks, which of
+    // them commits have touched since, and weak references to the chunks and the
+    // snapshot. Chunks live only while some snapshot pins them, so the manager
+    // keeps no copy of the ledger of its own; a chunk that was released or touched
+    // is copied again by the next getSnapshot(). getSnapshot() is const but
+    // refreshes these, so snapshotMutex guards them.
+    uint64_t ledgerVersion;                             // Commits applied so far
+    mutable mutex snapshotMutex;
+    mutable vector<weak_ptr<const LedgerChunk>> snapshotChunks;
+    mutable vector<string> snapshotChunkStarts;         // First transaction ID of each chunk
+    mutable vector<bool> dirtySnapshotChunks;
+    mutable bool snapshotLayoutValid;                   // False = rebuild every chunk
+    mutable weak_ptr<const LedgerSnapshot> currentSnapshot;
+
+    // Durably record a committed change (WAL, backup journal, rollups, checkpoint trigger);
+    // previousStatus is null for a new transaction. Returns false, recording nothing, when
+    // the WAL append fails; the caller then undoes the change
+    bool recordCommit(const Transaction& transaction, const TransactionStatus* previousStatus = nullptr);
+    // Register a fully committed operation's request key (a transfer's only after both legs);
+    // recordCommit forgets it when the row later fails, is cancelled or is reversed
+    void rememberIdempotencyKey(const string& transactionId);
+    bool refuseCommittedRequest(const string& idempotencyKey) const;  // true (and says so) if already committed
+
+    // Recompute the rollups and customer summaries from the archived totals plus
+    // the live ledger, and re-register the live rows' idempotency keys and limit usage
+    void rebuildRollups();
+
+    // Publish transactionHistory.size() as the ledger.transactions gauge
+    void publishLedgerSize() const;
+
+    // Drop the backup journal once it passes MAX_BACKUP_JOURNAL IDs (next set is FULL)
+    void capBackupJournal() const;
+
+    // Snapshot maintenance: a commit dirties the chunk holding its ID; bulk
+    // changes (load, restore, archive) drop the layout, so the next snapshot
+    // copies every chunk
+    void markSnapshotChunk(const string& transactionId);
+    void invalidateSnapshot();
+    
+    // Advance nextTransactionNumber past an existing transaction ID
+    void updateNextTransactionNumber(string_view transactionId);
+
+    // Split transactionHistory into contiguous key ranges (partitions + 1 bounds, O(partitions log n))
+    vector<TransactionMap::const_iterator> partitionHistory(size_t partitions) const;
+
+    // Rows for an export: one account via its index, otherwise the whole ledger (ID order)
+    vector<const Transaction*> selectExportRows(const string& accountNumber) const;
+    // Move into history and all indexes (single commit point, no console output); false
+    // when the ID exists or the WAL append fails
+    bool insertTransaction(Transaction&& incoming);
 
 public:
-    // Constructor
-    TransactionManager(string logFile = "data/transactions.log");
+    // Constructor (upstream supplies the node pools' memory and must be thread-safe)
+    TransactionManager(string logFile = "data/transactions.log", string archiveDirectory = "archive/",
+                       pmr::memory_resource* upstream = pmr::get_default_resource());
     
     // Destructor
     ~TransactionManager();
     
-    // Core transaction processing
+    // Core transaction processing. A non-empty idempotencyKey is stored with the
+    // row; a key already committed within the TTL is refused (empty ID), so
+    // callers look it up with findIdempotentCommit before changing balances.
     string processDeposit(string accountNumber, double amount, string description, 
-                         double balanceBefore, double balanceAfter, string customerId);
+                         double balanceBefore, double balanceAfter, string customerId,
+                         string idempotencyKey = "");
     string processWithdrawal(string accountNumber, double amount, string description,
-                            double balanceBefore, double balanceAfter, string customerId);
+                            double balanceBefore, double balanceAfter, string customerId,
+                            string idempotencyKey = "");
     string processTransfer(string fromAccount, string toAccount, double amount,
                           string description, double fromBalBefore, double fromBalAfter,
-                          double toBalBefore, double toBalAfter, string customerId);
+                          double toBalBefore, double toBalAfter, string customerId,
+                          string idempotencyKey = "");
     string processFeeCharge(string accountNumber, double amount, string description,
-                           double balanceBefore, double balanceAfter, string customerId);
+                           double balanceBefore, double balanceAfter, string customerId,
+                           string idempotencyKey = "");
     string processInterestCredit(string accountNumber, double amount, string description,
-                                double balanceBefore, double balanceAfter, string customerId);
+                                double balanceBefore, double balanceAfter, string customerId,
+                                string idempotencyKey = "");
+    vector<string> processBatch(vector<LedgerEntry> entries);   // One ID per entry, empty if not recorded
+
+    // Shared worker pool (parallel scans, month-end processing)
+    ThreadPool& getWorkerPool() const;
+
+    // Check a request key before changing balances: true (with the original
+    // transaction ID) if it has already been committed
+    bool findIdempotentCommit(const string& idempotencyKey, string& transactionId) const;
+
+    // Asynchronous variants: commit like the synchronous call (the caller still
+    // serializes access), then suspend until the WAL records are on disk; they
+    // throw runtime_error if the WAL cannot be synced
+    Task<string> processDepositAsync(string accountNumber, double amount, string description,
+                                     double balanceBefore, double balanceAfter, string customerId,
+                                     string idempotencyKey = "");
+    Task<string> processWithdrawalAsync(string accountNumber, double amount, string description,
+                                        double balanceBefore, double balanceAfter, string customerId,
+                                        string idempotencyKey = "");
+    Task<string> processTransferAsync(string fromAccount, string toAccount, double amount,
+                                      string description, double fromBalBefore, double fromBalAfter,
+                                      double toBalBefore, double toBalAfter, string customerId,
+                                      string idempotencyKey = "");
+
+    // Suspend until every commit made so far is durable (one shared fsync per
+    // group); false once a WAL fsync has failed
+    Task<bool> waitForDurableCommit();
     
     // Transaction management
     bool addTransaction(Transaction transaction);
@@ -147,13 +348,34 @@ public:
     void displayCustomerTransactionSummary(string customerId) const;
     void displayTransactionsByType(TransactionType type, int limit = 20) const;
     void displayDailyTransactionSummary(string date) const;
+    void displayMonthlyTransactionSummary(string month) const;             // Month = YYYY-MM
     void displayTransactionStatistics() const;
     
+    // Statistics (single parallel pass over the ledger)
+    TransactionStatistics computeStatistics() const;
+
+    // Pin the current ledger version for lock-free reading (see LedgerSnapshot.h).
+    // Readers may call it concurrently (the cached chunks are refreshed under
+    // snapshotMutex), but writers must be excluded like for any other member; the
+    // snapshot it returns can then be scanned on any thread while commits continue.
+    shared_ptr<const LedgerSnapshot> getSnapshot() const;
+    
     // Data persistence
     bool saveTransactionHistory() const;
     bool loadTransactionHistory();
     bool exportTransactionsToCSV(string filename, string accountNumber = "") const;
+    bool exportTransactionsToColumnar(string filename, string accountNumber = "",
+                                      size_t rowGroupSize = 1048576) const;
     bool createBackup(string backupPath = "backup/") const;
+    // Background backup: pins the current version (copy-on-write, see getSnapshot)
+    // and writes it on its own thread at no more than maxBytesPerSecond (0 = unpaced).
+    // waitForBackup() returns whether the last one succeeded (true if none is pending).
+    bool startBackup(string backupPath = "backup/", size_t maxBytesPerSecond = 32 << 20) const;
+    bool isBackupInProgress() const;
+    bool waitForBackup() const;
+    bool restoreFromBackup(string backupPath = "backup/", int upToSequence = -1);
+    bool checkpoint();
+    map<string, double> getLastKnownBalances() const;
     
     // Utility functions
     string generateTransactionId();
@@ -163,7 +385,12 @@ public:
     
     // System maintenance
     void cleanupOldTransactions(int daysOld = 365);
-    void reindexTransactions();
+    int archiveTransactionsBefore(string cutoffDate);
+    const TransactionArchive& getArchive() const;
+    const TransactionRollups& getRollups() const;
+    const CustomerSummary* getCustomerSummary(const string& customerId) const;   // Null if none
+    LimitEngine& getLimitEngine();              // Check withdrawals/transfers before changing balances
+    void reindexTransactions(TransactionIndex index = TransactionIndex::ALL);
     int getTotalTransactionCount() const;
     double getTotalSystemVolume() const;
 };
@@ -0,0 +1,69 @@
+#ifndef TRANSACTIONARCHIVE_H
+#define TRANSACTIONARCHIVE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+#include <cstdint>
+#include "Transaction.h"
+
+using namespace std;
+
+// Sparse index for one archived segment: enough to decide which row groups a
+// query has to open without reading the segment itself
+struct ArchiveSegmentInfo {
+    string path;                                // Columnar segment file
+    string month;                               // YYYY-MM
+    string minTimestamp;
+    string maxTimestamp;
+    uint64_t rowCount = 0;
+    vector<string> rowGroupMinTimestamps;
+    vector<string> rowGroupMaxTimestamps;
+    vector<vector<string>> rowGroupAccounts;    // Sorted distinct account numbers per row group
+    vector<vector<string>> rowGroupCustomers;   // Sorted distinct customer IDs per row group
+};
+
+// Cold tier for old transactions. Rows are written once into immutable,
+// per-month columnar segments (see LedgerColumnar.h) with a sidecar sparse
+// index. Only the catalog and sparse indexes stay in memory; row groups are
+// decoded on demand and kept in a small LRU cache.
+class TransactionArchive {
+private:
+    string archiveDirectory;
+    vector<ArchiveSegmentInfo> segments;
+    uint64_t nextSegmentNumber;                 // Persisted in the catalog; never reused
+    size_t maxCachedRowGroups;
+
+    // Decoded row group cache (segment, row group) -> rows, most recent first
+    mutable list<pair<pair<size_t, size_t>, vector<Transaction>>> rowGroupCache;
+
+    const vector<Transaction>& loadRowGroup(size_t segment, size_t rowGroup) const;
+    bool writeSegmentIndex(const ArchiveSegmentInfo& info) const;
+    bool readSegmentIndex(ArchiveSegmentInfo& info) const;
+    bool writeCatalog() const;
+    string getCatalogPath() const;
+
+public:
+    // Constructor
+    TransactionArchive(string directory = "archive/", size_t cachedRowGroups = 8);
+
+    // Catalog management
+    bool loadCatalog();
+    size_t getSegmentCount() const;
+    string getArchiveDirectory() const;
+    uint64_t getArchivedTransactionCount() const;
+
+    // Move rows into new immutable segments (one per month); returns false if nothing was written
+    bool archiveTransactions(const vector<const Transaction*>& rows, size_t rowGroupSize = 65536);
+
+    // Queries (newest first, matching the live TransactionManager queries)
+    vector<Transaction> findByAccount(const string& accountNumber, size_t limit) const;
+    vector<Transaction> findByCustomer(const string& customerId, size_t limit) const;
+    vector<Transaction> findByDateRange(const string& startDate, const string& endDate) const;
+
+    // Display functions
+    void displayArchiveSummary() const;
+};
+
+#endif // TRANSACTIONARCHIVE_H
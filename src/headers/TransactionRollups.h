@@ -0,0 +1,62 @@
+#ifndef TRANSACTIONROLLUPS_H
+#define TRANSACTIONROLLUPS_H
+
+#include <string>
+#include <map>
+#include <array>
+#include <cstdint>
+#include "Transaction.h"
+
+using namespace std;
+
+// Count and sums for one (period, type, status) cell
+struct RollupTotals {
+    int64_t count = 0;
+    double amount = 0.0;
+    double netAmount = 0.0;                     // Signed: credits positive, debits negative
+
+    void merge(const RollupTotals& other);
+};
+
+// Totals for one period, indexed [type][status]
+struct RollupTable {
+    array<array<RollupTotals, TRANSACTION_STATUS_COUNT>, TRANSACTION_TYPE_COUNT> cells{};
+
+    void merge(const RollupTable& other);
+    RollupTotals getType(TransactionType type) const;             // All statuses
+    RollupTotals getStatus(TransactionStatus status) const;       // All types
+    RollupTotals getTotal() const;
+};
+
+// Materialized daily and monthly totals keyed by (day or month, type, status).
+// TransactionManager updates them on every commit, moving a row between
+// status cells when its status changes (including reversals), so daily,
+// monthly and multi-year summaries are map lookups instead of ledger scans.
+// Archived rows stay counted: archiving only moves them to another tier.
+class TransactionRollups {
+private:
+    map<string, RollupTable> daily;             // YYYY-MM-DD -> totals
+    map<string, RollupTable> monthly;           // YYYY-MM -> totals
+
+    void apply(const Transaction& transaction, TransactionStatus status, int direction);
+
+public:
+    // Maintenance
+    void add(const Transaction& transaction);
+    void changeStatus(const Transaction& transaction, TransactionStatus previousStatus);
+    void merge(const TransactionRollups& other);
+    void clear();
+
+    // Lookups (empty tables for periods without transactions)
+    RollupTable getDay(const string& date) const;
+    RollupTable getMonth(const string& month) const;
+    // Inclusive date range; whole months come from the monthly table
+    RollupTable getRange(const string& startDate, const string& endDate) const;
+    size_t getDayCount() const;
+
+    // Persistence (one "<day> <type> <status> <count> <amount> <net>" line per non-empty cell)
+    bool save(const string& path) const;
+    bool load(const string& path);
+};
+
+#endif // TRANSACTIONROLLUPS_H
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <climits>
+#include <ctime>
 
 using namespace std;
 
@@ -20,6 +21,15 @@ string getCurrentTime();
 // Get current date and time in YYYY-MM-DD HH:MM:SS format
 string getCurrentDateTime();
 
+// Get current date and time in YYYYMMDD_HHMMSS format (safe for file names)
+string getFileTimestamp();
+
+// Get the date N days before today in YYYY-MM-DD format
+string getDateDaysAgo(int days);
+
+// Convert a local YYYY-MM-DD HH:MM:SS timestamp to time_t (-1 if malformed)
+time_t parseDateTime(const string& dateTime);
+
 // Validate if a date string is in correct format
 bool isValidDate(string date);
 
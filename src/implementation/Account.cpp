@@ -75,11 +75,18 @@ void Account::updateBalance(double newBalance) {
 // =============================================================================
 
 // Constructor for SavingsAccount
-SavingsAccount::SavingsAccount(string accNum, string custId, double initialBalance, double intRate)
+SavingsAccount::SavingsAccount(string accNum, string custId, double initialBalance, double intRate,
+                               int monthlyWithdrawals)
     : Account(accNum, custId, initialBalance, AccountType::SAVINGS) {
     interestRate=intRate;
     minimumBalance=500;
     withdrawalCount=0;
+    maxWithdrawals=monthlyWithdrawals;
+    if(maxWithdrawals<0)
+    {
+        cout<<"Invalid withdrawal limit(<0), default set to "<<DEFAULT_MAX_WITHDRAWALS<<endl;
+        maxWithdrawals=DEFAULT_MAX_WITHDRAWALS;
+    }
 }
 
 // Deposit money to savings account
@@ -166,7 +173,53 @@ double SavingsAccount::getInterestRate() const {
 
 // Get remaining withdrawals for current month
 int SavingsAccount::getRemainingWithdrawals() const {
-    return MAX_WITHDRAWALS-withdrawalCount;
+    int remaining=maxWithdrawals-withdrawalCount;
+    return remaining>0 ? remaining : 0; // Limit may have been lowered mid-month
+}
+
+// Get the monthly withdrawal limit
+int SavingsAccount::getMaxWithdrawals() const {
+    return maxWithdrawals;
+}
+
+// Set the monthly withdrawal limit (takes effect for the current month)
+void SavingsAccount::setMaxWithdrawals(int limit) {
+    if(limit<0)
+    {
+        cout<<"Invalid withdrawal limit(<0), not changed"<<endl;
+        return;
+    }
+    maxWithdrawals=limit;
+}
+
+// Get minimum balance
+double SavingsAccount::getMinimumBalance() const {
+    return minimumBalance;
+}
+
+// Set minimum balance (MIN_SAVINGS_BALANCE; applies to later withdrawals)
+void SavingsAccount::setMinimumBalance(double minimum) {
+    if(minimum<0)
+    {
+        cout<<"Invalid minimum balance(<0), not changed"<<endl;
+        return;
+    }
+    minimumBalance=minimum;
+}
+
+// Get the number of withdrawals made this month
+int SavingsAccount::getWithdrawalCount() const {
+    return withdrawalCount;
+}
+
+// Set the number of withdrawals made this month
+void SavingsAccount::setWithdrawalCount(int count) {
+    if(count<0)
+    {
+        cout<<"Invalid withdrawal count(<0), not changed"<<endl;
+        return;
+    }
+    withdrawalCount=count;
 }
 
 // Reset withdrawal count (called monthly)
@@ -265,6 +318,34 @@ double CheckingAccount::getOverdraftLimit() const {
     return overdraftLimit;
 }
 
+// Get per-transaction fee
+double CheckingAccount::getTransactionFee() const {
+    return transactionFee;
+}
+
+// Set per-transaction fee charged after the free transactions
+void CheckingAccount::setTransactionFee(double fee) {
+    if (fee < 0) {
+        cout << "Invalid transaction fee (< 0), not set." << endl;
+        return;
+    }
+    transactionFee = fee;
+}
+
+// Get free transactions per month
+int CheckingAccount::getFreeTransactions() const {
+    return freeTransactions;
+}
+
+// Set free transactions per month
+void CheckingAccount::setFreeTransactions(int count) {
+    if (count < 0) {
+        cout << "Invalid free transaction count (< 0), not set." << endl;
+        return;
+    }
+    freeTransactions = count;
+}
+
 // Charge transaction fee
 void CheckingAccount::chargeFee() {
     if (transactionCount > freeTransactions) {
@@ -279,9 +360,21 @@ void CheckingAccount::chargeFee() {
     }
 }
 
+// Get the number of transactions made this month
+int CheckingAccount::getTransactionCount() const {
+    return transactionCount;
+}
+
+// Set the number of transactions made this month
+void CheckingAccount::setTransactionCount(int count) {
+    if (count < 0) {
+        cout << "Invalid transaction count (< 0), not set." << endl;
+        return;
+    }
+    transactionCount = count;
+}
+
 // Reset transaction count (called monthly)
 void CheckingAccount::resetTransactionCount() {
     transactionCount = 0;
-    cout << "Transaction count reset to 0." << endl;
-
 }
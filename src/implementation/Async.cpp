@@ -0,0 +1,106 @@
+#include "Async.h"
+#include <iostream>
+
+using namespace std;
+
+// =============================================================================
+// EXECUTOR
+// =============================================================================
+
+// Executor that suspended coroutines are resumed on
+ThreadPool& getAsyncExecutor() {
+    static ThreadPool executor;
+    return executor;
+}
+
+// =============================================================================
+// RUNNING TASKS
+// =============================================================================
+
+// Report an exception that escaped a detached coroutine
+void DetachedTask::promise_type::unhandled_exception() noexcept {
+    try {
+        throw;
+    } catch (const exception& error) {
+        cout << "Unhandled exception in asynchronous task: " << error.what() << endl;
+    } catch (...) {
+        cout << "Unhandled exception in asynchronous task." << endl;
+    }
+}
+
+// Start task without waiting for it
+void spawn(Task<void> task) {
+    [](Task<void> detached) -> DetachedTask {
+        co_await detached;
+    }(move(task));
+}
+
+// =============================================================================
+// ASYNC MUTEX
+// =============================================================================
+
+// Take the lock if it is free
+bool AsyncMutex::tryAcquire() {
+    lock_guard<mutex> lock(stateMutex);
+    if (locked) {
+        return false;
+    }
+    locked = true;
+    return true;
+}
+
+// Queue a waiter; false if the lock was released meanwhile and is now the caller's
+bool AsyncMutex::enqueue(coroutine_handle<> handle) {
+    lock_guard<mutex> lock(stateMutex);
+    if (!locked) {
+        locked = true;
+        return false;
+    }
+    waiters.push_back(handle);
+    return true;
+}
+
+// Wait for the lock as a coroutine so blocked threads keep their place in the queue
+static Task<AsyncLockGuard> acquireLock(AsyncMutex& target) {
+    co_return co_await target.lock();
+}
+
+// Block until the lock is acquired
+AsyncLockGuard AsyncMutex::lockBlocking() {
+    AsyncLockGuard guard = tryLock();
+    if (guard.ownsLock()) {
+        return guard;
+    }
+    return syncWait(acquireLock(*this));
+}
+
+// Hand the lock to the next waiter, or free it
+void AsyncMutex::release() {
+    coroutine_handle<> next;
+    {
+        lock_guard<mutex> lock(stateMutex);
+        if (waiters.empty()) {
+            locked = false;
+            return;
+        }
+        next = waiters.front();
+        waiters.pop_front();
+    }
+    getAsyncExecutor().submit([next] { next.resume(); });
+}
+
+// Release the mutex this guard owns
+void AsyncLockGuard::unlock() {
+    if (owner != nullptr) {
+        owner->release();
+        owner = nullptr;
+    }
+}
+
+AsyncLockGuard& AsyncLockGuard::operator=(AsyncLockGuard&& other) noexcept {
+    if (this != &other) {
+        unlock();
+        owner = exchange(other.owner, nullptr);
+    }
+    return *this;
+}
@@ -0,0 +1,213 @@
+#include "BackupManager.h"
+#include "Utilities.h"
+#include "Metrics.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+
+using namespace std;
+
+// =============================================================================
+// CONSTRUCTOR AND MANIFEST
+// =============================================================================
+
+// Constructor
+BackupManager::BackupManager(string directory) {
+    backupDirectory = directory.empty() ? "backup/" : directory;
+    if (backupDirectory.back() != '/') {
+        backupDirectory += '/';
+    }
+    loadManifest();
+}
+
+// Get manifest file path
+string BackupManager::getManifestPath() const {
+    return backupDirectory + "manifest.txt";
+}
+
+// Load the manifest ("<sequence> <FULL|INCR> <file> <records> <created>" per line)
+bool BackupManager::loadManifest() {
+    manifest.clear();
+    ifstream file(getManifestPath());
+    if (!file.is_open()) {
+        return false; // No backups yet
+    }
+    string line;
+    while (getline(file, line)) {
+        istringstream iss(line);
+        BackupEntry entry;
+        string type;
+        if (iss >> entry.sequence >> type >> entry.fileName >> entry.recordCount >> entry.createdAt) {
+            entry.full = (type == "FULL");
+            manifest.push_back(entry);
+        }
+    }
+    return true;
+}
+
+// Append one entry to the manifest
+bool BackupManager::appendManifest(const BackupEntry& entry) const {
+    ofstream file(getManifestPath(), ios::app);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << entry.sequence << " " << (entry.full ? "FULL" : "INCR") << " " << entry.fileName << " "
+         << entry.recordCount << " " << entry.createdAt << "\n";
+    file.close();
+    return !file.fail();
+}
+
+// Get manifest entries (oldest first)
+const vector<BackupEntry>& BackupManager::getManifest() const {
+    return manifest;
+}
+
+// Count incremental sets since the last full one (-1 if there is no full set)
+int BackupManager::getIncrementalsSinceFull() const {
+    int count = 0;
+    for (auto it = manifest.rbegin(); it != manifest.rend(); ++it) {
+        if (it->full) {
+            return count;
+        }
+        count++;
+    }
+    return -1;
+}
+
+// Get backup directory
+string BackupManager::getBackupDirectory() const {
+    return backupDirectory;
+}
+
+// =============================================================================
+// BACKUP AND RESTORE
+// =============================================================================
+
+// Write a new backup set
+bool BackupManager::writeBackup(const vector<const Transaction*>& records, bool full, BackupEntry& entry,
+                                size_t maxBytesPerSecond) {
+    error_code error;
+    filesystem::create_directories(backupDirectory, error);
+
+    entry.sequence = manifest.empty() ? 1 : manifest.back().sequence + 1;
+    entry.full = full;
+    entry.recordCount = records.size();
+    entry.createdAt = getFileTimestamp();
+    stringstream name;
+    name << "txn_backup_" << setfill('0') << setw(6) << entry.sequence << "_"
+         << (full ? "FULL" : "INCR") << "_" << entry.createdAt << ".log";
+    entry.fileName = name.str();
+
+    // Write to a temporary file first so a crash never leaves a half-written set in the manifest
+    string path = backupDirectory + entry.fileName;
+    string tempPath = path + ".tmp";
+    ofstream file(tempPath, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        cout << "Failed to create backup file: " << tempPath << endl;
+        return false;
+    }
+    // Throttled writes go out in smaller pieces so the pacing stays smooth
+    static const size_t bytesCounter = Metrics::registerCounter("backup.bytes_written");
+    const size_t flushBytes = maxBytesPerSecond > 0 ? (1 << 18) : (1 << 20);
+    const auto started = chrono::steady_clock::now();
+    size_t written = 0;
+    string buffer;
+    buffer.reserve(flushBytes);
+    auto flush = [&]() {
+        file.write(buffer.data(), buffer.size());
+        written += buffer.size();
+        Metrics::incrementCounter(bytesCounter, buffer.size());
+        buffer.clear();
+        if (maxBytesPerSecond > 0) {
+            this_thread::sleep_until(started + chrono::duration_cast<chrono::steady_clock::duration>(
+                chrono::duration<double>(static_cast<double>(written) / maxBytesPerSecond)));
+        }
+    };
+    buffer += to_string(records.size()) + "\n";
+    for (const Transaction* txn : records) {
+        buffer += txn->toRecord();
+        buffer += '\n';
+        if (buffer.size() >= flushBytes) {
+            flush();
+        }
+    }
+    flush();
+    file.close();
+    if (file.fail()) {
+        cout << "Failed to write backup file: " << tempPath << endl;
+        filesystem::remove(tempPath, error);
+        return false;
+    }
+    filesystem::rename(tempPath, path, error);
+    if (error || !appendManifest(entry)) {
+        cout << "Failed to register backup in manifest: " << path << endl;
+        return false;
+    }
+    manifest.push_back(entry);
+    return true;
+}
+
+// Rebuild the ledger as of a backup set
+bool BackupManager::restore(TransactionMap& transactions, int upToSequence) const {
+    // Find the newest full set at or before the target, then apply everything after it
+    int target = upToSequence < 0 && !manifest.empty() ? manifest.back().sequence : upToSequence;
+    int base = -1;
+    for (size_t i = 0; i < manifest.size() && manifest[i].sequence <= target; i++) {
+        if (manifest[i].full) {
+            base = static_cast<int>(i);
+        }
+    }
+    if (base < 0) {
+        cout << "No full backup found at or before sequence " << target << "." << endl;
+        return false;
+    }
+
+    transactions.clear();
+    for (size_t i = base; i < manifest.size() && manifest[i].sequence <= target; i++) {
+        const BackupEntry& entry = manifest[i];
+        ifstream file(backupDirectory + entry.fileName, ios::binary);
+        if (!file.is_open()) {
+            cout << "Backup set missing: " << entry.fileName << endl;
+            return false;
+        }
+        size_t expected = 0;
+        string line;
+        getline(file, line);
+        expected = strtoull(line.c_str(), nullptr, 10);
+        size_t applied = 0;
+        while (getline(file, line)) {
+            Transaction txn;
+            if (!Transaction::fromRecord(line, txn)) {
+                cout << "Corrupt record in backup set " << entry.fileName << endl;
+                return false;
+            }
+            storeTransaction(transactions, move(txn)); // Later sets override earlier ones
+            applied++;
+        }
+        if (applied != expected) {
+            cout << "Backup set " << entry.fileName << " is truncated (" << applied << "/" << expected << ")." << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// =============================================================================
+// DISPLAY FUNCTIONS
+// =============================================================================
+
+// Display the backup chain
+void BackupManager::displayManifest() const {
+    cout << "Backup Directory: " << backupDirectory << endl;
+    cout << left << setw(10) << "Sequence" << setw(8) << "Type" << setw(12) << "Records"
+         << setw(18) << "Created" << "File" << endl;
+    cout << string(80, '-') << endl;
+    for (const BackupEntry& entry : manifest) {
+        cout << left << setw(10) << entry.sequence << setw(8) << (entry.full ? "FULL" : "INCR")
+             << setw(12) << entry.recordCount << setw(18) << entry.createdAt << entry.fileName << endl;
+    }
+}
@@ -0,0 +1,952 @@
+#include "Bank.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
+#include <cmath>
+
+using namespace std;
+
+// Customers, accounts, reports and persistence of the Bank. Money-moving
+// operations live in BankTransactions.cpp, the asynchronous API in
+// BankAsync.cpp, configuration in BankConfiguration.cpp and monitoring in
+// BankMonitoring.cpp.
+//
+// Customers own their accounts (Customer's destructor deletes them); the
+// Bank's accounts map indexes the same objects by account number.
+//
+// Data files (one record per line, fields separated by '|', with '|', '\' and
+// line breaks escaped by a backslash):
+//   data/customers.dat      id|name|address|phone|email|pin hash|registered|active
+//   data/accounts.dat       number|customer id|SAVINGS or CHECKING|balance|active|overdraft limit
+//   data/system_config.dat  KEY=VALUE counters and totals
+
+static const string CUSTOMERS_FILE = "data/customers.dat";
+static const string ACCOUNTS_FILE = "data/accounts.dat";
+static const string SYSTEM_FILE = "data/system_config.dat";
+static const string BACKUP_DIRECTORY = "backup/";
+
+// =============================================================================
+// HELPERS
+// =============================================================================
+
+// Escape one field and append it with its separator
+static void appendField(string& out, const string& field) {
+    if (!out.empty()) {
+        out += '|';
+    }
+    for (char c : field) {
+        switch (c) {
+            case '|': out += "\\|"; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            default: out += c;
+        }
+    }
+}
+
+// Split a record written with appendField
+static vector<string> splitFields(const string& line) {
+    vector<string> fields(1);
+    for (size_t i = 0; i < line.size(); i++) {
+        char c = line[i];
+        if (c == '|') {
+            fields.emplace_back();
+        } else if (c == '\\' && i + 1 < line.size()) {
+            char next = line[++i];
+            fields.back() += next == 'n' ? '\n' : next == 'r' ? '\r' : next;
+        } else {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+// Format a number so it parses back to the same double
+static string formatNumber(double value) {
+    stringstream ss;
+    ss << setprecision(17) << value;
+    return ss.str();
+}
+
+// Number in an ID after its letter prefix (0 if none)
+static int idNumber(const string& id) {
+    size_t digits = id.find_first_of("0123456789");
+    return digits == string::npos ? 0 : atoi(id.c_str() + digits);
+}
+
+// Write lines to path through a temp file (the old file stays on failure)
+static bool writeLines(const string& path, const vector<string>& lines) {
+    error_code error;
+    filesystem::path target(path);
+    if (target.has_parent_path()) {
+        filesystem::create_directories(target.parent_path(), error);
+    }
+    string tempPath = path + ".tmp";
+    ofstream file(tempPath, ios::trunc);
+    if (!file.is_open()) {
+        cout << "Failed to open " << tempPath << " for writing." << endl;
+        return false;
+    }
+    for (const string& line : lines) {
+        file << line << '\n';
+    }
+    file.close();
+    if (file.fail()) {
+        filesystem::remove(tempPath, error);
+        cout << "Failed to write " << path << endl;
+        return false;
+    }
+    filesystem::rename(tempPath, path, error);
+    if (error) {
+        cout << "Failed to replace " << path << ": " << error.message() << endl;
+        return false;
+    }
+    return true;
+}
+
+// Human-readable account type
+static string accountTypeName(AccountType type) {
+    return type == AccountType::SAVINGS ? "SAVINGS" : "CHECKING";
+}
+
+// =============================================================================
+// CONSTRUCTOR AND DESTRUCTOR
+// =============================================================================
+
+// Constructor (the ledger is recovered by the TransactionManager; customers and
+// accounts are read by loadAllData)
+Bank::Bank(string name, string code) {
+    bankName = name;
+    bankCode = code;
+    transactionManager.reset(new TransactionManager());
+    nextCustomerNumber = 1;
+    nextSavingsAccountNumber = 1;
+    nextCheckingAccountNumber = 1;
+    BankConfig defaults;
+    minSavingsBalance = defaults.minSavingsBalance;
+    minCheckingBalance = defaults.minCheckingBalance;
+    defaultOverdraftLimit = defaults.overdraftLimit;
+    savingsInterestRate = defaults.savingsInterestRate;
+    totalDeposits = 0.0;
+    totalWithdrawals = 0.0;
+    totalCustomersCreated = 0;
+    totalAccountsCreated = 0;
+}
+
+// Destructor (customers delete their accounts)
+Bank::~Bank() {
+    stopMetricsExporter();
+    accounts.clear();
+    accountCustomerMap.clear();
+    customers.clear();
+}
+
+// =============================================================================
+// CUSTOMER MANAGEMENT
+// =============================================================================
+
+// Register a new customer; returns the customer ID (empty on invalid details)
+string Bank::createCustomer(string name, string address, string phone, string email, string pin) {
+    string customerId = generateCustomerId();
+    try {
+        customers[customerId] = make_unique<Customer>(customerId, move(name), move(address), move(phone),
+                                                      move(email), move(pin));
+    } catch (const invalid_argument& error) {
+        nextCustomerNumber--; // The ID was never used
+        cout << "Customer not created: " << error.what() << endl;
+        return "";
+    }
+    totalCustomersCreated++;
+    return customerId;
+}
+
+// Delete a customer and their accounts (only when every account is empty)
+bool Bank::deleteCustomer(string customerId) {
+    Customer* customer = findCustomer(customerId);
+    if (customer == nullptr) {
+        cout << "Customer " << customerId << " not found." << endl;
+        return false;
+    }
+    for (Account* account : customer->getAllAccounts()) {
+        if (fabs(account->getBalance()) > 0.005) {
+            cout << "Customer " << customerId << " still has a balance in account "
+                 << account->getAccountNumber() << "." << endl;
+            return false;
+        }
+    }
+    for (Account* account : customer->getAllAccounts()) {
+        accounts.erase(account->getAccountNumber());
+        accountCustomerMap.erase(account->getAccountNumber());
+    }
+    customers.erase(customerId);
+    publishAccountGauges();
+    return true;
+}
+
+// Find a customer by ID (null if unknown)
+Customer* Bank::findCustomer(string customerId) const {
+    auto it = customers.find(customerId);
+    return it != customers.end() ? it->second.get() : nullptr;
+}
+
+// Check a customer's PIN
+bool Bank::authenticateCustomer(string customerId, string pin) const {
+    Customer* customer = findCustomer(customerId);
+    if (customer == nullptr || !customer->isCustomerActive()) {
+        cout << "Customer " << customerId << " not found or inactive." << endl;
+        return false;
+    }
+    return customer->verifyPin(pin);
+}
+
+// Get every customer in ID order
+vector<Customer*> Bank::getAllCustomers() const {
+    vector<Customer*> result;
+    result.reserve(customers.size());
+    for (const auto& pair : customers) {
+        result.push_back(pair.second.get());
+    }
+    return result;
+}
+
+// Change a customer's contact details
+bool Bank::updateCustomerInfo(string customerId, string newAddress, string newPhone, string newEmail) {
+    Customer* customer = findCustomer(customerId);
+    if (customer == nullptr) {
+        cout << "Customer " << customerId << " not found." << endl;
+        return false;
+    }
+    if ((!newEmail.empty() && !isValidEmail(newEmail)) || (!newPhone.empty() && !isValidPhone(newPhone))) {
+        cout << "Invalid email or phone number." << endl;
+        return false;
+    }
+    customer->updateContactInfo(move(newAddress), move(newPhone), move(newEmail));
+    return true;
+}
+
+// =============================================================================
+// ACCOUNT MANAGEMENT
+// =============================================================================
+
+// Attach a new account to its customer and record the opening deposit; the
+// account is dropped again if the ledger refuses the deposit
+static bool openAccount(Customer* customer, Account* account, double initialDeposit,
+                        TransactionManager& manager) {
+    customer->addAccount(account);
+    if (initialDeposit > 0.0) {
+        string transactionId = manager.processDeposit(account->getAccountNumber(), initialDeposit,
+                                                      "Opening deposit", 0.0, initialDeposit,
+                                                      customer->getCustomerId());
+        if (transactionId.empty()) {
+            customer->removeAccount(account->getAccountNumber()); // Deletes it
+            cout << "Opening deposit was not recorded; account not opened." << endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Open a savings account with an opening deposit of at least the minimum balance
+string Bank::createSavingsAccount(string customerId, double initialDeposit) {
+    syncConfiguration();
+    Customer* customer = findCustomer(customerId);
+    if (customer == nullptr || !customer->isCustomerActive()) {
+        cout << "Customer " << customerId << " not found or inactive." << endl;
+        return "";
+    }
+    if (!isValidAmount(initialDeposit) || initialDeposit < minSavingsBalance) {
+        cout << "A savings account needs an opening deposit of at least " << fixed << setprecision(2)
+             << minSavingsBalance << "." << endl;
+        return "";
+    }
+    string accountNumber = generateSavingsAccountNumber();
+    Account* account = new SavingsAccount(accountNumber, customerId, initialDeposit, savingsInterestRate);
+    configureAccount(account);
+    if (!openAccount(customer, account, initialDeposit, *transactionManager)) {
+        return "";
+    }
+    accounts[accountNumber] = account;
+    accountCustomerMap[accountNumber] = customerId;
+    totalAccountsCreated++;
+    totalDeposits += initialDeposit;
+    publishAccountGauges();
+    return accountNumber;
+}
+
+// Open a checking account with an opening deposit of at least the minimum balance
+string Bank::createCheckingAccount(string customerId, double initialDeposit, double overdraftLimit) {
+    syncConfiguration();
+    Customer* customer = findCustomer(customerId);
+    if (customer == nullptr || !customer->isCustomerActive()) {
+        cout << "Customer " << customerId << " not found or inactive." << endl;
+        return "";
+    }
+    if (!isValidAmount(initialDeposit) || initialDeposit < minCheckingBalance) {
+        cout << "A checking account needs an opening deposit of at least " << fixed << setprecision(2)
+             << minCheckingBalance << "." << endl;
+        return "";
+    }
+    if (overdraftLimit < 0) {
+        overdraftLimit = defaultOverdraftLimit;
+    }
+    string accountNumber = generateCheckingAccountNumber();
+    Account* account = new CheckingAccount(accountNumber, customerId, initialDeposit, overdraftLimit);
+    configureAccount(account);
+    if (!openAccount(customer, account, initialDeposit, *transactionManager)) {
+        return "";
+    }
+    accounts[accountNumber] = account;
+    accountCustomerMap[accountNumber] = customerId;
+    totalAccountsCreated++;
+    totalDeposits += initialDeposit;
+    publishAccountGauges();
+    return accountNumber;
+}
+
+// Close an empty account
+bool Bank::closeAccount(string accountNumber) {
+    Account* account = findAccount(accountNumber);
+    if (account == nullptr) {
+        cout << "Account " << accountNumber << " not found." << endl;
+        return false;
+    }
+    if (fabs(account->getBalance()) > 0.005) {
+        cout << "Account " << accountNumber << " must be empty before it is closed (balance "
+             << fixed << setprecision(2) << account->getBalance() << ")." << endl;
+        return false;
+    }
+    Customer* customer = findCustomer(account->getCustomerId());
+    accounts.erase(accountNumber);
+    accountCustomerMap.erase(accountNumber);
+    if (customer != nullptr) {
+        customer->removeAccount(accountNumber); // Deletes it
+    } else {
+        delete account;
+    }
+    publishAccountGauges();
+    return true;
+}
+
+// Find an account by number (null if unknown)
+Account* Bank::findAccount(string accountNumber) const {
+    auto it = accounts.find(accountNumber);
+    return it != accounts.end() ? it->second : nullptr;
+}
+
+// Get a customer's accounts
+vector<Account*> Bank::getCustomerAccounts(string customerId) const {
+    Customer* customer = findCustomer(customerId);
+    return customer != nullptr ? customer->getAllAccounts() : vector<Account*>();
+}
+
+// Move an account to another customer (the balance and history stay with the account)
+bool Bank::transferAccountOwnership(string accountNumber, string newCustomerId) {
+    Account* account = findAccount(accountNumber);
+    Customer* newOwner = findCustomer(newCustomerId);
+    if (account == nullptr || newOwner == nullptr) {
+        cout << "Account or customer not found." << endl;
+        return false;
+    }
+    Customer* oldOwner = findCustomer(account->getCustomerId());
+    if (oldOwner == newOwner) {
+        return true;
+    }
+    // Rebuild the account under its new owner: Account's customer ID is fixed at construction
+    Account* moved;
+    if (SavingsAccount* savings = dynamic_cast<SavingsAccount*>(account)) {
+        SavingsAccount* movedSavings = new SavingsAccount(accountNumber, newCustomerId, savings->getBalance(),
+                                                          savings->getInterestRate(), savings->getMaxWithdrawals());
+        movedSavings->setWithdrawalCount(savings->getWithdrawalCount()); // Keeps this month's limit
+        moved = movedSavings;
+    } else {
+        CheckingAccount* checking = static_cast<CheckingAccount*>(account);
+        CheckingAccount* movedChecking = new CheckingAccount(accountNumber, newCustomerId, checking->getBalance(),
+                                                             checking->getOverdraftLimit());
+        movedChecking->setTransactionCount(checking->getTransactionCount()); // Keeps this month's free count
+        moved = movedChecking;
+    }
+    moved->updateBalance(account->getBalance()); // Negative (overdrawn) balances too
+    if (!account->isAccountActive()) {
+        moved->setActive(false);
+    }
+    configureAccount(moved);
+    if (oldOwner != nullptr) {
+        oldOwner->removeAccount(accountNumber); // Deletes the old object
+    } else {
+        delete account;
+    }
+    newOwner->addAccount(moved);
+    accounts[accountNumber] = moved;
+    accountCustomerMap[accountNumber] = newCustomerId;
+    return true;
+}
+
+// =============================================================================
+// ACCOUNT SERVICES
+// =============================================================================
+
+// Stop all activity on an account
+bool Bank::freezeAccount(string accountNumber, string reason) {
+    Account* account = findAccount(accountNumber);
+    if (account == nullptr) {
+        cout << "Account " << accountNumber << " not found." << endl;
+        return false;
+    }
+    account->setActive(false);
+    cout << "Account " << accountNumber << " frozen: " << reason << endl;
+    return true;
+}
+
+// Allow activity on a frozen account again
+bool Bank::unfreezeAccount(string accountNumber) {
+    Account* account = findAccount(accountNumber);
+    if (account == nullptr) {
+        cout << "Account " << accountNumber << " not found." << endl;
+        return false;
+    }
+    Customer* customer = findCustomer(account->getCustomerId());
+    if (customer != nullptr && !customer->isCustomerActive()) {
+        cout << "Customer " << account->getCustomerId() << " is inactive." << endl;
+        return false;
+    }
+    account->setActive(true);
+    return true;
+}
+
+// Convert an account between savings and checking, keeping its number and balance
+bool Bank::changeAccountType(string accountNumber, AccountType newType) {
+    syncConfiguration();
+    Account* account = findAccount(accountNumber);
+    if (account == nullptr) {
+        cout << "Account " << accountNumber << " not found." << endl;
+        return false;
+    }
+    if (account->getAccountType() == newType) {
+        return true;
+    }
+    double balance = account->getBalance();
+    if (newType == AccountType::SAVINGS && balance < minSavingsBalance) {
+        cout << "A savings account needs a balance of at least " << fixed << setprecision(2)
+             << minSavingsBalance << "." << endl;
+        return false;
+    }
+    string customerId = account->getCustomerId();
+    Account* converted;
+    if (newType == AccountType::SAVINGS) {
+        converted = new SavingsAccount(accountNumber, customerId, balance, savingsInterestRate);
+    } else {
+        converted = new CheckingAccount(accountNumber, customerId, balance, defaultOverdraftLimit);
+    }
+    if (!account->isAccountActive()) {
+        converted->setActive(false);
+    }
+    configureAccount(converted);
+    Customer* customer = findCustomer(customerId);
+    if (customer != nullptr) {
+        customer->removeAccount(accountNumber); // Deletes the old object
+        customer->addAccount(converted);
+    } else {
+        delete account;
+    }
+    accounts[accountNumber] = converted;
+    return true;
+}
+
+// Get an account's balance (0 if unknown)
+double Bank::getAccountBalance(string accountNumber) const {
+    Account* account = findAccount(accountNumber);
+    if (account == nullptr) {
+        cout << "Account " << accountNumber << " not found." << endl;
+        return 0.0;
+    }
+    return account->getBalance();
+}
+
+// =============================================================================
+// MONTH-END STEPS
+// =============================================================================
+
+// Credit monthly interest to every savings account
+bool Bank::applyInterestToSavingsAccounts() {
+    MonthEndOptions options;
+    options.chargeFees = false;
+    options.resetCounters = false;
+    runMonthEndProcessing(options);
+    return true;
+}
+
+// Charge the monthly maintenance fee to every checking account
+bool Bank::chargeMonthlyFees() {
+    MonthEndOptions options;
+    options.applyInterest = false;
+    options.resetCounters = false;
+    runMonthEndProcessing(options);
+    return true;
+}
+
+// =============================================================================
+// TRANSACTION HISTORY & ANALYTICS
+// =============================================================================
+
+// Get an account's transactions, newest first
+vector<Transaction> Bank::getAccountTransactionHistory(string accountNumber, int limit) const {
+    return transactionManager->getAccountHistory(accountNumber, limit);
+}
+
+// Get a customer's transactions, newest first
+vector<Transaction> Bank::getCustomerTransactionHistory(string customerId, int limit) const {
+    return transactionManager->getCustomerHistory(customerId, limit);
+}
+
+// Get deposits minus withdrawals for an account over a date range
+double Bank::getAccountNetFlow(string accountNumber, string startDate, string endDate) const {
+    return transactionManager->getNetFlow(accountNumber, startDate, endDate);
+}
+
+// =============================================================================
+// SYSTEM ADMINISTRATION
+// =============================================================================
+
+// Show bank-wide counts and totals, then the per-operation latency statistics
+void Bank::displaySystemStatistics() const {
+    cout << "\n=== " << bankName << " (" << bankCode << ") Statistics ===" << endl;
+    cout << "Customers:            " << customers.size() << endl;
+    cout << "Accounts:             " << accounts.size() << endl;
+    cout << "Customers created:    " << totalCustomersCreated << endl;
+    cout << "Accounts created:     " << totalAccountsCreated << endl;
+    cout << fixed << setprecision(2);
+    cout << "Total balance:        " << getTotalSystemBalance() << endl;
+    cout << "Total deposits:       " << totalDeposits << endl;
+    cout << "Total withdrawals:    " << totalWithdrawals << endl;
+    cout << "Ledger transactions:  " << transactionManager->getTotalTransactionCount() << endl;
+    cout << "Ledger volume:        " << transactionManager->getTotalSystemVolume() << endl;
+    Metrics::displayStatistics();
+}
+
+// List every customer
+void Bank::displayAllCustomers() const {
+    cout << "\n=== All Customers (" << customers.size() << ") ===" << endl;
+    for (const auto& pair : customers) {
+        pair.second->displayCustomerInfo();
+    }
+}
+
+// List every account
+void Bank::displayAllAccounts() const {
+    cout << "\n=== All Accounts (" << accounts.size() << ") ===" << endl;
+    for (const auto& pair : accounts) {
+        pair.second->displayAccountInfo();
+        cout << "----------------------------------------" << endl;
+    }
+}
+
+// List ledger rows of at least minAmount
+void Bank::displayLargeTransactions(double minAmount) const {
+    vector<Transaction> large = transactionManager->getTransactionsByAmountRange(minAmount, INFINITY);
+    cout << "\n=== Transactions of " << fixed << setprecision(2) << minAmount << " or more ("
+         << large.size() << ") ===" << endl;
+    for (const Transaction& transaction : large) {
+        transaction.displayTransaction();
+    }
+}
+
+// List frozen or inactive accounts
+void Bank::displayInactiveAccounts() const {
+    cout << "\n=== Inactive Accounts ===" << endl;
+    size_t count = 0;
+    for (const auto& pair : accounts) {
+        if (!pair.second->isAccountActive()) {
+            cout << pair.first << "  " << accountTypeName(pair.second->getAccountType()) << "  "
+                 << pair.second->getCustomerId() << "  " << fixed << setprecision(2)
+                 << pair.second->getBalance() << endl;
+            count++;
+        }
+    }
+    cout << count << " inactive account(s)." << endl;
+}
+
+// List customers holding more than one account
+void Bank::displayCustomersWithMultipleAccounts() const {
+    cout << "\n=== Customers With Multiple Accounts ===" << endl;
+    for (const auto& pair : customers) {
+        if (pair.second->getAccountCount() > 1) {
+            cout << pair.first << "  " << pair.second->getName() << "  " << pair.second->getAccountCount()
+                 << " accounts, total " << fixed << setprecision(2) << pair.second->getTotalBalance() << endl;
+        }
+    }
+}
+
+// =============================================================================
+// SYSTEM MAINTENANCE
+// =============================================================================
+
+// Check consistency, save everything and checkpoint the ledger
+void Bank::performSystemMaintenance() {
+    cout << "Running system maintenance..." << endl;
+    if (!validateSystemIntegrity()) {
+        fixDataInconsistencies();
+    }
+    saveAllData();
+    transactionManager->checkpoint();
+    cout << "System maintenance complete." << endl;
+}
+
+// Summarize one day's transactions (YYYY-MM-DD)
+void Bank::generateDailyReport(string date) const {
+    cout << "\n=== " << bankName << " Daily Report: " << date << " ===" << endl;
+    transactionManager->displayDailyTransactionSummary(date);
+}
+
+// Summarize one month's transactions (YYYY-MM)
+void Bank::generateMonthlyReport(string month) const {
+    cout << "\n=== " << bankName << " Monthly Report: " << month << " ===" << endl;
+    transactionManager->displayMonthlyTransactionSummary(month);
+}
+
+// Copy the data files to backup/ and write a backup set of the ledger
+bool Bank::backupSystemData() const {
+    if (!saveAllData()) {
+        return false;
+    }
+    error_code error;
+    filesystem::create_directories(BACKUP_DIRECTORY, error);
+    const pair<string, string> files[] = {{CUSTOMERS_FILE, "customers_backup.dat"},
+                                          {ACCOUNTS_FILE, "accounts_backup.dat"},
+                                          {SYSTEM_FILE, "system_config_backup.dat"}};
+    for (const auto& file : files) {
+        filesystem::copy_file(file.first, BACKUP_DIRECTORY + file.second,
+                              filesystem::copy_options::overwrite_existing, error);
+        if (error) {
+            cout << "Failed to back up " << file.first << ": " << error.message() << endl;
+            return false;
+        }
+    }
+    return transactionManager->createBackup(BACKUP_DIRECTORY);
+}
+
+// Put the backed-up data files back in data/ (loadAllData reads them)
+bool Bank::restoreSystemData() const {
+    error_code error;
+    const pair<string, string> files[] = {{"customers_backup.dat", CUSTOMERS_FILE},
+                                          {"accounts_backup.dat", ACCOUNTS_FILE},
+                                          {"system_config_backup.dat", SYSTEM_FILE}};
+    for (const auto& file : files) {
+        filesystem::copy_file(BACKUP_DIRECTORY + file.first, file.second,
+                              filesystem::copy_options::overwrite_existing, error);
+        if (error) {
+            cout << "Failed to restore " << file.second << ": " << error.message() << endl;
+            return false;
+        }
+    }
+    cout << "Data files restored from " << BACKUP_DIRECTORY << "; reload to use them." << endl;
+    return true;
+}
+
+// =============================================================================
+// SYSTEM CONFIGURATION
+// =============================================================================
+
+// Set the minimum balances (until the next configuration change)
+void Bank::setMinimumBalances(double savingsMin, double checkingMin) {
+    if (savingsMin < 0 || checkingMin < 0) {
+        cout << "Minimum balances cannot be negative." << endl;
+        return;
+    }
+    minSavingsBalance = savingsMin;
+    minCheckingBalance = checkingMin;
+    for (auto& pair : accounts) {
+        if (SavingsAccount* savings = dynamic_cast<SavingsAccount*>(pair.second)) {
+            savings->setMinimumBalance(savingsMin);
+        }
+    }
+}
+
+// Set the overdraft limit for new checking accounts
+void Bank::setDefaultOverdraftLimit(double limit) {
+    if (limit < 0) {
+        cout << "Overdraft limit cannot be negative." << endl;
+        return;
+    }
+    defaultOverdraftLimit = limit;
+}
+
+// Set the interest rate for new savings accounts
+void Bank::setSavingsInterestRate(double rate) {
+    if (rate < 0) {
+        cout << "Interest rate cannot be negative." << endl;
+        return;
+    }
+    savingsInterestRate = rate;
+}
+
+// Show the settings in force
+void Bank::displaySystemConfiguration() const {
+    shared_ptr<const BankConfig> config = getConfiguration();
+    cout << "\n=== System Configuration (version " << config->version << ") ===" << endl;
+    cout << fixed << setprecision(2);
+    cout << "Minimum savings balance:   " << minSavingsBalance << endl;
+    cout << "Minimum checking balance:  " << minCheckingBalance << endl;
+    cout << "Default overdraft limit:   " << defaultOverdraftLimit << endl;
+    cout << "Savings interest rate:     " << savingsInterestRate << endl;
+    cout << "Transaction fee:           " << config->transactionFee << endl;
+    cout << "Monthly maintenance fee:   " << config->monthlyMaintenanceFee << endl;
+    cout << "Free transactions:         " << config->freeTransactions << endl;
+    cout << "Max daily withdrawal:      " << config->limits.maxDailyWithdrawal << endl;
+    cout << "Max transfer amount:       " << config->limits.maxTransferAmount << endl;
+    cout << "Max withdrawals per month: " << config->limits.maxWithdrawalsPerMonth << endl;
+}
+
+// =============================================================================
+// DATA PERSISTENCE
+// =============================================================================
+
+// Write customers, accounts and counters (the ledger persists itself)
+bool Bank::saveAllData() const {
+    TraceSpan span("bank.save", "io");
+    vector<string> customerLines;
+    customerLines.reserve(customers.size());
+    for (const auto& pair : customers) {
+        const Customer& customer = *pair.second;
+        string line;
+        appendField(line, customer.getCustomerId());
+        appendField(line, customer.getName());
+        appendField(line, customer.getAddress());
+        appendField(line, customer.getPhoneNumber());
+        appendField(line, customer.getEmail());
+        appendField(line, customer.getHashedPin());
+        appendField(line, customer.getRegistrationDate());
+        appendField(line, customer.isCustomerActive() ? "1" : "0");
+        customerLines.push_back(move(line));
+    }
+    vector<string> accountLines;
+    accountLines.reserve(accounts.size());
+    for (const auto& pair : accounts) {
+        const Account* account = pair.second;
+        const CheckingAccount* checking = dynamic_cast<const CheckingAccount*>(account);
+        string line;
+        appendField(line, account->getAccountNumber());
+        appendField(line, account->getCustomerId());
+        appendField(line, accountTypeName(account->getAccountType()));
+        appendField(line, formatNumber(account->getBalance()));
+        appendField(line, account->isAccountActive() ? "1" : "0");
+        appendField(line, formatNumber(checking != nullptr ? checking->getOverdraftLimit() : 0.0));
+        accountLines.push_back(move(line));
+    }
+    vector<string> systemLines = {
+        "BANK_NAME=" + bankName,
+        "BANK_CODE=" + bankCode,
+        "NEXT_CUSTOMER_NUMBER=" + to_string(nextCustomerNumber),
+        "NEXT_SAVINGS_ACCOUNT_NUMBER=" + to_string(nextSavingsAccountNumber),
+        "NEXT_CHECKING_ACCOUNT_NUMBER=" + to_string(nextCheckingAccountNumber),
+        "TOTAL_DEPOSITS=" + formatNumber(totalDeposits),
+        "TOTAL_WITHDRAWALS=" + formatNumber(totalWithdrawals),
+        "TOTAL_CUSTOMERS_CREATED=" + to_string(totalCustomersCreated),
+        "TOTAL_ACCOUNTS_CREATED=" + to_string(totalAccountsCreated),
+    };
+    bool ok = writeLines(CUSTOMERS_FILE, customerLines) && writeLines(ACCOUNTS_FILE, accountLines) &&
+              writeLines(SYSTEM_FILE, systemLines);
+    if (ok) {
+        cout << "Saved " << customers.size() << " customers and " << accounts.size() << " accounts." << endl;
+    }
+    return ok;
+}
+
+// Replace the customers, accounts and counters with the saved ones
+bool Bank::loadAllData() {
+    TraceSpan span("bank.load", "io");
+    syncConfiguration();
+    ifstream customerFile(CUSTOMERS_FILE);
+    if (!customerFile.is_open()) {
+        cout << "No saved bank data found; starting empty." << endl;
+        return false;
+    }
+    accounts.clear();
+    accountCustomerMap.clear();
+    customers.clear();
+
+    string line;
+    size_t skipped = 0;
+    while (getline(customerFile, line)) {
+        vector<string> fields = splitFields(line);
+        if (line.empty() || fields.size() != 8) {
+            skipped += !line.empty();
+            continue;
+        }
+        unique_ptr<Customer> customer;
+        try {
+            customer = make_unique<Customer>(fields[0], fields[1], fields[2], fields[3], fields[4], "0");
+        } catch (const invalid_argument&) {
+            skipped++;
+            continue;
+        }
+        customer->hashedPin = fields[5];
+        customer->registrationDate = fields[6];
+        customer->isActive = fields[7] == "1";
+        nextCustomerNumber = max(nextCustomerNumber, idNumber(fields[0]) + 1);
+        customers[fields[0]] = move(customer);
+    }
+
+    ifstream accountFile(ACCOUNTS_FILE);
+    while (getline(accountFile, line)) {
+        vector<string> fields = splitFields(line);
+        Customer* customer = fields.size() == 6 ? findCustomer(fields[1]) : nullptr;
+        if (customer == nullptr) {
+            skipped += !line.empty();
+            continue;
+        }
+        double balance = strtod(fields[3].c_str(), nullptr);
+        Account* account;
+        if (fields[2] == "SAVINGS") {
+            account = new SavingsAccount(fields[0], fields[1], 0.0, savingsInterestRate);
+            nextSavingsAccountNumber = max(nextSavingsAccountNumber, idNumber(fields[0]) + 1);
+        } else {
+            account = new CheckingAccount(fields[0], fields[1], 0.0, strtod(fields[5].c_str(), nullptr));
+            nextCheckingAccountNumber = max(nextCheckingAccountNumber, idNumber(fields[0]) + 1);
+        }
+        account->updateBalance(balance); // Overdrawn balances load as they were
+        if (fields[4] != "1") {
+            account->setActive(false);
+        }
+        configureAccount(account);
+        customer->accounts.push_back(account);
+        accounts[fields[0]] = account;
+        accountCustomerMap[fields[0]] = fields[1];
+    }
+
+    ifstream systemFile(SYSTEM_FILE);
+    while (getline(systemFile, line)) {
+        size_t equals = line.find('=');
+        if (equals == string::npos) {
+            continue;
+        }
+        string key = line.substr(0, equals);
+        string value = line.substr(equals + 1);
+        if (key == "NEXT_CUSTOMER_NUMBER") {
+            nextCustomerNumber = max(nextCustomerNumber, atoi(value.c_str()));
+        } else if (key == "NEXT_SAVINGS_ACCOUNT_NUMBER") {
+            nextSavingsAccountNumber = max(nextSavingsAccountNumber, atoi(value.c_str()));
+        } else if (key == "NEXT_CHECKING_ACCOUNT_NUMBER") {
+            nextCheckingAccountNumber = max(nextCheckingAccountNumber, atoi(value.c_str()));
+        } else if (key == "TOTAL_DEPOSITS") {
+            totalDeposits = strtod(value.c_str(), nullptr);
+        } else if (key == "TOTAL_WITHDRAWALS") {
+            totalWithdrawals = strtod(value.c_str(), nullptr);
+        } else if (key == "TOTAL_CUSTOMERS_CREATED") {
+            totalCustomersCreated = atoi(value.c_str());
+        } else if (key == "TOTAL_ACCOUNTS_CREATED") {
+            totalAccountsCreated = atoi(value.c_str());
+        }
+    }
+
+    if (skipped > 0) {
+        cout << "Skipped " << skipped << " unreadable customer or account record(s)." << endl;
+    }
+    cout << "Loaded " << customers.size() << " customers and " << accounts.size() << " accounts." << endl;
+    publishAccountGauges();
+    return true;
+}
+
+// =============================================================================
+// SYSTEM VALIDATION
+// =============================================================================
+
+// Check the account indexes and compare balances with the ledger
+bool Bank::validateSystemIntegrity() const {
+    size_t problems = 0;
+    for (const auto& pair : accounts) {
+        auto owner = accountCustomerMap.find(pair.first);
+        Customer* customer = findCustomer(pair.second->getCustomerId());
+        if (owner == accountCustomerMap.end() || owner->second != pair.second->getCustomerId() ||
+            customer == nullptr || !customer->hasAccount(pair.first)) {
+            cout << "Account " << pair.first << " is not indexed under its customer." << endl;
+            problems++;
+        }
+    }
+    map<string, double> ledgerBalances = transactionManager->getLastKnownBalances();
+    for (const auto& pair : ledgerBalances) {
+        Account* account = findAccount(pair.first);
+        if (account != nullptr && fabs(account->getBalance() - pair.second) > 0.005) {
+            cout << "Account " << pair.first << " balance " << fixed << setprecision(2) << account->getBalance()
+                 << " differs from the ledger's " << pair.second << "." << endl;
+            problems++;
+        }
+    }
+    cout << (problems == 0 ? "System integrity check passed." : "System integrity check found problems.")
+         << endl;
+    return problems == 0;
+}
+
+// Rebuild the account indexes from the customers
+void Bank::fixDataInconsistencies() {
+    accounts.clear();
+    accountCustomerMap.clear();
+    for (const auto& pair : customers) {
+        for (Account* account : pair.second->getAllAccounts()) {
+            accounts[account->getAccountNumber()] = account;
+            accountCustomerMap[account->getAccountNumber()] = pair.first;
+        }
+    }
+    publishAccountGauges();
+    cout << "Account indexes rebuilt from " << customers.size() << " customers." << endl;
+}
+
+// =============================================================================
+// GETTERS
+// =============================================================================
+
+string Bank::getBankName() const {
+    return bankName;
+}
+
+string Bank::getBankCode() const {
+    return bankCode;
+}
+
+int Bank::getTotalCustomers() const {
+    return static_cast<int>(customers.size());
+}
+
+int Bank::getTotalAccounts() const {
+    return static_cast<int>(accounts.size());
+}
+
+double Bank::getTotalSystemBalance() const {
+    double total = 0.0;
+    for (const auto& pair : accounts) {
+        total += pair.second->getBalance();
+    }
+    return total;
+}
+
+int Bank::getTotalTransactions() const {
+    return transactionManager->getTotalTransactionCount();
+}
+
+// =============================================================================
+// ID GENERATION
+// =============================================================================
+
+// Next customer ID (CUST000001, ...)
+string Bank::generateCustomerId() {
+    stringstream ss;
+    ss << "CUST" << setfill('0') << setw(6) << nextCustomerNumber++;
+    return ss.str();
+}
+
+// Next savings account number (SAV000001, ...)
+string Bank::generateSavingsAccountNumber() {
+    stringstream ss;
+    ss << "SAV" << setfill('0') << setw(6) << nextSavingsAccountNumber++;
+    return ss.str();
+}
+
+// Next checking account number (CHK000001, ...)
+string Bank::generateCheckingAccountNumber() {
+    stringstream ss;
+    ss << "CHK" << setfill('0') << setw(6) << nextCheckingAccountNumber++;
+    return ss.str();
+}
@@ -0,0 +1,76 @@
+#include "Bank.h"
+
+using namespace std;
+
+// Asynchronous Bank operations. Each one takes asyncLock (suspending, not
+// blocking, while another operation holds it), runs the synchronous operation,
+// releases the lock and only then waits for the WAL: the fsync is shared by
+// every operation that committed in the meantime (group commit). An operation
+// whose commit could not be synced completes with false.
+
+// =============================================================================
+// TRANSACTION OPERATIONS
+// =============================================================================
+
+// Deposit money, completing once the deposit is durable
+Task<bool> Bank::depositAsync(string accountNumber, double amount, string description, string idempotencyKey) {
+    bool succeeded;
+    {
+        AsyncLockGuard guard = co_await asyncLock.lock();
+        succeeded = deposit(move(accountNumber), amount, move(description), move(idempotencyKey));
+    }
+    if (succeeded) {
+        succeeded = co_await waitForDurableCommits();
+    }
+    co_return succeeded;
+}
+
+// Withdraw money, completing once the withdrawal is durable
+Task<bool> Bank::withdrawAsync(string accountNumber, double amount, string description, string idempotencyKey) {
+    bool succeeded;
+    {
+        AsyncLockGuard guard = co_await asyncLock.lock();
+        succeeded = withdraw(move(accountNumber), amount, move(description), move(idempotencyKey));
+    }
+    if (succeeded) {
+        succeeded = co_await waitForDurableCommits();
+    }
+    co_return succeeded;
+}
+
+// Transfer money, completing once both legs are durable
+Task<bool> Bank::transferAsync(string fromAccount, string toAccount, double amount, string description,
+                               string idempotencyKey) {
+    bool succeeded;
+    {
+        AsyncLockGuard guard = co_await asyncLock.lock();
+        succeeded = transfer(move(fromAccount), move(toAccount), amount, move(description), move(idempotencyKey));
+    }
+    if (succeeded) {
+        succeeded = co_await waitForDurableCommits();
+    }
+    co_return succeeded;
+}
+
+// Read a balance without blocking on a concurrent operation
+Task<double> Bank::getAccountBalanceAsync(string accountNumber) {
+    AsyncLockGuard guard = co_await asyncLock.lock();
+    co_return getAccountBalance(move(accountNumber));
+}
+
+// Suspend until every committed transaction is on disk
+Task<bool> Bank::waitForDurableCommits() {
+    if (transactionManager == nullptr) {
+        co_return true;
+    }
+    bool durable = co_await transactionManager->waitForDurableCommit();
+    if (!durable) {
+        cout << "Write-ahead log sync failed; recent transactions may not survive a power loss." << endl;
+    }
+    co_return durable;
+}
+
+// The lock that serializes every concurrent use of this Bank
+AsyncMutex& Bank::getOperationLock() {
+    return asyncLock;
+}
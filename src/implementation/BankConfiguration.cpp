@@ -0,0 +1,86 @@
+#include "Bank.h"
+#include "LimitEngine.h"
+
+using namespace std;
+
+// Bank side of ConfigManager. The manager's watcher thread publishes new
+// snapshots; the operation thread picks them up through configReader (one
+// atomic load when nothing changed) and pushes the values into the Bank's
+// fields, its accounts and the transaction manager's limit engine, so the
+// values in config/bank_config.txt replace the built-in defaults. Until
+// loadConfiguration() is called the built-in defaults apply.
+
+// =============================================================================
+// LOADING
+// =============================================================================
+
+// Load the config files, apply them and reload whenever they change
+bool Bank::loadConfiguration(string bankConfigFile, string adminSettingsFile) {
+    configReader.reset();
+    configManager.reset(new ConfigManager(move(bankConfigFile), move(adminSettingsFile)));
+    bool loaded = configManager->load(); // On failure the defaults apply until the files are fixed
+    configManager->startWatching();
+    configReader.reset(new ConfigReader(*configManager));
+    applyConfiguration(configReader->current());
+    return loaded;
+}
+
+// Current configuration snapshot
+shared_ptr<const BankConfig> Bank::getConfiguration() const {
+    if (configManager == nullptr) {
+        return make_shared<const BankConfig>();
+    }
+    return configManager->get();
+}
+
+// Re-read the config files now and apply them
+bool Bank::reloadConfiguration() {
+    if (configManager == nullptr) {
+        return loadConfiguration();
+    }
+    bool loaded = configManager->load();
+    syncConfiguration();
+    return loaded;
+}
+
+// =============================================================================
+// APPLYING
+// =============================================================================
+
+// Apply a configuration published since the last operation (the only place a
+// newer snapshot is picked up, so one operation sees one version)
+void Bank::syncConfiguration() {
+    if (configReader != nullptr && configReader->refresh()) {
+        applyConfiguration(configReader->current());
+    }
+}
+
+// Push a configuration into the Bank, every account and the limit engine
+void Bank::applyConfiguration(const BankConfig& config) {
+    minSavingsBalance = config.minSavingsBalance;
+    minCheckingBalance = config.minCheckingBalance;
+    defaultOverdraftLimit = config.overdraftLimit;
+    savingsInterestRate = config.savingsInterestRate;
+    for (auto& pair : accounts) {
+        configureAccount(pair.second);
+    }
+    if (transactionManager != nullptr) {
+        transactionManager->getLimitEngine().setRules(config.limits);
+    }
+}
+
+// Bring one account's configured settings up to date (accounts opened or
+// loaded after the last change get them on first use)
+void Bank::configureAccount(Account* account) {
+    if (account == nullptr || configReader == nullptr) {
+        return;
+    }
+    const BankConfig& config = configReader->current();
+    if (SavingsAccount* savings = dynamic_cast<SavingsAccount*>(account)) {
+        savings->setMinimumBalance(config.minSavingsBalance);
+        savings->setMaxWithdrawals(config.limits.maxWithdrawalsPerMonth);
+    } else if (CheckingAccount* checking = dynamic_cast<CheckingAccount*>(account)) {
+        checking->setTransactionFee(config.transactionFee);
+        checking->setFreeTransactions(config.freeTransactions);
+    }
+}
@@ -0,0 +1,102 @@
+#include "Bank.h"
+
+using namespace std;
+
+// Monitoring side of the Bank: the per-operation latency histograms recorded
+// by METRICS_TIME_SCOPE in the Bank and TransactionManager operations (see
+// Metrics.h) written out for offline comparison, the span trace of
+// TraceSpan scopes (Tracing.h) for a timeline of one run, and the Prometheus
+// endpoint with the bank-level gauges.
+
+// =============================================================================
+// PERFORMANCE STATISTICS
+// =============================================================================
+
+// Write latency percentiles, counters and gauges as JSON
+bool Bank::writePerformanceStatistics(string filename) const {
+    if (!Metrics::writeStatisticsFile(filename)) {
+        cout << "Failed to write performance statistics to: " << filename << endl;
+        return false;
+    }
+    cout << "Performance statistics written to: " << filename << endl;
+    return true;
+}
+
+// =============================================================================
+// EXECUTION TRACE
+// =============================================================================
+
+// Start recording spans (clears any earlier trace)
+void Bank::startExecutionTrace() {
+    Tracing::start();
+    Tracing::setThreadName("bank");
+    cout << "Execution trace started." << endl;
+}
+
+// Stop recording and write the spans as Chrome trace-event JSON
+bool Bank::writeExecutionTrace(string filename) {
+    Tracing::stop();
+    if (!Tracing::writeChromeTrace(filename)) {
+        cout << "Failed to write execution trace to: " << filename << endl;
+        return false;
+    }
+    size_t dropped = Tracing::getDroppedSpanCount();
+    cout << "Execution trace written to: " << filename;
+    if (dropped > 0) {
+        cout << " (" << dropped << " spans dropped)";
+    }
+    cout << endl;
+    return true;
+}
+
+// =============================================================================
+// METRICS EXPORTER
+// =============================================================================
+
+static size_t totalBalanceGauge() {
+    static const size_t gauge = Metrics::registerGauge("bank.total_balance");
+    return gauge;
+}
+
+static size_t accountCountGauge() {
+    static const size_t gauge = Metrics::registerGauge("bank.accounts");
+    return gauge;
+}
+
+// Set both gauges from the current accounts (after a change to the account set
+// or to many balances at once)
+void Bank::publishAccountGauges() const {
+    double totalBalance = 0.0;
+    for (const auto& pair : accounts) {
+        totalBalance += pair.second->getBalance();
+    }
+    Metrics::setGauge(totalBalanceGauge(), totalBalance);
+    Metrics::setGauge(accountCountGauge(), static_cast<double>(accounts.size()));
+}
+
+// Move the total balance gauge by what one operation changed
+void Bank::adjustTotalBalanceGauge(double delta) {
+    Metrics::addGauge(totalBalanceGauge(), delta);
+}
+
+// Serve the metrics on 127.0.0.1:port until stopMetricsExporter (port 0 = any free port)
+bool Bank::startMetricsExporter(int port) {
+    if (metricsExporter != nullptr) {
+        return true;
+    }
+    publishAccountGauges();
+    metricsExporter.reset(new MetricsExporter());
+    if (!metricsExporter->start(port)) {
+        metricsExporter.reset();
+        return false;
+    }
+    return true;
+}
+
+// Stop serving metrics
+void Bank::stopMetricsExporter() {
+    if (metricsExporter != nullptr) {
+        metricsExporter->stop();
+        metricsExporter.reset();
+    }
+}
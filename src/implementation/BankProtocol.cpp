@@ -0,0 +1,253 @@
+#include "BankProtocol.h"
+#include <cstring>
+
+using namespace std;
+
+// =============================================================================
+// PRIMITIVES
+// =============================================================================
+
+// Append little-endian integers
+static void putUnsigned(string& out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+static void putDouble(string& out, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    putUnsigned(out, bits, 8);
+}
+
+static void putString(string& out, string_view text) {
+    size_t length = text.size() > 0xFFFF ? 0xFFFF : text.size();
+    putUnsigned(out, length, 2);
+    out.append(text.data(), length);
+}
+
+// Bounds-checked reader over one frame (no copies: strings come back as views)
+class FrameReader {
+private:
+    string_view data;
+    size_t offset;
+    bool valid;
+
+public:
+    FrameReader(string_view frame, size_t start) : data(frame), offset(start), valid(true) {
+    }
+
+    uint64_t getUnsigned(size_t bytes) {
+        if (!valid || data.size() - offset < bytes) {
+            valid = false;
+            return 0;
+        }
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(data[offset + i])) << (8 * i);
+        }
+        offset += bytes;
+        return value;
+    }
+
+    double getDouble() {
+        uint64_t bits = getUnsigned(8);
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    string_view getString() {
+        size_t length = static_cast<size_t>(getUnsigned(2));
+        if (!valid || data.size() - offset < length) {
+            valid = false;
+            return string_view();
+        }
+        string_view text = data.substr(offset, length);
+        offset += length;
+        return text;
+    }
+
+    // True while every read has succeeded
+    bool isValid() const {
+        return valid;
+    }
+
+    // True when every read succeeded and the payload was consumed exactly
+    bool finished() const {
+        return valid && offset == data.size();
+    }
+};
+
+// Start a frame; the length field is patched by endFrame
+static size_t beginFrame(string& out, BankOperation operation, uint16_t status, uint64_t requestId) {
+    size_t start = out.size();
+    out += static_cast<char>(BinaryProtocol::MAGIC);
+    out += static_cast<char>(operation);
+    putUnsigned(out, status, 2);
+    putUnsigned(out, 0, 4);
+    putUnsigned(out, requestId, 8);
+    return start;
+}
+
+static void endFrame(string& out, size_t start) {
+    uint32_t length = static_cast<uint32_t>(out.size() - start);
+    for (size_t i = 0; i < 4; i++) {
+        out[start + 4 + i] = static_cast<char>((length >> (8 * i)) & 0xFF);
+    }
+}
+
+// =============================================================================
+// FRAMING
+// =============================================================================
+
+// Size of the complete frame at the start of buffer
+size_t BinaryProtocol::frameSize(string_view buffer, size_t maxSize) {
+    if (buffer.empty()) {
+        return INCOMPLETE;
+    }
+    if (static_cast<uint8_t>(buffer[0]) != MAGIC) {
+        return MALFORMED;
+    }
+    if (buffer.size() < HEADER_SIZE) {
+        return INCOMPLETE;
+    }
+    size_t length = static_cast<size_t>(FrameReader(buffer, 4).getUnsigned(4));
+    if (length < HEADER_SIZE || length > maxSize) {
+        return MALFORMED;
+    }
+    return buffer.size() < length ? INCOMPLETE : length;
+}
+
+// =============================================================================
+// REQUESTS
+// =============================================================================
+
+// Decode a request frame
+bool BinaryProtocol::decodeRequest(string_view frame, BankRequest& request) {
+    if (frame.size() < HEADER_SIZE) {
+        return false;
+    }
+    FrameReader reader(frame, 1);
+    request = BankRequest();
+    request.operation = static_cast<BankOperation>(reader.getUnsigned(1));
+    reader.getUnsigned(2 + 4); // Status and length (already checked by frameSize)
+    request.requestId = reader.getUnsigned(8);
+    switch (request.operation) {
+        case BankOperation::PING:
+            break;
+        case BankOperation::BALANCE:
+            request.account = reader.getString();
+            break;
+        case BankOperation::DEPOSIT:
+        case BankOperation::WITHDRAW:
+            request.amount = reader.getDouble();
+            request.account = reader.getString();
+            request.description = reader.getString();
+            if (!reader.finished()) {
+                request.idempotencyKey = reader.getString();
+            }
+            break;
+        case BankOperation::TRANSFER:
+            request.amount = reader.getDouble();
+            request.account = reader.getString();
+            request.toAccount = reader.getString();
+            request.description = reader.getString();
+            if (!reader.finished()) {
+                request.idempotencyKey = reader.getString();
+            }
+            break;
+        case BankOperation::HISTORY:
+            request.limit = static_cast<uint32_t>(reader.getUnsigned(4));
+            request.account = reader.getString();
+            break;
+        default:
+            return true; // Framed correctly; the server answers UNKNOWN_OPERATION
+    }
+    return reader.finished();
+}
+
+// Encode a request frame
+void BinaryProtocol::encodeRequest(string& out, const BankRequest& request) {
+    size_t start = beginFrame(out, request.operation, 0, request.requestId);
+    switch (request.operation) {
+        case BankOperation::PING:
+            break;
+        case BankOperation::BALANCE:
+            putString(out, request.account);
+            break;
+        case BankOperation::DEPOSIT:
+        case BankOperation::WITHDRAW:
+            putDouble(out, request.amount);
+            putString(out, request.account);
+            putString(out, request.description);
+            putString(out, request.idempotencyKey);
+            break;
+        case BankOperation::TRANSFER:
+            putDouble(out, request.amount);
+            putString(out, request.account);
+            putString(out, request.toAccount);
+            putString(out, request.description);
+            putString(out, request.idempotencyKey);
+            break;
+        case BankOperation::HISTORY:
+            putUnsigned(out, request.limit, 4);
+            putString(out, request.account);
+            break;
+    }
+    endFrame(out, start);
+}
+
+// =============================================================================
+// REPLIES
+// =============================================================================
+
+// Encode a reply frame
+void BinaryProtocol::encodeReply(string& out, BankOperation operation, uint64_t requestId, const BankReply& reply) {
+    size_t start = beginFrame(out, operation, static_cast<uint16_t>(reply.status), requestId);
+    if (reply.status != ReplyStatus::OK) {
+        putString(out, reply.message);
+    } else if (operation == BankOperation::HISTORY) {
+        putUnsigned(out, reply.history.size(), 4);
+        for (const HistoryEntry& entry : reply.history) {
+            putString(out, entry.transactionId);
+            putUnsigned(out, entry.transactionType, 1);
+            putDouble(out, entry.amount);
+            putDouble(out, entry.balanceAfter);
+            putString(out, entry.timestamp);
+        }
+    } else if (operation != BankOperation::PING) {
+        putDouble(out, reply.balance);
+    }
+    endFrame(out, start);
+}
+
+// Decode a reply frame
+bool BinaryProtocol::decodeReply(string_view frame, BankOperation& operation, uint64_t& requestId, BankReply& reply) {
+    if (frame.size() < HEADER_SIZE) {
+        return false;
+    }
+    FrameReader reader(frame, 1);
+    reply = BankReply();
+    operation = static_cast<BankOperation>(reader.getUnsigned(1));
+    reply.status = static_cast<ReplyStatus>(reader.getUnsigned(2));
+    reader.getUnsigned(4);
+    requestId = reader.getUnsigned(8);
+    if (reply.status != ReplyStatus::OK) {
+        reply.message = string(reader.getString());
+    } else if (operation == BankOperation::HISTORY) {
+        size_t count = static_cast<size_t>(reader.getUnsigned(4));
+        for (size_t i = 0; i < count && reader.isValid(); i++) {
+            HistoryEntry entry;
+            entry.transactionId = string(reader.getString());
+            entry.transactionType = static_cast<uint8_t>(reader.getUnsigned(1));
+            entry.amount = reader.getDouble();
+            entry.balanceAfter = reader.getDouble();
+            entry.timestamp = string(reader.getString());
+            reply.history.push_back(move(entry));
+        }
+    } else if (operation != BankOperation::PING) {
+        reply.balance = reader.getDouble();
+    }
+    return reader.finished();
+}
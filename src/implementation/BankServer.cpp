@@ -0,0 +1,995 @@
+#include "BankServer.h"
+#include "BankProtocol.h"
+#include "Bank.h"
+#include "Utilities.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <unordered_map>
+#include <cerrno>
+#include <cstring>
+#include <cmath>
+#include <cctype>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+using namespace std;
+
+// =============================================================================
+// REACTOR
+// =============================================================================
+
+// Protocol of a connection, decided by the first byte it sends
+enum class ConnectionMode {
+    UNDECIDED,
+    TEXT,                               // One line at a time, answered in order
+    BINARY                              // Frames in batches, several batches in flight
+};
+
+// One client connection, owned by a single reactor thread
+struct ServerConnection {
+    int socket = -1;
+    ConnectionMode mode = ConnectionMode::UNDECIDED;
+    string input;                       // Bytes received but not yet dispatched
+    string output;                      // Bytes waiting to be written
+    size_t requestsInFlight = 0;
+    bool closeAfterWrite = false;       // QUIT or protocol error
+    bool inputClosed = false;           // Peer shut down its side; answer what was sent, then close
+    uint32_t registeredEvents = 0;      // Current epoll interest
+};
+
+// Event loop owning a set of connections. Other threads talk to it only
+// through the two queues below, followed by a write to its eventfd.
+class ServerReactor {
+private:
+    BankServer& server;
+    size_t index;
+    int epollSocket;
+    int wakeEvent;
+    thread loopThread;
+    atomic<bool> stopping;
+
+    mutex queueMutex;
+    vector<int> adoptedSockets;                             // From the acceptor
+    vector<pair<uint64_t, string>> completedResponses;      // From workers
+
+    unordered_map<uint64_t, ServerConnection> connections;  // Reactor thread only
+    uint64_t nextConnectionId = 1;                          // 0 is the wake event
+
+    static const uint64_t WAKE_ID = 0;
+
+    void loop();
+    void wake();
+    void drainQueues();
+    void readFrom(uint64_t id, ServerConnection& connection);
+    void dispatchNext(uint64_t id, ServerConnection& connection);
+    void dispatchLine(uint64_t id, ServerConnection& connection);
+    void dispatchFrames(uint64_t id, ServerConnection& connection);
+    void flush(uint64_t id, ServerConnection& connection);
+    void updateInterest(uint64_t id, ServerConnection& connection);
+    void closeConnection(uint64_t id);
+
+public:
+    ServerReactor(BankServer& owner, size_t reactorIndex);
+    ~ServerReactor();
+
+    bool start();
+
+    // Stop the loop thread (connections stay open until destruction)
+    void stop();
+
+    // Thread-safe hand-offs
+    void adopt(int socket);
+    void complete(uint64_t id, string response);
+};
+
+// Constructor
+ServerReactor::ServerReactor(BankServer& owner, size_t reactorIndex)
+    : server(owner), index(reactorIndex), epollSocket(-1), wakeEvent(-1), stopping(false) {
+}
+
+// Destructor (closes every connection)
+ServerReactor::~ServerReactor() {
+    stop();
+    for (auto& pair : connections) {
+        close(pair.second.socket);
+        server.connectionClosed();
+    }
+    for (int socket : adoptedSockets) {
+        close(socket);
+        server.connectionClosed();
+    }
+    if (epollSocket >= 0) {
+        close(epollSocket);
+    }
+    if (wakeEvent >= 0) {
+        close(wakeEvent);
+    }
+}
+
+// Create the epoll set and start the loop thread
+bool ServerReactor::start() {
+    epollSocket = epoll_create1(EPOLL_CLOEXEC);
+    wakeEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollSocket < 0 || wakeEvent < 0) {
+        cout << "Failed to create reactor " << index << ": " << strerror(errno) << endl;
+        return false;
+    }
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.u64 = WAKE_ID;
+    epoll_ctl(epollSocket, EPOLL_CTL_ADD, wakeEvent, &event);
+    loopThread = thread(&ServerReactor::loop, this);
+    return true;
+}
+
+// Stop the loop thread
+void ServerReactor::stop() {
+    if (loopThread.joinable()) {
+        stopping = true;
+        wake();
+        loopThread.join();
+    }
+}
+
+// Hand a freshly accepted socket to this reactor
+void ServerReactor::adopt(int socket) {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        adoptedSockets.push_back(socket);
+    }
+    wake();
+}
+
+// Hand a worker's response back to this reactor
+void ServerReactor::complete(uint64_t id, string response) {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        completedResponses.emplace_back(id, move(response));
+    }
+    wake();
+}
+
+// Interrupt epoll_wait
+void ServerReactor::wake() {
+    uint64_t one = 1;
+    ssize_t written = write(wakeEvent, &one, sizeof(one));
+    (void)written; // A full counter already guarantees a wake-up
+}
+
+// Reactor main loop
+void ServerReactor::loop() {
+    Tracing::setThreadName("reactor " + to_string(index));
+    epoll_event events[64];
+    while (!stopping) {
+        int ready = epoll_wait(epollSocket, events, 64, -1);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            cout << "Reactor " << index << " stopped: " << strerror(errno) << endl;
+            return;
+        }
+        for (int i = 0; i < ready; i++) {
+            uint64_t id = events[i].data.u64;
+            if (id == WAKE_ID) {
+                uint64_t count;
+                ssize_t received = read(wakeEvent, &count, sizeof(count));
+                (void)received;
+                drainQueues();
+                continue;
+            }
+            auto it = connections.find(id);
+            if (it == connections.end()) {
+                continue; // Closed earlier in this batch
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                closeConnection(id);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                flush(id, it->second);
+                it = connections.find(id);
+                if (it == connections.end()) {
+                    continue;
+                }
+            }
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP)) {
+                readFrom(id, it->second);
+            }
+        }
+    }
+}
+
+// Register adopted sockets and deliver finished responses
+void ServerReactor::drainQueues() {
+    vector<int> sockets;
+    vector<pair<uint64_t, string>> responses;
+    {
+        lock_guard<mutex> lock(queueMutex);
+        sockets.swap(adoptedSockets);
+        responses.swap(completedResponses);
+    }
+
+    for (int socket : sockets) {
+        uint64_t id = nextConnectionId++;
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = id;
+        if (epoll_ctl(epollSocket, EPOLL_CTL_ADD, socket, &event) != 0) {
+            close(socket);
+            server.connectionClosed();
+            continue;
+        }
+        ServerConnection& connection = connections[id];
+        connection.socket = socket;
+        connection.registeredEvents = event.events;
+    }
+
+    for (auto& response : responses) {
+        auto it = connections.find(response.first);
+        if (it == connections.end()) {
+            continue; // Client left while its request was running
+        }
+        ServerConnection& connection = it->second;
+        connection.requestsInFlight--;
+        connection.output += response.second;
+        dispatchNext(response.first, connection);   // Pipelined requests, in order
+        flush(response.first, connection);
+    }
+}
+
+// Read everything available, then dispatch the next complete line
+void ServerReactor::readFrom(uint64_t id, ServerConnection& connection) {
+    char buffer[16384];
+    while (true) {
+        ssize_t received = recv(connection.socket, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection.input.append(buffer, static_cast<size_t>(received));
+            if (connection.input.size() >= server.getOptions().maxBufferedBytes) {
+                break; // Stop reading until dispatch catches up (see updateInterest)
+            }
+            continue;
+        }
+        if (received == 0) {
+            connection.inputClosed = true;
+            break;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            closeConnection(id);
+            return;
+        }
+        break;
+    }
+    dispatchNext(id, connection);
+    flush(id, connection);
+}
+
+// Dispatch whatever complete requests the input holds
+void ServerReactor::dispatchNext(uint64_t id, ServerConnection& connection) {
+    if (connection.closeAfterWrite || connection.input.empty()) {
+        return;
+    }
+    if (connection.mode == ConnectionMode::UNDECIDED) {
+        connection.mode = static_cast<uint8_t>(connection.input[0]) == BinaryProtocol::MAGIC
+                              ? ConnectionMode::BINARY
+                              : ConnectionMode::TEXT;
+    }
+    if (connection.mode == ConnectionMode::BINARY) {
+        dispatchFrames(id, connection);
+    } else {
+        dispatchLine(id, connection);
+    }
+}
+
+// Dispatch the next complete request line (one in flight per connection)
+void ServerReactor::dispatchLine(uint64_t id, ServerConnection& connection) {
+    if (connection.requestsInFlight > 0) {
+        return;
+    }
+    while (true) {
+        size_t newline = connection.input.find('\n');
+        if (newline == string::npos) {
+            if (connection.input.size() > server.getOptions().maxRequestBytes) {
+                connection.output += "ERR request too long\n";
+                connection.closeAfterWrite = true;
+            }
+            return;
+        }
+        string request = connection.input.substr(0, newline);
+        connection.input.erase(0, newline + 1);
+        if (!request.empty() && request.back() == '\r') {
+            request.pop_back();
+        }
+        if (request.empty()) {
+            continue; // Blank keep-alive line
+        }
+        if (request.size() > server.getOptions().maxRequestBytes) {
+            connection.output += "ERR request too long\n";
+            connection.closeAfterWrite = true;
+            return;
+        }
+        if (request == "QUIT") {
+            connection.output += "OK BYE\n";
+            connection.closeAfterWrite = true;
+            return;
+        }
+        connection.requestsInFlight++;
+        server.dispatch(move(request), [this, id](string response) {
+            complete(id, move(response));
+        });
+        return;
+    }
+}
+
+// Dispatch every complete frame as one batch (replies carry request ids, so
+// batches may finish in any order)
+void ServerReactor::dispatchFrames(uint64_t id, ServerConnection& connection) {
+    if (connection.requestsInFlight >= server.getOptions().maxPipelinedBatches) {
+        return;
+    }
+    string_view pending(connection.input);
+    size_t framed = 0;
+    while (true) {
+        size_t size = BinaryProtocol::frameSize(pending.substr(framed), server.getOptions().maxRequestBytes);
+        if (size == BinaryProtocol::MALFORMED) {
+            connection.closeAfterWrite = true; // Framing is lost; nothing after this can be trusted
+            connection.input.clear();
+            return;
+        }
+        if (size == BinaryProtocol::INCOMPLETE) {
+            break;
+        }
+        framed += size;
+    }
+    if (framed == 0) {
+        return;
+    }
+    // Hand the receive buffer itself to the worker; only a partial trailing frame is copied back
+    string frames;
+    frames.swap(connection.input);
+    connection.input.assign(frames, framed, string::npos);
+    frames.resize(framed);
+    connection.requestsInFlight++;
+    server.dispatchFrames(move(frames), [this, id](string response) {
+        complete(id, move(response));
+    });
+}
+
+// Write as much pending output as the socket takes
+void ServerReactor::flush(uint64_t id, ServerConnection& connection) {
+    size_t sent = 0;
+    while (sent < connection.output.size()) {
+        ssize_t written = send(connection.socket, connection.output.data() + sent,
+                               connection.output.size() - sent, MSG_NOSIGNAL);
+        if (written > 0) {
+            sent += static_cast<size_t>(written);
+        } else if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            closeConnection(id);
+            return;
+        }
+    }
+    connection.output.erase(0, sent);
+
+    bool finished = connection.closeAfterWrite ||
+                    (connection.inputClosed && connection.requestsInFlight == 0);
+    if (connection.output.empty() && finished) {
+        closeConnection(id);
+        return;
+    }
+    updateInterest(id, connection);
+}
+
+// Read while the peer may still send and the input buffer has room; ask for EPOLLOUT only while output is backed up
+void ServerReactor::updateInterest(uint64_t id, ServerConnection& connection) {
+    bool canRead = !connection.inputClosed && connection.input.size() < server.getOptions().maxBufferedBytes;
+    uint32_t wanted = (canRead ? static_cast<uint32_t>(EPOLLIN | EPOLLRDHUP) : 0u) |
+                      (connection.output.empty() ? 0u : static_cast<uint32_t>(EPOLLOUT));
+    if (wanted != connection.registeredEvents) {
+        epoll_event event = {};
+        event.events = wanted;
+        event.data.u64 = id;
+        epoll_ctl(epollSocket, EPOLL_CTL_MOD, connection.socket, &event);
+        connection.registeredEvents = wanted;
+    }
+}
+
+// Close a connection and forget it
+void ServerReactor::closeConnection(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) {
+        return;
+    }
+    epoll_ctl(epollSocket, EPOLL_CTL_DEL, it->second.socket, nullptr);
+    close(it->second.socket);
+    connections.erase(it);
+    server.connectionClosed();
+}
+
+// =============================================================================
+// SERVER LIFECYCLE
+// =============================================================================
+
+// Constructor
+BankServer::BankServer(Bank& servedBank, const BankServerOptions& serverOptions)
+    : bank(servedBank), options(serverOptions), workers(serverOptions.workerCount),
+      stopEvent(-1), port(0), running(false), openConnections(0) {
+    if (options.reactorCount == 0) {
+        options.reactorCount = min<size_t>(4, ThreadPool::getDefaultThreadCount());
+    }
+}
+
+// Destructor
+BankServer::~BankServer() {
+    stop();
+}
+
+// Open the listening sockets and start the reactors
+bool BankServer::start() {
+    if (running) {
+        return true;
+    }
+    stopEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (stopEvent < 0 || !listenTcp() || (!options.unixSocketPath.empty() && !listenUnix())) {
+        stop();
+        return false;
+    }
+    for (size_t i = 0; i < options.reactorCount; i++) {
+        reactors.push_back(unique_ptr<ServerReactor>(new ServerReactor(*this, i)));
+        if (!reactors.back()->start()) {
+            stop();
+            return false;
+        }
+    }
+    running = true;
+    acceptThread = thread(&BankServer::acceptLoop, this);
+    cout << "Bank server listening on " << options.bindAddress << ":" << port;
+    if (!options.unixSocketPath.empty()) {
+        cout << " and " << options.unixSocketPath;
+    }
+    cout << " (" << reactors.size() << " reactors, " << workers.getThreadCount() << " workers)" << endl;
+    return true;
+}
+
+// Stop accepting, let in-flight requests finish, then close everything
+void BankServer::stop() {
+    if (acceptThread.joinable()) {
+        uint64_t one = 1;
+        ssize_t written = write(stopEvent, &one, sizeof(one));
+        (void)written;
+        acceptThread.join();
+    }
+    for (unique_ptr<ServerReactor>& reactor : reactors) {
+        reactor->stop();
+    }
+    workers.waitForAll();   // In-flight requests finish against live (stopped) reactors
+    reactors.clear();
+    for (int socket : listenSockets) {
+        close(socket);
+    }
+    listenSockets.clear();
+    if (!options.unixSocketPath.empty()) {
+        unlink(options.unixSocketPath.c_str());
+    }
+    if (stopEvent >= 0) {
+        close(stopEvent);
+        stopEvent = -1;
+    }
+    if (running) {
+        running = false;
+        cout << "Bank server stopped." << endl;
+    }
+}
+
+// Listen on bindAddress:port
+bool BankServer::listenTcp() {
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(options.port));
+    if (inet_pton(AF_INET, options.bindAddress.c_str(), &address.sin_addr) != 1) {
+        cout << "Invalid server bind address: " << options.bindAddress << endl;
+        return false;
+    }
+    int socket = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socket < 0) {
+        cout << "Failed to create server socket: " << strerror(errno) << endl;
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (::bind(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(socket, SOMAXCONN) != 0) {
+        cout << "Failed to listen on " << options.bindAddress << ":" << options.port << ": "
+             << strerror(errno) << endl;
+        close(socket);
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    getsockname(socket, reinterpret_cast<sockaddr*>(&address), &length);
+    port = ntohs(address.sin_port);
+    listenSockets.push_back(socket);
+    return true;
+}
+
+// Listen on the Unix socket path (a stale socket file is replaced)
+bool BankServer::listenUnix() {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (options.unixSocketPath.size() >= sizeof(address.sun_path)) {
+        cout << "Unix socket path too long: " << options.unixSocketPath << endl;
+        return false;
+    }
+    strncpy(address.sun_path, options.unixSocketPath.c_str(), sizeof(address.sun_path) - 1);
+    int socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socket < 0) {
+        cout << "Failed to create Unix socket: " << strerror(errno) << endl;
+        return false;
+    }
+    unlink(options.unixSocketPath.c_str());
+    if (::bind(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(socket, SOMAXCONN) != 0) {
+        cout << "Failed to listen on " << options.unixSocketPath << ": " << strerror(errno) << endl;
+        close(socket);
+        return false;
+    }
+    listenSockets.push_back(socket);
+    return true;
+}
+
+// Out of descriptors: spend the reserve one on accepting the waiting
+// connection, refuse it and take the reserve back. False if there is no
+// reserve (it could not be reopened last time).
+static bool shedConnection(int listenSocket, int& reserveDescriptor) {
+    if (reserveDescriptor < 0) {
+        return false;
+    }
+    close(reserveDescriptor);
+    int client = accept4(listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+    if (client >= 0) {
+        const char* busy = "ERR server busy\n";
+        ssize_t written = send(client, busy, strlen(busy), MSG_NOSIGNAL);
+        (void)written;
+        close(client);
+    }
+    reserveDescriptor = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    return client >= 0;
+}
+
+// Accept connections and spread them over the reactors. The listeners are
+// level-triggered, so a connection that cannot be accepted would wake the
+// loop again at once: on EMFILE/ENFILE it is refused through a reserve
+// descriptor, and if that is gone too (or accept fails for lack of memory)
+// the listeners are taken out of epoll for ACCEPT_PAUSE_MS.
+void BankServer::acceptLoop() {
+    static const int ACCEPT_PAUSE_MS = 100;
+    Tracing::setThreadName("acceptor");
+    static const size_t acceptedCounter = Metrics::registerCounter("server.connections_accepted");
+    static const size_t rejectedCounter = Metrics::registerCounter("server.connections_rejected");
+    int epollSocket = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = stopEvent;
+    epoll_ctl(epollSocket, EPOLL_CTL_ADD, stopEvent, &event);
+    for (int socket : listenSockets) {
+        event.data.fd = socket;
+        epoll_ctl(epollSocket, EPOLL_CTL_ADD, socket, &event);
+    }
+    int reserveDescriptor = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    size_t nextReactor = 0;
+    epoll_event events[8];
+    bool stopping = false;
+    bool listenersPaused = false;
+    while (!stopping) {
+        int ready = epoll_wait(epollSocket, events, 8, listenersPaused ? ACCEPT_PAUSE_MS : -1);
+        if (listenersPaused) {
+            for (int socket : listenSockets) {
+                event.data.fd = socket;
+                epoll_ctl(epollSocket, EPOLL_CTL_ADD, socket, &event);
+            }
+            if (reserveDescriptor < 0) {
+                reserveDescriptor = open("/dev/null", O_RDONLY | O_CLOEXEC);
+            }
+            listenersPaused = false;
+        }
+        bool pauseListeners = false;
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.fd == stopEvent) {
+                stopping = true;
+                break;
+            }
+            while (true) {
+                int client = accept4(events[i].data.fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (client < 0) {
+                    if (errno == EINTR || errno == ECONNABORTED) {
+                        continue;
+                    }
+                    if ((errno == EMFILE || errno == ENFILE) &&
+                        shedConnection(events[i].data.fd, reserveDescriptor)) {
+                        Metrics::incrementCounter(rejectedCounter);
+                        continue;
+                    }
+                    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                        pauseListeners = true;
+                    }
+                    break; // EAGAIN: backlog drained
+                }
+                if (!acceptsMoreConnections()) {
+                    Metrics::incrementCounter(rejectedCounter);
+                    const char* busy = "ERR server busy\n";
+                    ssize_t written = send(client, busy, strlen(busy), MSG_NOSIGNAL);
+                    (void)written;
+                    close(client);
+                    continue;
+                }
+                int noDelay = 1;
+                setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay)); // Fails harmlessly on Unix sockets
+                Metrics::incrementCounter(acceptedCounter);
+                connectionOpened();
+                reactors[nextReactor]->adopt(client);
+                nextReactor = (nextReactor + 1) % reactors.size();
+            }
+        }
+        if (pauseListeners && !stopping) {
+            for (int socket : listenSockets) {
+                epoll_ctl(epollSocket, EPOLL_CTL_DEL, socket, nullptr);
+            }
+            listenersPaused = true;
+        }
+    }
+    if (reserveDescriptor >= 0) {
+        close(reserveDescriptor);
+    }
+    close(epollSocket);
+}
+
+// =============================================================================
+// CONNECTION ACCOUNTING
+// =============================================================================
+
+// Count an opened connection
+void BankServer::connectionOpened() {
+    static const size_t openGauge = Metrics::registerGauge("server.open_connections");
+    openConnections++;
+    Metrics::addGauge(openGauge, 1);
+}
+
+// Count a closed connection
+void BankServer::connectionClosed() {
+    static const size_t openGauge = Metrics::registerGauge("server.open_connections");
+    openConnections--;
+    Metrics::addGauge(openGauge, -1);
+}
+
+// Check the connection limit
+bool BankServer::acceptsMoreConnections() const {
+    return openConnections < options.maxConnections;
+}
+
+// Check whether the server is running
+bool BankServer::isRunning() const {
+    return running;
+}
+
+// Get the TCP port being served (useful after port 0)
+int BankServer::getPort() const {
+    return port;
+}
+
+// Get number of open client connections
+size_t BankServer::getOpenConnectionCount() const {
+    return openConnections;
+}
+
+// Get the server configuration
+const BankServerOptions& BankServer::getOptions() const {
+    return options;
+}
+
+// =============================================================================
+// REQUEST HANDLING
+// =============================================================================
+
+// Queue a request line on the worker pool
+void BankServer::dispatch(string request, function<void(string)> done) {
+    workers.submit([this, request = move(request), done = move(done)] {
+        done(handleRequest(request));
+    });
+}
+
+// Queue a batch of binary frames on the worker pool
+void BankServer::dispatchFrames(string frames, function<void(string)> done) {
+    workers.submit([this, frames = move(frames), done = move(done)] {
+        done(handleFrames(frames));
+    });
+}
+
+// Format an amount with two decimals
+static string formatAmount(double amount) {
+    stringstream ss;
+    ss << fixed << setprecision(2) << amount;
+    return ss.str();
+}
+
+// Split off the next space-separated token
+static string_view nextToken(string_view& rest) {
+    size_t begin = rest.find_first_not_of(' ');
+    if (begin == string_view::npos) {
+        rest = string_view();
+        return string_view();
+    }
+    size_t end = rest.find(' ', begin);
+    string_view token = rest.substr(begin, end == string_view::npos ? string_view::npos : end - begin);
+    rest = end == string_view::npos ? string_view() : rest.substr(end);
+    return token;
+}
+
+// Parse a number token
+static bool parseNumber(string_view token, double& value) {
+    string text(token);
+    char* end = nullptr;
+    value = strtod(text.c_str(), &end);
+    return !text.empty() && end != nullptr && *end == '\0';
+}
+
+// Parse a text request line; the request's strings point into line
+static bool parseTextRequest(string_view line, BankRequest& request, string& usage) {
+    string_view rest = line;
+    string command(nextToken(rest));
+    transform(command.begin(), command.end(), command.begin(), ::toupper);
+    string_view amountText;
+    double number = 0.0;
+    if (command == "PING") {
+        request.operation = BankOperation::PING;
+        return true;
+    } else if (command == "BALANCE") {
+        request.operation = BankOperation::BALANCE;
+        request.account = nextToken(rest);
+        usage = "usage: BALANCE <account>";
+        return !request.account.empty();
+    } else if (command == "DEPOSIT" || command == "WITHDRAW") {
+        request.operation = command == "DEPOSIT" ? BankOperation::DEPOSIT : BankOperation::WITHDRAW;
+        request.account = nextToken(rest);
+        amountText = nextToken(rest);
+        usage = "usage: " + command + " <account> <amount> [key=<idempotency key>] [description]";
+    } else if (command == "TRANSFER") {
+        request.operation = BankOperation::TRANSFER;
+        request.account = nextToken(rest);
+        request.toAccount = nextToken(rest);
+        amountText = nextToken(rest);
+        usage = "usage: TRANSFER <from> <to> <amount> [key=<idempotency key>] [description]";
+        if (request.toAccount.empty()) {
+            return false;
+        }
+    } else if (command == "HISTORY") {
+        request.operation = BankOperation::HISTORY;
+        request.account = nextToken(rest);
+        string_view limitText = nextToken(rest);
+        usage = "usage: HISTORY <account> [limit]";
+        if (!limitText.empty() && (!parseNumber(limitText, number) || number < 1 || number > UINT32_MAX)) {
+            return false;
+        }
+        request.limit = limitText.empty() ? 50 : static_cast<uint32_t>(number);
+        return !request.account.empty();
+    } else {
+        usage = "unknown command";
+        return false;
+    }
+    // Money movements: an optional key=<token>, then free-text description
+    size_t keyStart = rest.find_first_not_of(' ');
+    if (keyStart != string_view::npos && rest.compare(keyStart, 4, "key=") == 0) {
+        request.idempotencyKey = nextToken(rest).substr(4);
+        if (request.idempotencyKey.empty()) {
+            return false;
+        }
+    }
+    size_t descriptionStart = rest.find_first_not_of(' ');
+    request.description = descriptionStart == string_view::npos ? string_view() : rest.substr(descriptionStart);
+    if (!parseNumber(amountText, request.amount)) {
+        return false;
+    }
+    return !request.account.empty();
+}
+
+// True for the requests whose reply must wait until the WAL holds them on disk
+static bool movesMoney(BankOperation operation) {
+    return operation == BankOperation::DEPOSIT || operation == BankOperation::WITHDRAW ||
+           operation == BankOperation::TRANSFER;
+}
+
+// Wait (bank lock released) until every commit so far is durable; concurrent
+// workers share one fsync
+static bool awaitDurability(Bank& bank) {
+    static const size_t failureCounter = Metrics::registerCounter("server.durability_failures");
+    if (syncWait(bank.waitForDurableCommits())) {
+        return true;
+    }
+    Metrics::incrementCounter(failureCounter);
+    return false;
+}
+
+// Execute one decoded request (bank operation lock held)
+BankReply BankServer::execute(const BankRequest& request) {
+    BankReply reply;
+    auto fail = [&reply](ReplyStatus status, const string& message) {
+        reply.status = status;
+        reply.message = message;
+        return reply;
+    };
+    if (request.operation == BankOperation::PING) {
+        return reply;
+    }
+    string account(request.account);
+    switch (request.operation) {
+        case BankOperation::BALANCE:
+            if (bank.findAccount(account) == nullptr) {
+                return fail(ReplyStatus::UNKNOWN_ACCOUNT, "unknown account");
+            }
+            reply.balance = bank.getAccountBalance(account);
+            return reply;
+        case BankOperation::DEPOSIT:
+        case BankOperation::WITHDRAW:
+        case BankOperation::TRANSFER: {
+            if (!isfinite(request.amount) || !isValidAmount(request.amount)) {
+                return fail(ReplyStatus::BAD_REQUEST, "invalid amount");
+            }
+            bool ok;
+            if (request.operation == BankOperation::DEPOSIT) {
+                ok = bank.deposit(account, request.amount,
+                                  request.description.empty() ? "Deposit" : string(request.description),
+                                  string(request.idempotencyKey));
+            } else if (request.operation == BankOperation::WITHDRAW) {
+                ok = bank.withdraw(account, request.amount,
+                                   request.description.empty() ? "Withdrawal" : string(request.description),
+                                   string(request.idempotencyKey));
+            } else {
+                ok = bank.transfer(account, string(request.toAccount), request.amount,
+                                   request.description.empty() ? "Transfer" : string(request.description),
+                                   string(request.idempotencyKey));
+            }
+            if (!ok) {
+                const char* name = request.operation == BankOperation::DEPOSIT    ? "deposit rejected"
+                                   : request.operation == BankOperation::WITHDRAW ? "withdrawal rejected"
+                                                                                  : "transfer rejected";
+                return fail(ReplyStatus::REJECTED, name);
+            }
+            reply.balance = bank.getAccountBalance(account);
+            return reply;
+        }
+        case BankOperation::HISTORY: {
+            if (bank.findAccount(account) == nullptr) {
+                return fail(ReplyStatus::UNKNOWN_ACCOUNT, "unknown account");
+            }
+            int limit = static_cast<int>(min<uint32_t>(request.limit, MAX_HISTORY_ROWS));
+            for (const Transaction& txn : bank.getAccountTransactionHistory(account, limit)) {
+                HistoryEntry entry;
+                entry.transactionId = txn.getTransactionId();
+                entry.transactionType = static_cast<uint8_t>(txn.getTransactionType());
+                entry.amount = txn.getAmount();
+                entry.balanceAfter = txn.getBalanceAfter();
+                entry.timestamp = txn.getTimestamp();
+                reply.history.push_back(move(entry));
+            }
+            return reply;
+        }
+        default:
+            return fail(ReplyStatus::UNKNOWN_OPERATION, "unknown operation");
+    }
+}
+
+// Execute one request line
+string BankServer::handleRequest(const string& request) {
+    METRICS_TIME_SCOPE("BankServer::handleRequest");
+    TraceSpan span("server.request", "server");
+    static const size_t errorCounter = Metrics::registerCounter("server.request_errors");
+
+    BankRequest parsed;
+    string usage;
+    BankReply reply;
+    if (!parseTextRequest(request, parsed, usage)) {
+        reply.status = ReplyStatus::BAD_REQUEST;
+        reply.message = usage;
+    } else {
+        {
+            AsyncLockGuard lock = bank.getOperationLock().lockBlocking();
+            reply = execute(parsed);
+        }
+        if (reply.status == ReplyStatus::OK && movesMoney(parsed.operation) && !awaitDurability(bank)) {
+            reply.status = ReplyStatus::NOT_DURABLE;
+            reply.message = "not durable";
+        }
+    }
+
+    string response;
+    if (reply.status != ReplyStatus::OK) {
+        Metrics::incrementCounter(errorCounter);
+        response = "ERR " + reply.message;
+    } else if (parsed.operation == BankOperation::PING) {
+        response = "OK PONG";
+    } else if (parsed.operation == BankOperation::HISTORY) {
+        // One line per transaction: id type amount balance-after timestamp
+        response = "OK " + to_string(reply.history.size());
+        for (const HistoryEntry& entry : reply.history) {
+            response += "\n" + entry.transactionId + " " +
+                        transactionTypeToString(static_cast<TransactionType>(entry.transactionType)) + " " +
+                        formatAmount(entry.amount) + " " + formatAmount(entry.balanceAfter) + " " + entry.timestamp;
+        }
+    } else {
+        response = "OK " + formatAmount(reply.balance);
+    }
+    response += '\n';
+    return response;
+}
+
+// Execute a batch of binary frames (one bank lock for the whole batch)
+string BankServer::handleFrames(const string& frames) {
+    METRICS_TIME_SCOPE("BankServer::handleFrames");
+    TraceSpan span("server.frames", "server");
+    static const size_t requestCounter = Metrics::registerCounter("server.binary_requests");
+    static const size_t errorCounter = Metrics::registerCounter("server.request_errors");
+
+    vector<BankRequest> requests;
+    vector<BankReply> replies;
+    string_view pending(frames);
+    while (!pending.empty()) {
+        size_t size = BinaryProtocol::frameSize(pending); // Already validated by the reactor
+        BankRequest request;
+        bool decoded = BinaryProtocol::decodeRequest(pending.substr(0, size), request);
+        requests.push_back(request);
+        replies.emplace_back();
+        if (!decoded) {
+            replies.back().status = ReplyStatus::BAD_REQUEST;
+            replies.back().message = "malformed request";
+        }
+        pending.remove_prefix(size);
+    }
+    {
+        AsyncLockGuard lock = bank.getOperationLock().lockBlocking();
+        for (size_t i = 0; i < requests.size(); i++) {
+            if (replies[i].status == ReplyStatus::OK) {
+                replies[i] = execute(requests[i]);
+            }
+        }
+    }
+    // Acknowledge money-moving requests only once the whole batch is durable
+    bool needsSync = false;
+    for (size_t i = 0; i < requests.size(); i++) {
+        needsSync = needsSync || (replies[i].status == ReplyStatus::OK && movesMoney(requests[i].operation));
+    }
+    if (needsSync && !awaitDurability(bank)) {
+        for (size_t i = 0; i < requests.size(); i++) {
+            if (replies[i].status == ReplyStatus::OK && movesMoney(requests[i].operation)) {
+                replies[i].status = ReplyStatus::NOT_DURABLE;
+                replies[i].message = "not durable";
+            }
+        }
+    }
+
+    string response;
+    response.reserve(requests.size() * 32);
+    for (size_t i = 0; i < requests.size(); i++) {
+        if (replies[i].status != ReplyStatus::OK) {
+            Metrics::incrementCounter(errorCounter);
+        }
+        BinaryProtocol::encodeReply(response, requests[i].operation, requests[i].requestId, replies[i]);
+    }
+    Metrics::incrementCounter(requestCounter, requests.size());
+    return response;
+}
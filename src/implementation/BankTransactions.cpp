@@ -0,0 +1,238 @@
+#include "Bank.h"
+#include "LimitEngine.h"
+
+using namespace std;
+
+// Money-moving Bank operations. Each one looks up the request's idempotency
+// key before touching an account, so a retried request moves nothing, and
+// checks withdrawals and outgoing transfers against the rolling-window limits;
+// then it changes the balances and records the ledger rows. If the ledger
+// refuses the rows the balances and monthly counters are put back, so an
+// account never moves without a matching transaction. Configuration changes are picked up first
+// (BankConfiguration.cpp).
+
+// =============================================================================
+// HELPERS
+// =============================================================================
+
+// Has this request already been committed? (prints the original transaction)
+static bool alreadyCommitted(const TransactionManager& manager, const string& idempotencyKey) {
+    string transactionId;
+    if (!manager.findIdempotentCommit(idempotencyKey, transactionId)) {
+        return false;
+    }
+    cout << "Request " << idempotencyKey << " was already processed as " << transactionId
+         << "; nothing changed." << endl;
+    return true;
+}
+
+// What a transaction may change on an account: the balance and the monthly
+// withdrawal (savings) or transaction (checking) count
+struct AccountState {
+    double balance;
+    int monthlyCount;
+};
+
+// Remember an account's state before changing it
+static AccountState saveState(const Account* account) {
+    AccountState state{account->getBalance(), 0};
+    if (const SavingsAccount* savings = dynamic_cast<const SavingsAccount*>(account)) {
+        state.monthlyCount = savings->getWithdrawalCount();
+    } else if (const CheckingAccount* checking = dynamic_cast<const CheckingAccount*>(account)) {
+        state.monthlyCount = checking->getTransactionCount();
+    }
+    return state;
+}
+
+// Put an account back the way saveState found it
+static void restoreState(Account* account, const AccountState& state) {
+    account->updateBalance(state.balance);
+    if (SavingsAccount* savings = dynamic_cast<SavingsAccount*>(account)) {
+        savings->setWithdrawalCount(state.monthlyCount);
+    } else if (CheckingAccount* checking = dynamic_cast<CheckingAccount*>(account)) {
+        checking->setTransactionCount(state.monthlyCount);
+    }
+}
+
+// Find an account that can take part in a transaction
+static Account* findActiveAccount(const Bank& bank, const string& accountNumber) {
+    Account* account = bank.findAccount(accountNumber);
+    if (account == nullptr) {
+        cout << "Account " << accountNumber << " not found." << endl;
+        return nullptr;
+    }
+    if (!account->isAccountActive()) {
+        cout << "Account " << accountNumber << " is not active." << endl;
+        return nullptr;
+    }
+    return account;
+}
+
+// Would this withdrawal or outgoing transfer break a configured limit?
+static bool withinLimits(TransactionManager& manager, const string& accountNumber, TransactionType type,
+                         double amount) {
+    LimitViolation violation = manager.getLimitEngine().check(accountNumber, type, amount);
+    if (violation == LimitViolation::NONE) {
+        return true;
+    }
+    cout << "Request refused for account " << accountNumber << ": " << limitViolationToString(violation)
+         << " exceeded." << endl;
+    return false;
+}
+
+// =============================================================================
+// TRANSACTION OPERATIONS
+// =============================================================================
+
+// Deposit money into an account
+bool Bank::deposit(string accountNumber, double amount, string description, string idempotencyKey) {
+    METRICS_TIME_SCOPE("Bank::deposit");
+    syncConfiguration();
+    if (alreadyCommitted(*transactionManager, idempotencyKey)) {
+        return true;
+    }
+    if (!isValidAmount(amount) || amount == 0.0) {
+        cout << "Invalid deposit amount." << endl;
+        return false;
+    }
+    Account* account = findActiveAccount(*this, accountNumber);
+    if (account == nullptr) {
+        return false;
+    }
+    configureAccount(account);
+
+    AccountState before = saveState(account);
+    double balanceBefore = before.balance;
+    account->deposit(amount);
+    double balanceAfter = account->getBalance();
+    string transactionId = transactionManager->processDeposit(accountNumber, amount, move(description),
+                                                              balanceBefore, balanceAfter,
+                                                              account->getCustomerId(), move(idempotencyKey));
+    if (transactionId.empty()) {
+        restoreState(account, before);
+        cout << "Deposit was not recorded; account restored." << endl;
+        return false;
+    }
+    totalDeposits += amount;
+    adjustTotalBalanceGauge(balanceAfter - balanceBefore);
+    return true;
+}
+
+// Withdraw money from an account
+bool Bank::withdraw(string accountNumber, double amount, string description, string idempotencyKey) {
+    METRICS_TIME_SCOPE("Bank::withdraw");
+    syncConfiguration();
+    if (alreadyCommitted(*transactionManager, idempotencyKey)) {
+        return true;
+    }
+    if (!isValidAmount(amount) || amount == 0.0) {
+        cout << "Invalid withdrawal amount." << endl;
+        return false;
+    }
+    Account* account = findActiveAccount(*this, accountNumber);
+    if (account == nullptr ||
+        !withinLimits(*transactionManager, accountNumber, TransactionType::WITHDRAWAL, amount)) {
+        return false;
+    }
+    configureAccount(account);
+
+    AccountState before = saveState(account);
+    double balanceBefore = before.balance;
+    if (!account->withdraw(amount)) {
+        return false;
+    }
+    double balanceAfter = account->getBalance();
+    string transactionId = transactionManager->processWithdrawal(accountNumber, amount, move(description),
+                                                                 balanceBefore, balanceAfter,
+                                                                 account->getCustomerId(), move(idempotencyKey));
+    if (transactionId.empty()) {
+        restoreState(account, before);
+        cout << "Withdrawal was not recorded; account restored." << endl;
+        return false;
+    }
+    totalWithdrawals += amount;
+    adjustTotalBalanceGauge(balanceAfter - balanceBefore);
+    return true;
+}
+
+// Move money between two accounts
+bool Bank::transfer(string fromAccount, string toAccount, double amount, string description,
+                    string idempotencyKey) {
+    METRICS_TIME_SCOPE("Bank::transfer");
+    syncConfiguration();
+    if (alreadyCommitted(*transactionManager, idempotencyKey)) {
+        return true;
+    }
+    if (!isValidAmount(amount) || amount == 0.0) {
+        cout << "Invalid transfer amount." << endl;
+        return false;
+    }
+    if (fromAccount == toAccount) {
+        cout << "Cannot transfer to the same account." << endl;
+        return false;
+    }
+    Account* source = findActiveAccount(*this, fromAccount);
+    Account* destination = findActiveAccount(*this, toAccount);
+    if (source == nullptr || destination == nullptr ||
+        !withinLimits(*transactionManager, fromAccount, TransactionType::TRANSFER_OUT, amount)) {
+        return false;
+    }
+    configureAccount(source);
+    configureAccount(destination);
+
+    AccountState sourceBefore = saveState(source);
+    AccountState destinationBefore = saveState(destination);
+    double fromBalBefore = sourceBefore.balance;
+    double toBalBefore = destinationBefore.balance;
+    if (!source->withdraw(amount)) {
+        return false;
+    }
+    destination->deposit(amount);
+    double fromBalAfter = source->getBalance();
+    double toBalAfter = destination->getBalance();
+    string transferOutId = transactionManager->processTransfer(fromAccount, toAccount, amount, move(description),
+                                                               fromBalBefore, fromBalAfter, toBalBefore, toBalAfter,
+                                                               source->getCustomerId(), move(idempotencyKey));
+    if (transferOutId.empty()) {
+        restoreState(source, sourceBefore);
+        restoreState(destination, destinationBefore);
+        cout << "Transfer was not recorded; accounts restored." << endl;
+        return false;
+    }
+    adjustTotalBalanceGauge((fromBalAfter - fromBalBefore) + (toBalAfter - toBalBefore));
+    return true;
+}
+
+// =============================================================================
+// TRANSACTION HISTORY
+// =============================================================================
+
+// Pin the current ledger version for a report or export
+shared_ptr<const LedgerSnapshot> Bank::getLedgerSnapshot() const {
+    return transactionManager->getSnapshot();
+}
+
+// =============================================================================
+// MONTH-END PROCESSING
+// =============================================================================
+
+// Charge checking fees, credit savings interest and reset the monthly counters
+MonthEndSummary Bank::runMonthEndProcessing(const MonthEndOptions& options) {
+    METRICS_TIME_SCOPE("Bank::runMonthEndProcessing");
+    syncConfiguration();
+    MonthEndOptions settings = options;
+    if (settings.monthlyFee < 0) {
+        settings.monthlyFee = getConfiguration()->monthlyMaintenanceFee;
+    }
+    vector<Account*> accountList;
+    accountList.reserve(accounts.size());
+    for (auto& pair : accounts) {
+        configureAccount(pair.second);
+        accountList.push_back(pair.second);
+    }
+    MonthEndProcessor processor(*transactionManager);
+    MonthEndSummary summary = processor.run(accountList, settings);
+    MonthEndProcessor::displaySummary(summary);
+    publishAccountGauges();
+    return summary;
+}
@@ -0,0 +1,298 @@
+#include "ConfigManager.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <charconv>
+#include <algorithm>
+
+using namespace std;
+
+// =============================================================================
+// PARSING
+// =============================================================================
+
+// Split a KEY=VALUE line (surrounding whitespace dropped); false for blanks and comments
+static bool splitSetting(const string& line, string& key, string& value) {
+    auto trim = [](const string& text) {
+        size_t first = text.find_first_not_of(" \t\r");
+        size_t last = text.find_last_not_of(" \t\r");
+        return first == string::npos ? string() : text.substr(first, last - first + 1);
+    };
+    string setting = trim(line);
+    size_t separator = setting.find('=');
+    if (setting.empty() || setting[0] == '#' || separator == string::npos) {
+        return false;
+    }
+    key = trim(setting.substr(0, separator));
+    value = trim(setting.substr(separator + 1));
+    return true;
+}
+
+// Non-negative number (amounts, rates)
+static bool parseAmount(const string& text, double& value) {
+    double parsed;
+    auto result = from_chars(text.data(), text.data() + text.size(), parsed);
+    if (result.ec != errc() || result.ptr != text.data() + text.size() || !(parsed >= 0.0)) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+// Non-negative whole number (counts, seconds, days)
+static bool parseCount(const string& text, int& value) {
+    int parsed;
+    auto result = from_chars(text.data(), text.data() + text.size(), parsed);
+    if (result.ec != errc() || result.ptr != text.data() + text.size() || parsed < 0) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+static bool parseFlag(const string& text, bool& value) {
+    string lower = text;
+    transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return tolower(c); });
+    if (lower == "true" || lower == "yes" || lower == "1") {
+        value = true;
+    } else if (lower == "false" || lower == "no" || lower == "0") {
+        value = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Byte count with an optional KB/MB/GB suffix
+static bool parseByteSize(const string& text, uint64_t& value) {
+    uint64_t parsed;
+    auto result = from_chars(text.data(), text.data() + text.size(), parsed);
+    if (result.ec != errc()) {
+        return false;
+    }
+    string suffix(result.ptr, text.data() + text.size());
+    transform(suffix.begin(), suffix.end(), suffix.begin(), [](unsigned char c) { return toupper(c); });
+    if (suffix == "KB") {
+        parsed <<= 10;
+    } else if (suffix == "MB") {
+        parsed <<= 20;
+    } else if (suffix == "GB") {
+        parsed <<= 30;
+    } else if (!suffix.empty() && suffix != "B") {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+// Read every KEY=VALUE line of a file, handing each to apply (which returns
+// false for a bad value); unknown keys are ignored
+template <typename Apply>
+static bool parseSettingsFile(const string& path, Apply apply) {
+    ifstream file(path);
+    if (!file.is_open()) {
+        cout << "Cannot open configuration file: " << path << endl;
+        return false;
+    }
+    bool valid = true;
+    string line, key, value;
+    int lineNumber = 0;
+    while (getline(file, line)) {
+        lineNumber++;
+        if (splitSetting(line, key, value) && !apply(key, value)) {
+            cout << path << ":" << lineNumber << ": invalid value for " << key << ": " << value << endl;
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+// Parse bank_config.txt
+bool ConfigManager::parseBankConfig(const string& path, BankConfig& config) {
+    return parseSettingsFile(path, [&config](const string& key, const string& value) {
+        LimitRules& limits = config.limits;
+        if (key == "MIN_SAVINGS_BALANCE") return parseAmount(value, config.minSavingsBalance);
+        if (key == "MIN_CHECKING_BALANCE") return parseAmount(value, config.minCheckingBalance);
+        if (key == "SAVINGS_INTEREST_RATE") return parseAmount(value, config.savingsInterestRate);
+        if (key == "LOAN_INTEREST_RATE") return parseAmount(value, config.loanInterestRate);
+        if (key == "MAX_DAILY_WITHDRAWAL") return parseAmount(value, limits.maxDailyWithdrawal);
+        if (key == "MAX_DAILY_WITHDRAWAL_COUNT") return parseCount(value, limits.maxDailyWithdrawalCount);
+        if (key == "MAX_TRANSFER_AMOUNT") return parseAmount(value, limits.maxTransferAmount);
+        if (key == "MAX_DAILY_TRANSFER") return parseAmount(value, limits.maxDailyTransfer);
+        if (key == "MAX_WITHDRAWAL_PER_MONTH") return parseCount(value, limits.maxWithdrawalsPerMonth);
+        if (key == "OVERDRAFT_LIMIT") return parseAmount(value, config.overdraftLimit);
+        if (key == "TRANSACTION_FEE") return parseAmount(value, config.transactionFee);
+        if (key == "MONTHLY_MAINTENANCE_FEE") return parseAmount(value, config.monthlyMaintenanceFee);
+        if (key == "FREE_TRANSACTIONS") return parseCount(value, config.freeTransactions);
+        if (key == "SESSION_TIMEOUT") return parseCount(value, config.sessionTimeoutSeconds);
+        if (key == "MAX_LOGIN_ATTEMPTS") return parseCount(value, config.maxLoginAttempts);
+        if (key == "BACKUP_INTERVAL") return parseCount(value, config.backupIntervalHours);
+        return true;
+    });
+}
+
+// Parse admin_settings.txt
+bool ConfigManager::parseAdminSettings(const string& path, BankConfig& config) {
+    return parseSettingsFile(path, [&config](const string& key, const string& value) {
+        if (key == "ADMIN_USERNAME") {
+            config.adminUsername = value;
+            return !value.empty();
+        }
+        if (key == "ADMIN_PASSWORD_HASH") {
+            config.adminPasswordHash = value;
+            return value.size() == 64 && value.find_first_not_of("0123456789abcdefABCDEF") == string::npos;
+        }
+        if (key == "PASSWORD_MIN_LENGTH") return parseCount(value, config.passwordMinLength);
+        if (key == "REQUIRE_SPECIAL_CHARS") return parseFlag(value, config.requireSpecialChars);
+        if (key == "SESSION_TIMEOUT") return parseCount(value, config.adminSessionTimeoutSeconds);
+        if (key == "AUTO_BACKUP") return parseFlag(value, config.autoBackup);
+        if (key == "LOG_RETENTION_DAYS") return parseCount(value, config.logRetentionDays);
+        if (key == "MAX_LOG_SIZE") return parseByteSize(value, config.maxLogSizeBytes);
+        return true;
+    });
+}
+
+// =============================================================================
+// LOADING
+// =============================================================================
+
+// Constructor (defaults are published until load() succeeds)
+ConfigManager::ConfigManager(string bankConfigFile, string adminSettingsFile)
+    : bankConfigPath(move(bankConfigFile)), adminSettingsPath(move(adminSettingsFile)),
+      snapshot(make_shared<const BankConfig>()), version(0), watchStopping(false) {
+}
+
+ConfigManager::~ConfigManager() {
+    stopWatching();
+}
+
+// Size and modification time of both files (changes when either is rewritten)
+string ConfigManager::getFileStamp() const {
+    stringstream stamp;
+    for (const string& path : {bankConfigPath, adminSettingsPath}) {
+        error_code error;
+        auto size = filesystem::file_size(path, error);
+        auto modified = filesystem::last_write_time(path, error);
+        if (error) {
+            stamp << "missing|";
+        } else {
+            stamp << size << ":" << modified.time_since_epoch().count() << "|";
+        }
+    }
+    return stamp.str();
+}
+
+// Parse both files and publish a new snapshot
+bool ConfigManager::load() {
+    static const size_t reloadCounter = Metrics::registerCounter("config.reloads");
+    static const size_t failureCounter = Metrics::registerCounter("config.reload_failures");
+    static const size_t versionGauge = Metrics::registerGauge("config.version");
+    lock_guard<mutex> lock(reloadMutex);
+    loadedStamp = getFileStamp(); // Taken first: a write during parsing shows up as another change
+    auto config = make_shared<BankConfig>();
+    bool bankValid = parseBankConfig(bankConfigPath, *config);
+    bool adminValid = parseAdminSettings(adminSettingsPath, *config);
+    if (!bankValid || !adminValid) {
+        Metrics::incrementCounter(failureCounter);
+        cout << "Configuration not loaded; keeping version " << version.load() << "." << endl;
+        return false;
+    }
+    config->version = version.load() + 1;
+    snapshot.store(config);
+    version.store(config->version);
+    Metrics::incrementCounter(reloadCounter);
+    Metrics::setGauge(versionGauge, static_cast<double>(config->version));
+    cout << "Configuration loaded (version " << config->version << ")." << endl;
+    return true;
+}
+
+// =============================================================================
+// WATCHING
+// =============================================================================
+
+// Start the watcher thread
+void ConfigManager::startWatching(chrono::milliseconds interval) {
+    if (watchThread.joinable()) {
+        return;
+    }
+    watchStopping = false;
+    watchThread = thread(&ConfigManager::watchLoop, this, interval);
+}
+
+// Stop the watcher thread
+void ConfigManager::stopWatching() {
+    if (!watchThread.joinable()) {
+        return;
+    }
+    {
+        lock_guard<mutex> lock(watchMutex);
+        watchStopping = true;
+    }
+    watchSignal.notify_all();
+    watchThread.join();
+}
+
+bool ConfigManager::isWatching() const {
+    return watchThread.joinable();
+}
+
+// Reload once a change has stayed put for a whole interval (so a file caught
+// mid-write is not loaded)
+void ConfigManager::watchLoop(chrono::milliseconds interval) {
+    Tracing::setThreadName("config watch");
+    string previousStamp;
+    unique_lock<mutex> lock(watchMutex);
+    while (!watchSignal.wait_for(lock, interval, [this] { return watchStopping; })) {
+        lock.unlock();
+        string stamp = getFileStamp();
+        bool changed;
+        {
+            lock_guard<mutex> reloadLock(reloadMutex);
+            changed = stamp != loadedStamp;
+        }
+        if (changed && stamp == previousStamp) {
+            load();
+        }
+        previousStamp = stamp;
+        lock.lock();
+    }
+}
+
+// =============================================================================
+// READING
+// =============================================================================
+
+// Current snapshot
+shared_ptr<const BankConfig> ConfigManager::get() const {
+    return snapshot.load();
+}
+
+uint64_t ConfigManager::getVersion() const {
+    return version.load(memory_order_acquire);
+}
+
+ConfigReader::ConfigReader(const ConfigManager& source) : manager(&source), cached(source.get()) {
+}
+
+// Current config, refreshed first if a reload has happened
+const BankConfig& ConfigReader::get() {
+    refresh();
+    return *cached;
+}
+
+// Snapshot picked up last (no version check)
+const BankConfig& ConfigReader::current() const {
+    return *cached;
+}
+
+// Pick up a newer snapshot (the version is published after the snapshot, so this one is at least as new)
+bool ConfigReader::refresh() {
+    if (manager->getVersion() == cached->version) {
+        return false;
+    }
+    cached = manager->get();
+    return true;
+}
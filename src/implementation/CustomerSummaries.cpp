@@ -0,0 +1,164 @@
+#include "CustomerSummaries.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+
+using namespace std;
+
+// =============================================================================
+// CUSTOMER SUMMARY
+// =============================================================================
+
+// Count a transaction in the totals and the recent ring
+void CustomerSummary::add(const Transaction& transaction) {
+    size_t type = static_cast<size_t>(transaction.getTransactionType());
+    if (type < TRANSACTION_TYPE_COUNT) {
+        RollupTotals& totals = typeTotals[type];
+        totals.count++;
+        totals.amount += transaction.getAmount();
+        totals.netAmount += transaction.getNetAmount();
+    }
+    addRecent({transaction.getTransactionId(), transaction.getTransactionType(), transaction.getAmount(),
+               transaction.getTimestamp().substr(0, 10)});
+}
+
+// Push onto the ring, overwriting the oldest entry once it is full
+void CustomerSummary::addRecent(RecentTransaction entry) {
+    recent[recentNext] = move(entry);
+    recentNext = (recentNext + 1) % RECENT_CAPACITY;
+    if (recentCount < RECENT_CAPACITY) {
+        recentCount++;
+    }
+}
+
+RollupTotals CustomerSummary::getTotal() const {
+    RollupTotals total;
+    for (const RollupTotals& totals : typeTotals) {
+        total.merge(totals);
+    }
+    return total;
+}
+
+// Most recent transactions, newest first
+vector<RecentTransaction> CustomerSummary::getRecent(size_t limit) const {
+    vector<RecentTransaction> entries;
+    for (size_t i = 1; i <= recentCount && entries.size() < limit; i++) {
+        entries.push_back(recent[(recentNext + RECENT_CAPACITY - i) % RECENT_CAPACITY]);
+    }
+    return entries;
+}
+
+// =============================================================================
+// CUSTOMER SUMMARIES
+// =============================================================================
+
+void CustomerSummaries::add(const Transaction& transaction) {
+    if (!transaction.getCustomerId().empty()) {
+        customers[transaction.getCustomerId()].add(transaction);
+    }
+}
+
+// Fold in summaries of older transactions (their recent rows go behind ours)
+void CustomerSummaries::merge(const CustomerSummaries& other) {
+    for (const auto& pair : other.customers) {
+        CustomerSummary& summary = customers[pair.first];
+        CustomerSummary combined = pair.second;
+        for (size_t type = 0; type < TRANSACTION_TYPE_COUNT; type++) {
+            combined.typeTotals[type].merge(summary.typeTotals[type]);
+        }
+        vector<RecentTransaction> newer = summary.getRecent();
+        for (auto it = newer.rbegin(); it != newer.rend(); ++it) {
+            combined.addRecent(*it);
+        }
+        summary = move(combined);
+    }
+}
+
+void CustomerSummaries::clear() {
+    customers.clear();
+}
+
+const CustomerSummary* CustomerSummaries::find(const string& customerId) const {
+    auto it = customers.find(customerId);
+    return it != customers.end() ? &it->second : nullptr;
+}
+
+size_t CustomerSummaries::size() const {
+    return customers.size();
+}
+
+// =============================================================================
+// PERSISTENCE
+// =============================================================================
+
+bool CustomerSummaries::save(const string& path) const {
+    string tempPath = path + ".tmp";
+    ofstream file(tempPath, ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << setprecision(17);
+    for (const auto& pair : customers) {
+        const CustomerSummary& summary = pair.second;
+        for (size_t type = 0; type < TRANSACTION_TYPE_COUNT; type++) {
+            const RollupTotals& totals = summary.typeTotals[type];
+            if (totals.count != 0) {
+                file << "T " << pair.first << ' ' << type << ' ' << totals.count << ' '
+                     << totals.amount << ' ' << totals.netAmount << '\n';
+            }
+        }
+        vector<RecentTransaction> entries = summary.getRecent();
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+            file << "R " << pair.first << ' ' << it->transactionId << ' ' << static_cast<int>(it->type) << ' '
+                 << it->amount << ' ' << it->date << '\n';
+        }
+    }
+    file.close();
+    error_code error;
+    if (file.fail()) {
+        filesystem::remove(tempPath, error); // Keep the previous file rather than a truncated one
+        return false;
+    }
+    filesystem::rename(tempPath, path, error);
+    return !error;
+}
+
+// Replace the contents with a saved file (false if it is missing or malformed)
+bool CustomerSummaries::load(const string& path) {
+    ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    clear();
+    string line;
+    while (getline(file, line)) {
+        istringstream fields(line);
+        string kind, customerId;
+        fields >> kind >> customerId;
+        bool valid = false;
+        if (kind == "T") {
+            size_t type = 0;
+            RollupTotals totals;
+            valid = static_cast<bool>(fields >> type >> totals.count >> totals.amount >> totals.netAmount) &&
+                    type < TRANSACTION_TYPE_COUNT;
+            if (valid) {
+                customers[customerId].typeTotals[type] = totals;
+            }
+        } else if (kind == "R") {
+            RecentTransaction entry;
+            int type = 0;
+            valid = static_cast<bool>(fields >> entry.transactionId >> type >> entry.amount >> entry.date) &&
+                    type >= 0 && static_cast<size_t>(type) < TRANSACTION_TYPE_COUNT;
+            if (valid) {
+                entry.type = static_cast<TransactionType>(type);
+                customers[customerId].addRecent(move(entry));
+            }
+        }
+        if (!valid) {
+            clear();
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,163 @@
+#include "IdempotencyTable.h"
+#include "Metrics.h"
+#include <functional>
+
+using namespace std;
+
+// Second hash for double hashing (derived from the first, so each key is hashed once)
+static size_t mixHash(size_t hash) {
+    uint64_t x = static_cast<uint64_t>(hash);
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return static_cast<size_t>(x) | 1;
+}
+
+// Constructor
+IdempotencyTable::IdempotencyTable(time_t ttl, size_t expectedKeys)
+    : ttlSeconds(ttl > 0 ? ttl : 1), currentFilter(0), filterRotatedAt(time(nullptr)) {
+    size_t bits = 64;
+    while (bits < expectedKeys * 10) {
+        bits <<= 1;
+    }
+    filterMask = bits - 1;
+    for (auto& filter : filters) {
+        filter.reset(new atomic<uint64_t>[bits / 64]);
+        for (size_t i = 0; i < bits / 64; i++) {
+            filter[i] = 0;
+        }
+    }
+}
+
+// =============================================================================
+// BLOOM FILTERS
+// =============================================================================
+
+bool IdempotencyTable::filterContains(size_t filter, size_t hash) const {
+    size_t step = mixHash(hash);
+    for (size_t i = 0; i < HASH_COUNT; i++) {
+        size_t bit = (hash + i * step) & filterMask;
+        if ((filters[filter][bit / 64].load(memory_order_relaxed) & (1ULL << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void IdempotencyTable::filterAdd(size_t filter, size_t hash) {
+    size_t step = mixHash(hash);
+    for (size_t i = 0; i < HASH_COUNT; i++) {
+        size_t bit = (hash + i * step) & filterMask;
+        filters[filter][bit / 64].fetch_or(1ULL << (bit % 64), memory_order_relaxed);
+    }
+}
+
+// Start a new generation once the current one is a TTL old; the cleared
+// filter only held keys that have expired by now
+void IdempotencyTable::rotateFiltersIfDue(time_t now) {
+    if (now - filterRotatedAt.load() < ttlSeconds) {
+        return;
+    }
+    lock_guard<mutex> lock(rotateMutex);
+    if (now - filterRotatedAt.load() < ttlSeconds) {
+        return; // Another thread rotated first
+    }
+    size_t next = 1 - currentFilter.load();
+    for (size_t i = 0; i <= filterMask / 64; i++) {
+        filters[next][i].store(0, memory_order_relaxed);
+    }
+    currentFilter = next;
+    filterRotatedAt = now;
+}
+
+// =============================================================================
+// LOOKUP AND INSERT
+// =============================================================================
+
+IdempotencyTable::Shard& IdempotencyTable::getShard(size_t hash) {
+    return shards[mixHash(hash) % SHARD_COUNT];
+}
+
+// Look up a key recorded within the TTL
+bool IdempotencyTable::find(const string& key, string& result) {
+    static const size_t bloomCounter = Metrics::registerCounter("idempotency.bloom_negatives");
+    static const size_t duplicateCounter = Metrics::registerCounter("idempotency.duplicates");
+    size_t hash = std::hash<string>()(key);
+    if (!filterContains(0, hash) && !filterContains(1, hash)) {
+        Metrics::incrementCounter(bloomCounter);
+        return false; // Never seen: no lock taken
+    }
+    Shard& shard = getShard(hash);
+    lock_guard<mutex> lock(shard.lock);
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end()) {
+        return false; // Bloom false positive
+    }
+    if (it->second.expiresAt <= time(nullptr)) {
+        shard.entries.erase(it);
+        return false;
+    }
+    result = it->second.result;
+    Metrics::incrementCounter(duplicateCounter);
+    return true;
+}
+
+// Record a key's result
+void IdempotencyTable::remember(const string& key, const string& result, time_t createdAt) {
+    time_t now = time(nullptr);
+    time_t expiresAt = createdAt + ttlSeconds;
+    if (expiresAt <= now) {
+        return; // Already expired (replaying an old record)
+    }
+    rotateFiltersIfDue(now);
+    size_t hash = std::hash<string>()(key);
+    Shard& shard = getShard(hash);
+    {
+        lock_guard<mutex> lock(shard.lock);
+        shard.entries[key] = Entry{result, expiresAt};
+        // Sweep once the shard has taken as many inserts as it holds entries (amortized O(1))
+        if (++shard.insertsSinceSweep >= max<size_t>(1024, shard.entries.size())) {
+            for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+                it = it->second.expiresAt <= now ? shard.entries.erase(it) : next(it);
+            }
+            shard.insertsSinceSweep = 0;
+        }
+    }
+    filterAdd(currentFilter.load(), hash); // After the entry exists, so a filter hit always finds it
+}
+
+// Forget one key (its filter bits stay set; find() treats them as a false positive)
+void IdempotencyTable::forget(const string& key) {
+    size_t hash = std::hash<string>()(key);
+    Shard& shard = getShard(hash);
+    lock_guard<mutex> lock(shard.lock);
+    shard.entries.erase(key);
+}
+
+// Forget every key
+void IdempotencyTable::clear() {
+    for (Shard& shard : shards) {
+        lock_guard<mutex> lock(shard.lock);
+        shard.entries.clear();
+        shard.insertsSinceSweep = 0;
+    }
+    lock_guard<mutex> lock(rotateMutex);
+    for (auto& filter : filters) {
+        for (size_t i = 0; i <= filterMask / 64; i++) {
+            filter[i].store(0, memory_order_relaxed);
+        }
+    }
+}
+
+size_t IdempotencyTable::size() {
+    size_t total = 0;
+    for (Shard& shard : shards) {
+        lock_guard<mutex> lock(shard.lock);
+        total += shard.entries.size();
+    }
+    return total;
+}
+
+time_t IdempotencyTable::getTtl() const {
+    return ttlSeconds;
+}
@@ -0,0 +1,643 @@
+#include "LedgerColumnar.h"
+#include <iostream>
+#include <cstring>
+#include <unordered_map>
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+
+using namespace std;
+
+// File magic written at both ends of a columnar ledger file
+static const char COLUMNAR_MAGIC[8] = {'B', 'L', 'C', 'O', 'L', '0', '0', '1'};
+
+// =============================================================================
+// BINARY ENCODING HELPERS
+// =============================================================================
+
+// Unsigned integer of the same size as T (doubles are stored by their bit pattern)
+template <typename T>
+using StorageBits = conditional_t<sizeof(T) == 8, uint64_t,
+                    conditional_t<sizeof(T) == 4, uint32_t,
+                    conditional_t<sizeof(T) == 2, uint16_t, uint8_t>>>;
+
+// Append a fixed-size value to a byte buffer (little-endian on every host)
+template <typename T>
+static void appendValue(string& buffer, T value) {
+    StorageBits<T> bits = bit_cast<StorageBits<T>>(value);
+    for (size_t i = 0; i < sizeof(T); i++) {
+        buffer.push_back(static_cast<char>((bits >> (8 * i)) & 0xFF));
+    }
+}
+
+// Decode a little-endian value
+template <typename T>
+static T decodeValue(const char* data) {
+    StorageBits<T> bits = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        bits |= static_cast<StorageBits<T>>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return bit_cast<T>(bits);
+}
+
+// Append an array of values (copied directly when the host is little-endian)
+template <typename T>
+static void appendValues(string& buffer, const T* values, size_t count) {
+    if constexpr (endian::native == endian::little) {
+        buffer.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            appendValue<T>(buffer, values[i]);
+        }
+    }
+}
+
+// Append an unsigned LEB128 varint
+static void appendVarint(string& buffer, uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+// Append a length-prefixed string to a byte buffer
+static void appendString(string& buffer, const string& value) {
+    appendValue<uint32_t>(buffer, static_cast<uint32_t>(value.size()));
+    buffer.append(value);
+}
+
+// Sequential reader over a byte buffer (bounds-checked)
+struct ByteCursor {
+    const char* data;
+    size_t size;
+    size_t position;
+    bool ok;
+
+    template <typename T>
+    T read() {
+        if (position + sizeof(T) > size) {
+            ok = false;
+            return T{};
+        }
+        T value = decodeValue<T>(data + position);
+        position += sizeof(T);
+        return value;
+    }
+
+    // Bytes left after the current position
+    size_t remaining() const {
+        return position < size ? size - position : 0;
+    }
+
+    uint64_t readVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (position >= size) {
+                break;
+            }
+            unsigned char byte = static_cast<unsigned char>(data[position++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    string readString() {
+        uint32_t length = read<uint32_t>();
+        if (!ok || position + length > size) {
+            ok = false;
+            return "";
+        }
+        string value(data + position, length);
+        position += length;
+        return value;
+    }
+};
+
+// Encode a string column as offsets + bytes, with a dictionary when values repeat
+static ColumnEncoding encodeOffsetStringColumn(const vector<string>& values, string& out) {
+    unordered_map<string, uint32_t> dictionary;
+    vector<const string*> entries;
+    vector<uint32_t> indices;
+    indices.reserve(values.size());
+    bool useDictionary = true;
+    for (const string& value : values) {
+        auto inserted = dictionary.emplace(value, static_cast<uint32_t>(entries.size()));
+        if (inserted.second) {
+            entries.push_back(&inserted.first->first);
+            if (entries.size() > values.size() / 2 + 1) {
+                useDictionary = false; // Mostly unique values: dictionary would not pay off
+                break;
+            }
+        }
+        indices.push_back(inserted.first->second);
+    }
+
+    const vector<const string*>* strings = &entries;
+    vector<const string*> plainStrings;
+    if (!useDictionary) {
+        plainStrings.reserve(values.size());
+        for (const string& value : values) {
+            plainStrings.push_back(&value);
+        }
+        strings = &plainStrings;
+    }
+
+    // Offsets then bytes (shared by the plain layout and the dictionary entries)
+    if (useDictionary) {
+        appendValue<uint32_t>(out, static_cast<uint32_t>(entries.size()));
+    }
+    uint32_t offset = 0;
+    appendValue<uint32_t>(out, offset);
+    for (const string* value : *strings) {
+        offset += static_cast<uint32_t>(value->size());
+        appendValue<uint32_t>(out, offset);
+    }
+    for (const string* value : *strings) {
+        out.append(*value);
+    }
+    if (useDictionary) {
+        appendValues(out, indices.data(), indices.size());
+        return ColumnEncoding::DICTIONARY;
+    }
+    return ColumnEncoding::PLAIN;
+}
+
+// Front-code a string column: each value as the length it shares with the previous one plus the rest
+static void encodePrefixStringColumn(const vector<string>& values, string& out) {
+    const string* previous = nullptr;
+    for (const string& value : values) {
+        size_t shared = 0;
+        if (previous != nullptr) {
+            size_t limit = min(previous->size(), value.size());
+            while (shared < limit && (*previous)[shared] == value[shared]) {
+                shared++;
+            }
+        }
+        appendVarint(out, shared);
+        appendVarint(out, value.size() - shared);
+        out.append(value, shared, string::npos);
+        previous = &value;
+    }
+}
+
+// Encode a string column in whichever encoding is smallest
+static ColumnEncoding encodeStringColumn(const vector<string>& values, string& out) {
+    string offsetEncoded, prefixEncoded;
+    ColumnEncoding encoding = encodeOffsetStringColumn(values, offsetEncoded);
+    encodePrefixStringColumn(values, prefixEncoded);
+    if (prefixEncoded.size() < offsetEncoded.size()) {
+        out.append(prefixEncoded);
+        return ColumnEncoding::PREFIX;
+    }
+    out.append(offsetEncoded);
+    return encoding;
+}
+
+// =============================================================================
+// SCHEMA
+// =============================================================================
+
+// Get column name
+string ColumnarLedgerReader::getColumnName(LedgerColumn column) {
+    switch (column) {
+        case LedgerColumn::TRANSACTION_ID: return "transaction_id";
+        case LedgerColumn::ACCOUNT_NUMBER: return "account_number";
+        case LedgerColumn::RELATED_ACCOUNT: return "related_account";
+        case LedgerColumn::TRANSACTION_TYPE: return "transaction_type";
+        case LedgerColumn::AMOUNT: return "amount";
+        case LedgerColumn::BALANCE_BEFORE: return "balance_before";
+        case LedgerColumn::BALANCE_AFTER: return "balance_after";
+        case LedgerColumn::TIMESTAMP: return "timestamp";
+        case LedgerColumn::DESCRIPTION: return "description";
+        case LedgerColumn::STATUS: return "status";
+        case LedgerColumn::CUSTOMER_ID: return "customer_id";
+        case LedgerColumn::SESSION_ID: return "session_id";
+        case LedgerColumn::NOTES: return "notes";
+    }
+    return "unknown";
+}
+
+// Get column physical type
+ColumnType ColumnarLedgerReader::getColumnType(LedgerColumn column) {
+    switch (column) {
+        case LedgerColumn::AMOUNT:
+        case LedgerColumn::BALANCE_BEFORE:
+        case LedgerColumn::BALANCE_AFTER:
+            return ColumnType::FLOAT64;
+        case LedgerColumn::TRANSACTION_TYPE:
+        case LedgerColumn::STATUS:
+            return ColumnType::UINT8;
+        default:
+            return ColumnType::STRING;
+    }
+}
+
+// =============================================================================
+// WRITER IMPLEMENTATIONS
+// =============================================================================
+
+// Constructor
+ColumnarLedgerWriter::ColumnarLedgerWriter(size_t rowsPerGroup) {
+    rowGroupSize = rowsPerGroup == 0 ? 1 : rowsPerGroup;
+}
+
+// Write one row group: materialize each column, encode it and record its statistics
+void ColumnarLedgerWriter::writeRowGroup(ofstream& file, const vector<const Transaction*>& rows,
+                                         size_t begin, size_t end, RowGroupInfo& info) const {
+    size_t count = end - begin;
+    info.rowCount = count;
+    info.columns.assign(LEDGER_COLUMN_COUNT, ColumnChunkInfo());
+
+    string chunk;
+    vector<double> doubles(count);
+    vector<uint8_t> bytes(count);
+    vector<string> strings(count);
+
+    for (size_t c = 0; c < LEDGER_COLUMN_COUNT; c++) {
+        LedgerColumn column = static_cast<LedgerColumn>(c);
+        ColumnChunkInfo& chunkInfo = info.columns[c];
+        chunk.clear();
+
+        switch (ColumnarLedgerReader::getColumnType(column)) {
+            case ColumnType::FLOAT64: {
+                for (size_t i = 0; i < count; i++) {
+                    const Transaction& txn = *rows[begin + i];
+                    doubles[i] = column == LedgerColumn::AMOUNT ? txn.getAmount()
+                               : column == LedgerColumn::BALANCE_BEFORE ? txn.getBalanceBefore()
+                               : txn.getBalanceAfter();
+                }
+                auto range = minmax_element(doubles.begin(), doubles.end());
+                chunkInfo.minValue = count ? *range.first : 0.0;
+                chunkInfo.maxValue = count ? *range.second : 0.0;
+                appendValues(chunk, doubles.data(), count);
+                break;
+            }
+            case ColumnType::UINT8: {
+                for (size_t i = 0; i < count; i++) {
+                    const Transaction& txn = *rows[begin + i];
+                    bytes[i] = static_cast<uint8_t>(column == LedgerColumn::TRANSACTION_TYPE
+                                                        ? static_cast<int>(txn.getTransactionType())
+                                                        : static_cast<int>(txn.getStatus()));
+                }
+                auto range = minmax_element(bytes.begin(), bytes.end());
+                chunkInfo.minValue = count ? *range.first : 0;
+                chunkInfo.maxValue = count ? *range.second : 0;
+                chunk.append(reinterpret_cast<const char*>(bytes.data()), count);
+                break;
+            }
+            case ColumnType::STRING: {
+                for (size_t i = 0; i < count; i++) {
+                    const Transaction& txn = *rows[begin + i];
+                    switch (column) {
+                        case LedgerColumn::TRANSACTION_ID: strings[i] = txn.getTransactionId(); break;
+                        case LedgerColumn::ACCOUNT_NUMBER: strings[i] = txn.getAccountNumber(); break;
+                        case LedgerColumn::RELATED_ACCOUNT: strings[i] = txn.getRelatedAccountNumber(); break;
+                        case LedgerColumn::TIMESTAMP: strings[i] = txn.getTimestamp(); break;
+                        case LedgerColumn::DESCRIPTION: strings[i] = txn.getDescription(); break;
+                        case LedgerColumn::CUSTOMER_ID: strings[i] = txn.getCustomerId(); break;
+                        case LedgerColumn::SESSION_ID: strings[i] = txn.getSessionId(); break;
+                        default: strings[i] = txn.getNotes(); break;
+                    }
+                }
+                auto range = minmax_element(strings.begin(), strings.end());
+                chunkInfo.minString = count ? *range.first : "";
+                chunkInfo.maxString = count ? *range.second : "";
+                chunkInfo.encoding = encodeStringColumn(strings, chunk);
+                break;
+            }
+        }
+
+        chunkInfo.offset = static_cast<uint64_t>(file.tellp());
+        chunkInfo.length = chunk.size();
+        file.write(chunk.data(), chunk.size());
+    }
+}
+
+// Write rows to a columnar file
+bool ColumnarLedgerWriter::write(const string& filename, const vector<const Transaction*>& rows) const {
+    ofstream file(filename, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        cout << "Failed to open columnar export file: " << filename << endl;
+        return false;
+    }
+    file.write(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+
+    vector<RowGroupInfo> rowGroups;
+    for (size_t begin = 0; begin < rows.size(); begin += rowGroupSize) {
+        size_t end = min(rows.size(), begin + rowGroupSize);
+        rowGroups.emplace_back();
+        writeRowGroup(file, rows, begin, end, rowGroups.back());
+    }
+
+    // Footer: schema, then row group / column chunk metadata
+    string footer;
+    appendValue<uint32_t>(footer, static_cast<uint32_t>(LEDGER_COLUMN_COUNT));
+    for (size_t c = 0; c < LEDGER_COLUMN_COUNT; c++) {
+        LedgerColumn column = static_cast<LedgerColumn>(c);
+        appendValue<uint8_t>(footer, static_cast<uint8_t>(ColumnarLedgerReader::getColumnType(column)));
+        appendString(footer, ColumnarLedgerReader::getColumnName(column));
+    }
+    appendValue<uint32_t>(footer, static_cast<uint32_t>(rowGroups.size()));
+    for (const RowGroupInfo& rowGroup : rowGroups) {
+        appendValue<uint64_t>(footer, rowGroup.rowCount);
+        for (size_t c = 0; c < LEDGER_COLUMN_COUNT; c++) {
+            const ColumnChunkInfo& chunkInfo = rowGroup.columns[c];
+            appendValue<uint64_t>(footer, chunkInfo.offset);
+            appendValue<uint64_t>(footer, chunkInfo.length);
+            appendValue<uint8_t>(footer, static_cast<uint8_t>(chunkInfo.encoding));
+            if (ColumnarLedgerReader::getColumnType(static_cast<LedgerColumn>(c)) == ColumnType::STRING) {
+                appendString(footer, chunkInfo.minString);
+                appendString(footer, chunkInfo.maxString);
+            } else {
+                appendValue<double>(footer, chunkInfo.minValue);
+                appendValue<double>(footer, chunkInfo.maxValue);
+            }
+        }
+    }
+    appendValue<uint64_t>(footer, footer.size());
+    file.write(footer.data(), footer.size());
+    file.write(COLUMNAR_MAGIC, sizeof(COLUMNAR_MAGIC));
+
+    file.close();
+    if (file.fail()) {
+        cout << "Failed to write columnar export file: " << filename << endl;
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// READER IMPLEMENTATIONS
+// =============================================================================
+
+// Constructor
+ColumnarLedgerReader::ColumnarLedgerReader(const string& path) {
+    filename = path;
+    valid = false;
+    file.open(path, ios::binary);
+    if (!file.is_open()) {
+        cout << "Failed to open columnar file: " << path << endl;
+        return;
+    }
+
+    // Trailer: footer size followed by the magic
+    char magic[sizeof(COLUMNAR_MAGIC)];
+    char sizeBytes[sizeof(uint64_t)];
+    uint64_t footerSize = 0;
+    file.seekg(0, ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    if (fileSize < 2 * sizeof(COLUMNAR_MAGIC) + sizeof(footerSize)) {
+        cout << "Invalid columnar file (too small): " << path << endl;
+        return;
+    }
+    file.seekg(fileSize - sizeof(COLUMNAR_MAGIC) - sizeof(footerSize));
+    file.read(sizeBytes, sizeof(sizeBytes));
+    file.read(magic, sizeof(magic));
+    footerSize = decodeValue<uint64_t>(sizeBytes);
+    if (!file || memcmp(magic, COLUMNAR_MAGIC, sizeof(magic)) != 0 ||
+        footerSize > fileSize - 2 * sizeof(COLUMNAR_MAGIC) - sizeof(footerSize)) {
+        cout << "Invalid columnar file (bad trailer): " << path << endl;
+        return;
+    }
+
+    vector<char> footer(footerSize);
+    uint64_t footerStart = fileSize - sizeof(COLUMNAR_MAGIC) - sizeof(footerSize) - footerSize;
+    file.seekg(footerStart);
+    file.read(footer.data(), footerSize);
+    ByteCursor cursor{footer.data(), footer.size(), 0, static_cast<bool>(file)};
+
+    uint32_t columnCount = cursor.read<uint32_t>();
+    if (!cursor.ok || columnCount != LEDGER_COLUMN_COUNT) {
+        cout << "Invalid columnar file (unexpected schema): " << path << endl;
+        return;
+    }
+    for (uint32_t c = 0; c < columnCount; c++) {
+        uint8_t type = cursor.read<uint8_t>();
+        string name = cursor.readString();
+        LedgerColumn column = static_cast<LedgerColumn>(c);
+        if (type != static_cast<uint8_t>(getColumnType(column)) || name != getColumnName(column)) {
+            cout << "Invalid columnar file (unexpected column " << name << "): " << path << endl;
+            return;
+        }
+    }
+    uint32_t rowGroupCount = cursor.read<uint32_t>();
+    for (uint32_t g = 0; g < rowGroupCount && cursor.ok; g++) {
+        RowGroupInfo rowGroup;
+        rowGroup.rowCount = cursor.read<uint64_t>();
+        rowGroup.columns.resize(LEDGER_COLUMN_COUNT);
+        for (size_t c = 0; c < LEDGER_COLUMN_COUNT; c++) {
+            ColumnChunkInfo& chunkInfo = rowGroup.columns[c];
+            chunkInfo.offset = cursor.read<uint64_t>();
+            chunkInfo.length = cursor.read<uint64_t>();
+            if (chunkInfo.offset < sizeof(COLUMNAR_MAGIC) || chunkInfo.offset > footerStart ||
+                chunkInfo.length > footerStart - chunkInfo.offset) {
+                cursor.ok = false; // Chunk outside the data section
+            }
+            uint8_t encoding = cursor.read<uint8_t>();
+            if (encoding > static_cast<uint8_t>(ColumnEncoding::PREFIX)) {
+                cursor.ok = false;
+            }
+            chunkInfo.encoding = static_cast<ColumnEncoding>(encoding);
+            if (getColumnType(static_cast<LedgerColumn>(c)) == ColumnType::STRING) {
+                chunkInfo.minString = cursor.readString();
+                chunkInfo.maxString = cursor.readString();
+            } else {
+                chunkInfo.minValue = cursor.read<double>();
+                chunkInfo.maxValue = cursor.read<double>();
+            }
+        }
+        rowGroups.push_back(move(rowGroup));
+    }
+    if (!cursor.ok) {
+        cout << "Invalid columnar file (truncated footer): " << path << endl;
+        rowGroups.clear();
+        return;
+    }
+    valid = true;
+}
+
+// Check whether the file was opened and its footer parsed
+bool ColumnarLedgerReader::isValid() const {
+    return valid;
+}
+
+// Get total number of rows
+uint64_t ColumnarLedgerReader::getRowCount() const {
+    uint64_t total = 0;
+    for (const RowGroupInfo& rowGroup : rowGroups) {
+        total += rowGroup.rowCount;
+    }
+    return total;
+}
+
+// Get number of row groups
+size_t ColumnarLedgerReader::getRowGroupCount() const {
+    return rowGroups.size();
+}
+
+// Get row group metadata (statistics and chunk locations)
+const RowGroupInfo& ColumnarLedgerReader::getRowGroup(size_t rowGroup) const {
+    return rowGroups.at(rowGroup);
+}
+
+// Read the raw bytes of one column chunk
+bool ColumnarLedgerReader::readChunk(size_t rowGroup, LedgerColumn column, vector<char>& buffer) const {
+    if (!valid || rowGroup >= rowGroups.size()) {
+        return false;
+    }
+    const ColumnChunkInfo& chunkInfo = rowGroups[rowGroup].columns[static_cast<size_t>(column)];
+    buffer.resize(chunkInfo.length);
+    file.clear();
+    file.seekg(chunkInfo.offset);
+    file.read(buffer.data(), chunkInfo.length);
+    return static_cast<bool>(file);
+}
+
+// Read a FLOAT64 column
+bool ColumnarLedgerReader::readDoubleColumn(size_t rowGroup, LedgerColumn column, vector<double>& values) const {
+    vector<char> buffer;
+    if (getColumnType(column) != ColumnType::FLOAT64 || !readChunk(rowGroup, column, buffer)) {
+        return false;
+    }
+    size_t count = rowGroups[rowGroup].rowCount;
+    if (buffer.size() % sizeof(double) != 0 || buffer.size() / sizeof(double) != count) {
+        return false;
+    }
+    values.resize(count);
+    if constexpr (endian::native == endian::little) {
+        memcpy(values.data(), buffer.data(), buffer.size());
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            values[i] = decodeValue<double>(buffer.data() + i * sizeof(double));
+        }
+    }
+    return true;
+}
+
+// Read a UINT8 column
+bool ColumnarLedgerReader::readByteColumn(size_t rowGroup, LedgerColumn column, vector<uint8_t>& values) const {
+    vector<char> buffer;
+    if (getColumnType(column) != ColumnType::UINT8 || !readChunk(rowGroup, column, buffer)) {
+        return false;
+    }
+    size_t count = rowGroups[rowGroup].rowCount;
+    if (buffer.size() != count) {
+        return false;
+    }
+    values.assign(buffer.begin(), buffer.end());
+    return true;
+}
+
+// Read a STRING column (plain, dictionary or prefix encoded)
+bool ColumnarLedgerReader::readStringColumn(size_t rowGroup, LedgerColumn column, vector<string>& values) const {
+    vector<char> buffer;
+    if (getColumnType(column) != ColumnType::STRING || !readChunk(rowGroup, column, buffer)) {
+        return false;
+    }
+    size_t count = rowGroups[rowGroup].rowCount;
+    ByteCursor cursor{buffer.data(), buffer.size(), 0, true};
+    ColumnEncoding encoding = rowGroups[rowGroup].columns[static_cast<size_t>(column)].encoding;
+    if (encoding == ColumnEncoding::PREFIX) {
+        // Every row takes at least two bytes, which bounds the count before allocating
+        if (count > buffer.size() / 2) {
+            return false;
+        }
+        values.assign(count, string());
+        for (size_t i = 0; i < count; i++) {
+            uint64_t shared = cursor.readVarint();
+            uint64_t suffix = cursor.readVarint();
+            if (!cursor.ok || (i == 0 ? shared != 0 : shared > values[i - 1].size()) || suffix > cursor.remaining()) {
+                return false;
+            }
+            if (shared > 0) {
+                values[i].assign(values[i - 1], 0, shared);
+            }
+            values[i].append(buffer.data() + cursor.position, suffix);
+            cursor.position += suffix;
+        }
+        return true;
+    }
+    bool dictionary = encoding == ColumnEncoding::DICTIONARY;
+
+    // Offsets table followed by the string bytes; counts are checked against
+    // the chunk size before anything is allocated for them
+    size_t entries = dictionary ? cursor.read<uint32_t>() : count;
+    size_t words = cursor.remaining() / sizeof(uint32_t);
+    if (!cursor.ok || entries > count || count > words || entries + 1 + (dictionary ? count : 0) > words) {
+        return false;
+    }
+    vector<uint32_t> offsets(entries + 1);
+    for (size_t i = 0; i <= entries; i++) {
+        offsets[i] = cursor.read<uint32_t>();
+    }
+    size_t bytesStart = cursor.position;
+    if (!cursor.ok || bytesStart + offsets[entries] > buffer.size()) {
+        return false;
+    }
+    vector<string> strings(entries);
+    for (size_t i = 0; i < entries; i++) {
+        if (offsets[i] > offsets[i + 1] || offsets[i + 1] > offsets[entries]) {
+            return false;
+        }
+        strings[i].assign(buffer.data() + bytesStart + offsets[i], offsets[i + 1] - offsets[i]);
+    }
+    if (!dictionary) {
+        values = move(strings);
+        return true;
+    }
+
+    cursor.position = bytesStart + offsets[entries];
+    values.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t index = cursor.read<uint32_t>();
+        if (!cursor.ok || index >= entries) {
+            return false;
+        }
+        values[i] = strings[index];
+    }
+    return true;
+}
+
+// Rebuild full transactions for one row group
+bool ColumnarLedgerReader::readTransactions(size_t rowGroup, vector<Transaction>& transactions) const {
+    vector<string> ids, accounts, related, timestamps, descriptions, customers, sessions, notes;
+    vector<double> amounts, before, after;
+    vector<uint8_t> types, statuses;
+    bool ok = readStringColumn(rowGroup, LedgerColumn::TRANSACTION_ID, ids) &&
+              readStringColumn(rowGroup, LedgerColumn::ACCOUNT_NUMBER, accounts) &&
+              readStringColumn(rowGroup, LedgerColumn::RELATED_ACCOUNT, related) &&
+              readByteColumn(rowGroup, LedgerColumn::TRANSACTION_TYPE, types) &&
+              readDoubleColumn(rowGroup, LedgerColumn::AMOUNT, amounts) &&
+              readDoubleColumn(rowGroup, LedgerColumn::BALANCE_BEFORE, before) &&
+              readDoubleColumn(rowGroup, LedgerColumn::BALANCE_AFTER, after) &&
+              readStringColumn(rowGroup, LedgerColumn::TIMESTAMP, timestamps) &&
+              readStringColumn(rowGroup, LedgerColumn::DESCRIPTION, descriptions) &&
+              readByteColumn(rowGroup, LedgerColumn::STATUS, statuses) &&
+              readStringColumn(rowGroup, LedgerColumn::CUSTOMER_ID, customers) &&
+              readStringColumn(rowGroup, LedgerColumn::SESSION_ID, sessions) &&
+              readStringColumn(rowGroup, LedgerColumn::NOTES, notes);
+    if (!ok) {
+        cout << "Failed to read row group " << rowGroup << " from columnar file: " << filename << endl;
+        return false;
+    }
+    size_t count = ids.size();
+    for (size_t i = 0; i < count; i++) {
+        if (types[i] >= TRANSACTION_TYPE_COUNT || statuses[i] >= TRANSACTION_STATUS_COUNT) {
+            cout << "Invalid transaction type or status in row group " << rowGroup
+                 << " of columnar file: " << filename << endl;
+            return false;
+        }
+    }
+    transactions.reserve(transactions.size() + count);
+    for (size_t i = 0; i < count; i++) {
+        transactions.emplace_back(ids[i], accounts[i], related[i], static_cast<TransactionType>(types[i]),
+                                  amounts[i], timestamps[i], descriptions[i], before[i], after[i],
+                                  static_cast<TransactionStatus>(statuses[i]), customers[i], sessions[i], notes[i]);
+    }
+    return true;
+}
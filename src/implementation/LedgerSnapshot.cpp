@@ -0,0 +1,143 @@
+#include "LedgerSnapshot.h"
+#include "Tracing.h"
+#include <algorithm>
+
+using namespace std;
+
+// =============================================================================
+// CHUNKS
+// =============================================================================
+
+// Find an account's rows, indexing the chunk on first use
+const vector<uint32_t>* LedgerChunk::findAccountRows(const string& accountNumber) const {
+    call_once(accountIndexBuilt, [this] {
+        for (size_t i = 0; i < rows.size(); i++) {
+            accountRows[rows[i].getAccountNumber()].push_back(static_cast<uint32_t>(i));
+        }
+    });
+    auto it = accountRows.find(accountNumber);
+    return it != accountRows.end() ? &it->second : nullptr;
+}
+
+// =============================================================================
+// SNAPSHOT
+// =============================================================================
+
+// Constructor
+LedgerSnapshot::LedgerSnapshot(uint64_t ledgerVersion, vector<shared_ptr<const LedgerChunk>> ledgerChunks)
+    : version(ledgerVersion), rowCount(0), chunks(move(ledgerChunks)) {
+    for (const shared_ptr<const LedgerChunk>& chunk : chunks) {
+        rowCount += chunk->rows.size();
+    }
+}
+
+// =============================================================================
+// GETTERS
+// =============================================================================
+
+uint64_t LedgerSnapshot::getVersion() const {
+    return version;
+}
+
+size_t LedgerSnapshot::size() const {
+    return rowCount;
+}
+
+const vector<shared_ptr<const LedgerChunk>>& LedgerSnapshot::getChunks() const {
+    return chunks;
+}
+
+// =============================================================================
+// QUERIES
+// =============================================================================
+
+// Find a transaction by ID (binary search on the chunks, then within one)
+const Transaction* LedgerSnapshot::findTransaction(const string& transactionId) const {
+    auto chunk = upper_bound(chunks.begin(), chunks.end(), transactionId,
+                             [](const string& id, const shared_ptr<const LedgerChunk>& candidate) {
+                                 return id < candidate->rows.front().getTransactionId();
+                             });
+    if (chunk == chunks.begin()) {
+        return nullptr;
+    }
+    const vector<Transaction>& rows = (*--chunk)->rows;
+    auto row = lower_bound(rows.begin(), rows.end(), transactionId,
+                           [](const Transaction& candidate, const string& id) {
+                               return candidate.getTransactionId() < id;
+                           });
+    return row != rows.end() && row->getTransactionId() == transactionId ? &*row : nullptr;
+}
+
+// Get an account's transactions, newest first (one index lookup per chunk,
+// then only the account's own rows)
+vector<Transaction> LedgerSnapshot::getAccountHistory(const string& accountNumber, int limit) const {
+    TraceSpan span("query.snapshot_account_history", "query");
+    vector<const Transaction*> matches;
+    for (const shared_ptr<const LedgerChunk>& chunk : chunks) {
+        const vector<uint32_t>* positions = chunk->findAccountRows(accountNumber);
+        if (positions == nullptr) {
+            continue;
+        }
+        for (uint32_t position : *positions) {
+            matches.push_back(&chunk->rows[position]);
+        }
+    }
+    size_t count = min(matches.size(), static_cast<size_t>(max(limit, 0)));
+    partial_sort(matches.begin(), matches.begin() + count, matches.end(),
+                 [](const Transaction* a, const Transaction* b) {
+                     return a->getTimestamp() > b->getTimestamp(); // Newest first
+                 });
+    vector<Transaction> history;
+    history.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        history.push_back(*matches[i]);
+    }
+    return history;
+}
+
+// Get transactions whose date falls in [startDate, endDate], newest first
+vector<Transaction> LedgerSnapshot::getTransactionsByDateRange(const string& startDate, const string& endDate) const {
+    TraceSpan span("query.snapshot_date_range", "query");
+    vector<Transaction> result;
+    forEach([&](const Transaction& transaction) {
+        string date = transaction.getTimestamp().substr(0, 10);
+        if (date >= startDate && date <= endDate) {
+            result.push_back(transaction);
+        }
+    });
+    sort(result.begin(), result.end(), [](const Transaction& a, const Transaction& b) {
+        return a.getTimestamp() > b.getTimestamp(); // Newest first
+    });
+    return result;
+}
+
+// Get the latest completed balance recorded for every account
+map<string, double> LedgerSnapshot::getLastKnownBalances() const {
+    map<string, const Transaction*> latest;
+    forEach([&](const Transaction& transaction) {
+        if (transaction.getStatus() != TransactionStatus::COMPLETED) {
+            return;
+        }
+        const Transaction*& current = latest[transaction.getAccountNumber()];
+        if (current == nullptr || current->getTimestamp() < transaction.getTimestamp() ||
+            (current->getTimestamp() == transaction.getTimestamp() &&
+             current->getTransactionId() < transaction.getTransactionId())) {
+            current = &transaction;
+        }
+    });
+    map<string, double> balances;
+    for (const auto& pair : latest) {
+        balances[pair.first] = pair.second->getBalanceAfter();
+    }
+    return balances;
+}
+
+// Compute ledger-wide aggregates
+TransactionStatistics LedgerSnapshot::computeStatistics() const {
+    TraceSpan span("statistics.snapshot", "query");
+    TransactionStatistics statistics;
+    forEach([&](const Transaction& transaction) {
+        statistics.add(transaction);
+    });
+    return statistics;
+}
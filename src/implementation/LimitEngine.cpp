@@ -0,0 +1,162 @@
+#include "LimitEngine.h"
+#include "Utilities.h"
+#include "Metrics.h"
+#include <algorithm>
+
+using namespace std;
+
+// =============================================================================
+// VIOLATIONS
+// =============================================================================
+
+string limitViolationToString(LimitViolation violation) {
+    switch (violation) {
+        case LimitViolation::NONE: return "None";
+        case LimitViolation::DAILY_WITHDRAWAL_AMOUNT: return "Daily withdrawal amount limit";
+        case LimitViolation::DAILY_WITHDRAWAL_COUNT: return "Daily withdrawal count limit";
+        case LimitViolation::TRANSFER_AMOUNT: return "Transfer amount limit";
+        case LimitViolation::DAILY_TRANSFER_AMOUNT: return "Daily transfer amount limit";
+        default: return "Unknown";
+    }
+}
+
+// =============================================================================
+// SLIDING WINDOW
+// =============================================================================
+
+SlidingWindow::SlidingWindow(size_t bucketCount, time_t seconds)
+    : buckets(bucketCount > 0 ? bucketCount : 1), bucketSeconds(seconds > 0 ? seconds : 1),
+      newestBucket(time(nullptr) / bucketSeconds), count(0), amount(0.0) {
+}
+
+// Move the window forward to end at bucket, clearing the buckets it leaves behind
+void SlidingWindow::advance(int64_t bucket) {
+    if (bucket <= newestBucket) {
+        return;
+    }
+    int64_t size = static_cast<int64_t>(buckets.size());
+    if (bucket - newestBucket >= size) {
+        fill(buckets.begin(), buckets.end(), Bucket());
+        count = 0;
+        amount = 0.0;
+    } else {
+        for (int64_t b = newestBucket + 1; b <= bucket; b++) {
+            Bucket& expired = buckets[b % size];
+            count -= expired.count;
+            amount -= expired.amount;
+            expired = Bucket();
+        }
+    }
+    newestBucket = bucket;
+}
+
+void SlidingWindow::add(time_t when, int64_t eventCount, double eventAmount) {
+    int64_t bucket = when / bucketSeconds;
+    advance(bucket);
+    int64_t size = static_cast<int64_t>(buckets.size());
+    if (bucket <= newestBucket - size || bucket < 0) {
+        return; // Already outside the window
+    }
+    Bucket& target = buckets[bucket % size];
+    target.count += eventCount;
+    target.amount += eventAmount;
+    count += eventCount;
+    amount += eventAmount;
+}
+
+int64_t SlidingWindow::getCount(time_t now) {
+    advance(now / bucketSeconds);
+    return count;
+}
+
+double SlidingWindow::getAmount(time_t now) {
+    advance(now / bucketSeconds);
+    return amount;
+}
+
+// =============================================================================
+// LIMIT ENGINE
+// =============================================================================
+
+LimitEngine::AccountWindows::AccountWindows()
+    : withdrawals(DAY_BUCKETS, DAY_BUCKET_SECONDS), transfers(DAY_BUCKETS, DAY_BUCKET_SECONDS) {
+}
+
+LimitEngine::LimitEngine(const LimitRules& limitRules) : rules(limitRules) {
+}
+
+// Check a withdrawal or outgoing transfer against the account's windows
+LimitViolation LimitEngine::check(const string& accountNumber, TransactionType type, double amount, time_t now) {
+    static const size_t rejectionCounter = Metrics::registerCounter("limits.rejections");
+    const double epsilon = 1e-9; // Running sums are doubles
+    LimitViolation violation = LimitViolation::NONE;
+    auto it = accounts.find(accountNumber);
+    if (type == TransactionType::WITHDRAWAL) {
+        double withdrawn = it != accounts.end() ? it->second.withdrawals.getAmount(now) : 0.0;
+        int64_t withdrawals = it != accounts.end() ? it->second.withdrawals.getCount(now) : 0;
+        if (rules.maxDailyWithdrawal > 0 && withdrawn + amount > rules.maxDailyWithdrawal + epsilon) {
+            violation = LimitViolation::DAILY_WITHDRAWAL_AMOUNT;
+        } else if (rules.maxDailyWithdrawalCount > 0 && withdrawals >= rules.maxDailyWithdrawalCount) {
+            violation = LimitViolation::DAILY_WITHDRAWAL_COUNT;
+        }
+    } else if (type == TransactionType::TRANSFER_OUT) {
+        double transferred = it != accounts.end() ? it->second.transfers.getAmount(now) : 0.0;
+        if (rules.maxTransferAmount > 0 && amount > rules.maxTransferAmount + epsilon) {
+            violation = LimitViolation::TRANSFER_AMOUNT;
+        } else if (rules.maxDailyTransfer > 0 && transferred + amount > rules.maxDailyTransfer + epsilon) {
+            violation = LimitViolation::DAILY_TRANSFER_AMOUNT;
+        }
+    }
+    if (violation != LimitViolation::NONE) {
+        Metrics::incrementCounter(rejectionCounter);
+    }
+    return violation;
+}
+
+// Only live or settled transactions use up a limit
+static bool countsTowardLimits(TransactionStatus status) {
+    return status == TransactionStatus::PENDING || status == TransactionStatus::COMPLETED;
+}
+
+// Add (direction 1) or remove (-1) a transaction at its original time
+void LimitEngine::apply(const Transaction& transaction, int direction) {
+    TransactionType type = transaction.getTransactionType();
+    if (type != TransactionType::WITHDRAWAL && type != TransactionType::TRANSFER_OUT) {
+        return;
+    }
+    time_t when = parseDateTime(transaction.getTimestamp());
+    if (when < 0) {
+        return;
+    }
+    AccountWindows& windows = accounts[transaction.getAccountNumber()];
+    SlidingWindow& window = type == TransactionType::WITHDRAWAL ? windows.withdrawals : windows.transfers;
+    window.add(when, direction, transaction.getAmount() * direction);
+}
+
+// Count a new transaction
+void LimitEngine::add(const Transaction& transaction) {
+    if (countsTowardLimits(transaction.getStatus())) {
+        apply(transaction, 1);
+    }
+}
+
+// Release (or take back) a transaction's share when its status changes
+void LimitEngine::changeStatus(const Transaction& transaction, TransactionStatus previousStatus) {
+    bool counted = countsTowardLimits(previousStatus);
+    bool counts = countsTowardLimits(transaction.getStatus());
+    if (counted != counts) {
+        apply(transaction, counts ? 1 : -1);
+    }
+}
+
+void LimitEngine::clear() {
+    accounts.clear();
+}
+
+const LimitRules& LimitEngine::getRules() const {
+    return rules;
+}
+
+void LimitEngine::setRules(const LimitRules& limitRules) {
+    rules = limitRules;
+}
@@ -0,0 +1,490 @@
+#include "Metrics.h"
+#include "Utilities.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include <memory>
+#include <limits>
+
+using namespace std;
+
+// =============================================================================
+// LATENCY HISTOGRAM
+// =============================================================================
+
+// Constructor
+LatencyHistogram::LatencyHistogram() {
+    clear();
+}
+
+// Forget everything recorded
+void LatencyHistogram::clear() {
+    for (atomic<uint64_t>& bucket : buckets) {
+        bucket.store(0, memory_order_relaxed);
+    }
+    count.store(0, memory_order_relaxed);
+    sum.store(0, memory_order_relaxed);
+    minimum.store(numeric_limits<uint64_t>::max(), memory_order_relaxed);
+    maximum.store(0, memory_order_relaxed);
+}
+
+// Map a value to its bucket
+size_t LatencyHistogram::bucketFor(uint64_t value) {
+    if (value < 128) {
+        return static_cast<size_t>(value);
+    }
+    int shift = (63 - __builtin_clzll(value)) - 6;     // Keep the top 7 bits
+    size_t bucket = 128 + static_cast<size_t>(shift - 1) * 64 + static_cast<size_t>((value >> shift) - 64);
+    return bucket < BUCKET_COUNT ? bucket : BUCKET_COUNT - 1;
+}
+
+// Largest value that maps to a bucket
+uint64_t LatencyHistogram::bucketUpperBound(size_t bucket) {
+    if (bucket < 128) {
+        return bucket;
+    }
+    int shift = static_cast<int>((bucket - 128) / 64) + 1;
+    uint64_t subBucket = (bucket - 128) % 64 + 64;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+// Record one value (single writer: plain load/store, no read-modify-write)
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    atomic<uint64_t>& bucket = buckets[bucketFor(nanoseconds)];
+    bucket.store(bucket.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    count.store(count.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    sum.store(sum.load(memory_order_relaxed) + nanoseconds, memory_order_relaxed);
+    if (nanoseconds < minimum.load(memory_order_relaxed)) {
+        minimum.store(nanoseconds, memory_order_relaxed);
+    }
+    if (nanoseconds > maximum.load(memory_order_relaxed)) {
+        maximum.store(nanoseconds, memory_order_relaxed);
+    }
+}
+
+// Add another histogram into this one
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        uint64_t value = other.buckets[i].load(memory_order_relaxed);
+        if (value != 0) {
+            buckets[i].store(buckets[i].load(memory_order_relaxed) + value, memory_order_relaxed);
+        }
+    }
+    count.store(getCount() + other.getCount(), memory_order_relaxed);
+    sum.store(getSum() + other.getSum(), memory_order_relaxed);
+    if (other.minimum.load(memory_order_relaxed) < minimum.load(memory_order_relaxed)) {
+        minimum.store(other.minimum.load(memory_order_relaxed), memory_order_relaxed);
+    }
+    if (other.getMax() > getMax()) {
+        maximum.store(other.getMax(), memory_order_relaxed);
+    }
+}
+
+// Get number of recorded values
+uint64_t LatencyHistogram::getCount() const {
+    return count.load(memory_order_relaxed);
+}
+
+// Get sum of recorded values
+uint64_t LatencyHistogram::getSum() const {
+    return sum.load(memory_order_relaxed);
+}
+
+// Get smallest recorded value
+uint64_t LatencyHistogram::getMin() const {
+    return getCount() == 0 ? 0 : minimum.load(memory_order_relaxed);
+}
+
+// Get largest recorded value
+uint64_t LatencyHistogram::getMax() const {
+    return maximum.load(memory_order_relaxed);
+}
+
+// Get a percentile (fraction in [0, 1]); reported as the bucket's upper bound, capped at the maximum
+uint64_t LatencyHistogram::getPercentile(double fraction) const {
+    uint64_t total = getCount();
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(fraction * total + 0.5);
+    target = target == 0 ? 1 : (target > total ? total : target);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i].load(memory_order_relaxed);
+        if (seen >= target) {
+            return min(bucketUpperBound(i), getMax());
+        }
+    }
+    return getMax();
+}
+
+// =============================================================================
+// PER-THREAD STORAGE
+// =============================================================================
+
+// One thread's histograms and counters (histograms are created on first use)
+struct ThreadMetrics {
+    array<atomic<LatencyHistogram*>, Metrics::MAX_METRICS> histograms;
+    array<atomic<uint64_t>, Metrics::MAX_METRICS> counters;
+
+    ThreadMetrics() {
+        for (size_t i = 0; i < Metrics::MAX_METRICS; i++) {
+            histograms[i].store(nullptr, memory_order_relaxed);
+            counters[i].store(0, memory_order_relaxed);
+        }
+    }
+
+    ~ThreadMetrics() {
+        for (atomic<LatencyHistogram*>& histogram : histograms) {
+            delete histogram.load(memory_order_relaxed);
+        }
+    }
+
+    // Fold another thread's data into this one (used when a thread has exited)
+    void absorb(const ThreadMetrics& other) {
+        for (size_t i = 0; i < Metrics::MAX_METRICS; i++) {
+            LatencyHistogram* theirs = other.histograms[i].load(memory_order_acquire);
+            if (theirs != nullptr) {
+                getHistogram(i).merge(*theirs);
+            }
+            uint64_t value = other.counters[i].load(memory_order_relaxed);
+            counters[i].store(counters[i].load(memory_order_relaxed) + value, memory_order_relaxed);
+        }
+    }
+
+    LatencyHistogram& getHistogram(size_t operation) {
+        LatencyHistogram* histogram = histograms[operation].load(memory_order_relaxed);
+        if (histogram == nullptr) {
+            histogram = new LatencyHistogram();
+            histograms[operation].store(histogram, memory_order_release); // Published to snapshot readers
+        }
+        return *histogram;
+    }
+};
+
+// Process-wide registry of metric names and per-thread storage
+struct MetricsRegistry {
+    mutex registryMutex;
+    vector<string> operationNames;
+    vector<string> counterNames;
+    vector<string> gaugeNames;
+    array<atomic<double>, Metrics::MAX_METRICS> gauges{};
+    vector<shared_ptr<ThreadMetrics>> threads;
+    ThreadMetrics retired;                      // Data from threads that have exited
+    atomic<bool> enabled{true};
+};
+
+// Get the registry (constructed on first use, never destroyed before its users)
+static MetricsRegistry& getRegistry() {
+    static MetricsRegistry* registry = new MetricsRegistry();
+    return *registry;
+}
+
+// Get the calling thread's storage (registered on first use)
+static ThreadMetrics& getThreadMetrics() {
+    thread_local shared_ptr<ThreadMetrics> local = [] {
+        shared_ptr<ThreadMetrics> metrics = make_shared<ThreadMetrics>();
+        MetricsRegistry& registry = getRegistry();
+        lock_guard<mutex> lock(registry.registryMutex);
+        registry.threads.push_back(metrics);
+        return metrics;
+    }();
+    return *local;
+}
+
+// Fold threads that have exited into the retired totals (registry lock held)
+static void foldRetiredThreads(MetricsRegistry& registry) {
+    vector<shared_ptr<ThreadMetrics>> live;
+    for (shared_ptr<ThreadMetrics>& metrics : registry.threads) {
+        if (metrics.use_count() == 1) {
+            registry.retired.absorb(*metrics); // Only the registry still holds it: no writer left
+        } else {
+            live.push_back(metrics);
+        }
+    }
+    registry.threads.swap(live);
+}
+
+// Find or add a name in a registration list (registry lock held)
+static size_t registerName(vector<string>& names, const string& name) {
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] == name) {
+            return i;
+        }
+    }
+    if (names.size() >= Metrics::MAX_METRICS) {
+        cout << "Metrics limit reached; \"" << name << "\" shares the last slot." << endl;
+        return Metrics::MAX_METRICS - 1;
+    }
+    names.push_back(name);
+    return names.size() - 1;
+}
+
+// =============================================================================
+// REGISTRATION AND RECORDING
+// =============================================================================
+
+// Register an operation histogram
+size_t Metrics::registerOperation(const string& name) {
+    MetricsRegistry& registry = getRegistry();
+    lock_guard<mutex> lock(registry.registryMutex);
+    return registerName(registry.operationNames, name);
+}
+
+// Register a counter
+size_t Metrics::registerCounter(const string& name) {
+    MetricsRegistry& registry = getRegistry();
+    lock_guard<mutex> lock(registry.registryMutex);
+    return registerName(registry.counterNames, name);
+}
+
+// Register a gauge
+size_t Metrics::registerGauge(const string& name) {
+    MetricsRegistry& registry = getRegistry();
+    lock_guard<mutex> lock(registry.registryMutex);
+    return registerName(registry.gaugeNames, name);
+}
+
+// Record a latency sample for the calling thread
+void Metrics::recordLatency(size_t operation, uint64_t nanoseconds) {
+    getThreadMetrics().getHistogram(operation).record(nanoseconds);
+}
+
+// Add to a counter for the calling thread
+void Metrics::incrementCounter(size_t counter, uint64_t delta) {
+    if (!isEnabled()) {
+        return;
+    }
+    atomic<uint64_t>& value = getThreadMetrics().counters[counter];
+    value.store(value.load(memory_order_relaxed) + delta, memory_order_relaxed);
+}
+
+// Set a gauge (gauges are shared, not per-thread: last writer wins)
+void Metrics::setGauge(size_t gauge, double value) {
+    getRegistry().gauges[gauge].store(value, memory_order_relaxed);
+}
+
+// Add to a gauge (negative to subtract)
+void Metrics::addGauge(size_t gauge, double delta) {
+    atomic<double>& value = getRegistry().gauges[gauge];
+    double current = value.load(memory_order_relaxed);
+    while (!value.compare_exchange_weak(current, current + delta, memory_order_relaxed)) {
+    }
+}
+
+// Turn recording on or off
+void Metrics::setEnabled(bool enabled) {
+    getRegistry().enabled.store(enabled, memory_order_relaxed);
+}
+
+// Check whether recording is on
+bool Metrics::isEnabled() {
+    return getRegistry().enabled.load(memory_order_relaxed);
+}
+
+// =============================================================================
+// SNAPSHOTS
+// =============================================================================
+
+// Merge every thread's histograms
+vector<OperationStats> Metrics::snapshotOperations() {
+    MetricsRegistry& registry = getRegistry();
+    lock_guard<mutex> lock(registry.registryMutex);
+    foldRetiredThreads(registry);
+    vector<OperationStats> result;
+    for (size_t i = 0; i < registry.operationNames.size(); i++) {
+        LatencyHistogram merged;
+        LatencyHistogram* retired = registry.retired.histograms[i].load(memory_order_acquire);
+        if (retired != nullptr) {
+            merged.merge(*retired);
+        }
+        for (const shared_ptr<ThreadMetrics>& metrics : registry.threads) {
+            LatencyHistogram* histogram = metrics->histograms[i].load(memory_order_acquire);
+            if (histogram != nullptr) {
+                merged.merge(*histogram);
+            }
+        }
+        if (merged.getCount() == 0) {
+            continue; // Registered but never called
+        }
+        OperationStats stats;
+        stats.name = registry.operationNames[i];
+        stats.count = merged.getCount();
+        stats.totalNanoseconds = merged.getSum();
+        stats.minNanoseconds = merged.getMin();
+        stats.maxNanoseconds = merged.getMax();
+        stats.p50 = merged.getPercentile(0.50);
+        stats.p90 = merged.getPercentile(0.90);
+        stats.p99 = merged.getPercentile(0.99);
+        stats.p999 = merged.getPercentile(0.999);
+        result.push_back(stats);
+    }
+    return result;
+}
+
+// Sum every thread's counters
+vector<CounterStats> Metrics::snapshotCounters() {
+    MetricsRegistry& registry = getRegistry();
+    lock_guard<mutex> lock(registry.registryMutex);
+    foldRetiredThreads(registry);
+    vector<CounterStats> result;
+    for (size_t i = 0; i < registry.counterNames.size(); i++) {
+        CounterStats stats;
+        stats.name = registry.counterNames[i];
+        stats.value = registry.retired.counters[i].load(memory_order_relaxed);
+        for (const shared_ptr<ThreadMetrics>& metrics : registry.threads) {
+            stats.value += metrics->counters[i].load(memory_order_relaxed);
+        }
+        result.push_back(stats);
+    }
+    return result;
+}
+
+// Read every gauge
+vector<GaugeStats> Metrics::snapshotGauges() {
+    MetricsRegistry& registry = getRegistry();
+    lock_guard<mutex> lock(registry.registryMutex);
+    vector<GaugeStats> result;
+    for (size_t i = 0; i < registry.gaugeNames.size(); i++) {
+        GaugeStats stats;
+        stats.name = registry.gaugeNames[i];
+        stats.value = registry.gauges[i].load(memory_order_relaxed);
+        result.push_back(stats);
+    }
+    return result;
+}
+
+// Drop recorded data
+void Metrics::reset() {
+    MetricsRegistry& registry = getRegistry();
+    lock_guard<mutex> lock(registry.registryMutex);
+    foldRetiredThreads(registry);
+    vector<ThreadMetrics*> all;
+    all.push_back(&registry.retired);
+    for (const shared_ptr<ThreadMetrics>& metrics : registry.threads) {
+        all.push_back(metrics.get());
+    }
+    for (ThreadMetrics* metrics : all) {
+        for (size_t i = 0; i < MAX_METRICS; i++) {
+            LatencyHistogram* histogram = metrics->histograms[i].load(memory_order_acquire);
+            if (histogram != nullptr) {
+                histogram->clear(); // Values recorded concurrently with the reset may be lost or kept
+            }
+            metrics->counters[i].store(0, memory_order_relaxed);
+        }
+    }
+}
+
+// =============================================================================
+// OUTPUT
+// =============================================================================
+
+// Format nanoseconds as microseconds
+static string formatMicros(uint64_t nanoseconds) {
+    stringstream ss;
+    ss << fixed << setprecision(1) << nanoseconds / 1000.0;
+    return ss.str();
+}
+
+// Display all operations and counters
+void Metrics::displayStatistics() {
+    vector<OperationStats> operations = snapshotOperations();
+    vector<CounterStats> counters = snapshotCounters();
+    vector<GaugeStats> gauges = snapshotGauges();
+    ios::fmtflags flags = cout.flags(); // Restored below: callers keep their own formatting
+    streamsize precision = cout.precision();
+    cout << "Operation Latency (microseconds):" << endl;
+    cout << left << setw(48) << "Operation" << right << setw(12) << "Count" << setw(12) << "Mean"
+         << setw(12) << "p50" << setw(12) << "p99" << setw(12) << "p99.9" << setw(12) << "Max" << endl;
+    cout << string(120, '-') << endl;
+    for (const OperationStats& stats : operations) {
+        cout << left << setw(48) << stats.name << right << setw(12) << stats.count
+             << setw(12) << formatMicros(stats.totalNanoseconds / stats.count)
+             << setw(12) << formatMicros(stats.p50) << setw(12) << formatMicros(stats.p99)
+             << setw(12) << formatMicros(stats.p999) << setw(12) << formatMicros(stats.maxNanoseconds) << endl;
+    }
+    if (!counters.empty()) {
+        cout << string(120, '-') << endl;
+        cout << "Counters:" << endl;
+        for (const CounterStats& stats : counters) {
+            cout << "  " << left << setw(46) << stats.name << right << setw(12) << stats.value << endl;
+        }
+    }
+    if (!gauges.empty()) {
+        cout << string(120, '-') << endl;
+        cout << "Gauges:" << endl;
+        for (const GaugeStats& stats : gauges) {
+            cout << "  " << left << setw(46) << stats.name << right << setw(12) << fixed << setprecision(0)
+                 << stats.value << endl;
+        }
+    }
+    cout.flags(flags);
+    cout.precision(precision);
+}
+
+// Write all operations and counters as JSON
+bool Metrics::writeStatisticsFile(const string& filename) {
+    vector<OperationStats> operations = snapshotOperations();
+    vector<CounterStats> counters = snapshotCounters();
+    vector<GaugeStats> gauges = snapshotGauges();
+    string tempPath = filename + ".tmp";
+    ofstream file(tempPath);
+    if (!file.is_open()) {
+        cout << "Failed to open statistics file: " << filename << endl;
+        return false;
+    }
+    file << "{\n  \"timestamp\": \"" << getCurrentDateTime() << "\",\n  \"operations\": [\n";
+    for (size_t i = 0; i < operations.size(); i++) {
+        const OperationStats& stats = operations[i];
+        file << "    {\"name\": \"" << stats.name << "\", \"count\": " << stats.count
+             << ", \"total_ns\": " << stats.totalNanoseconds << ", \"min_ns\": " << stats.minNanoseconds
+             << ", \"p50_ns\": " << stats.p50 << ", \"p90_ns\": " << stats.p90 << ", \"p99_ns\": " << stats.p99
+             << ", \"p999_ns\": " << stats.p999 << ", \"max_ns\": " << stats.maxNanoseconds << "}"
+             << (i + 1 < operations.size() ? "," : "") << "\n";
+    }
+    file << "  ],\n  \"counters\": {";
+    for (size_t i = 0; i < counters.size(); i++) {
+        file << (i == 0 ? "\n" : ",\n") << "    \"" << counters[i].name << "\": " << counters[i].value;
+    }
+    file << (counters.empty() ? "},\n" : "\n  },\n") << "  \"gauges\": {";
+    for (size_t i = 0; i < gauges.size(); i++) {
+        file << (i == 0 ? "\n" : ",\n") << "    \"" << gauges[i].name << "\": " << fixed << setprecision(2)
+             << gauges[i].value;
+    }
+    file << (gauges.empty() ? "}\n}\n" : "\n  }\n}\n");
+    file.close();
+    if (file.fail() || rename(tempPath.c_str(), filename.c_str()) != 0) {
+        cout << "Failed to write statistics file: " << filename << endl;
+        return false;
+    }
+    return true;
+}
+
+// =============================================================================
+// COUNTING MEMORY RESOURCE
+// =============================================================================
+
+// Constructor
+CountingMemoryResource::CountingMemoryResource(pmr::memory_resource* upstreamResource, const string& gaugeName)
+    : upstream(upstreamResource), gauge(Metrics::registerGauge(gaugeName)) {
+}
+
+// Allocate from upstream and count the bytes
+void* CountingMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+    void* pointer = upstream->allocate(bytes, alignment);
+    Metrics::addGauge(gauge, static_cast<double>(bytes));
+    return pointer;
+}
+
+// Return bytes to upstream
+void CountingMemoryResource::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+    upstream->deallocate(pointer, bytes, alignment);
+    Metrics::addGauge(gauge, -static_cast<double>(bytes));
+}
+
+// Equal only to itself (the counts are per instance)
+bool CountingMemoryResource::do_is_equal(const pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,213 @@
+#include "MetricsExporter.h"
+#include "Metrics.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+using namespace std;
+
+// =============================================================================
+// PROMETHEUS TEXT FORMAT
+// =============================================================================
+
+// Turn a registry name ("ledger.commits") into a metric name ("banking_ledger_commits")
+static string toMetricName(const string& name) {
+    string result = "banking_";
+    for (char c : name) {
+        result += isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(tolower(static_cast<unsigned char>(c))) : '_';
+    }
+    return result;
+}
+
+// Escape a label value
+static string escapeLabel(const string& value) {
+    string result;
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            result += '\\';
+            result += c;
+        } else if (c == '\n') {
+            result += "\\n";
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+// Render the current metrics
+string MetricsExporter::renderPrometheus() {
+    vector<OperationStats> operations = Metrics::snapshotOperations();
+    vector<CounterStats> counters = Metrics::snapshotCounters();
+    vector<GaugeStats> gauges = Metrics::snapshotGauges();
+    stringstream out;
+    out << setprecision(12);
+
+    if (!operations.empty()) {
+        const char* summary = "banking_operation_latency_seconds";
+        out << "# HELP " << summary << " Latency of instrumented operations.\n";
+        out << "# TYPE " << summary << " summary\n";
+        for (const OperationStats& stats : operations) {
+            string label = "operation=\"" + escapeLabel(stats.name) + "\"";
+            const pair<const char*, uint64_t> quantiles[] = {
+                {"0.5", stats.p50}, {"0.9", stats.p90}, {"0.99", stats.p99}, {"0.999", stats.p999}};
+            for (const auto& quantile : quantiles) {
+                out << summary << "{" << label << ",quantile=\"" << quantile.first << "\"} "
+                    << quantile.second / 1e9 << "\n";
+            }
+            out << summary << "_sum{" << label << "} " << stats.totalNanoseconds / 1e9 << "\n";
+            out << summary << "_count{" << label << "} " << stats.count << "\n";
+        }
+    }
+
+    for (const CounterStats& stats : counters) {
+        string name = toMetricName(stats.name) + "_total";
+        out << "# TYPE " << name << " counter\n";
+        out << name << " " << stats.value << "\n";
+    }
+
+    for (const GaugeStats& stats : gauges) {
+        string name = toMetricName(stats.name);
+        out << "# TYPE " << name << " gauge\n";
+        out << name << " " << stats.value << "\n";
+    }
+    return out.str();
+}
+
+// =============================================================================
+// HTTP SERVER
+// =============================================================================
+
+// Constructor
+MetricsExporter::MetricsExporter() : stopping(false), listenSocket(-1), port(0) {
+}
+
+// Destructor
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+// Open the listening socket and start serving
+bool MetricsExporter::start(int listenPort, const string& bindAddress) {
+    if (isRunning()) {
+        return true;
+    }
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(listenPort));
+    if (inet_pton(AF_INET, bindAddress.c_str(), &address.sin_addr) != 1) {
+        cout << "Invalid metrics bind address: " << bindAddress << endl;
+        return false;
+    }
+
+    listenSocket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenSocket < 0) {
+        cout << "Failed to create metrics socket: " << strerror(errno) << endl;
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (::bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenSocket, 16) != 0) {
+        cout << "Failed to listen for metrics on " << bindAddress << ":" << listenPort << ": "
+             << strerror(errno) << endl;
+        close(listenSocket);
+        listenSocket = -1;
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    getsockname(listenSocket, reinterpret_cast<sockaddr*>(&address), &length);
+    port = ntohs(address.sin_port);
+
+    stopping = false;
+    serverThread = thread(&MetricsExporter::serveLoop, this);
+    cout << "Metrics available at http://" << bindAddress << ":" << port << "/metrics" << endl;
+    return true;
+}
+
+// Stop serving and close the socket
+void MetricsExporter::stop() {
+    if (!serverThread.joinable()) {
+        return;
+    }
+    stopping = true;
+    serverThread.join();
+    close(listenSocket);
+    listenSocket = -1;
+}
+
+// Check whether the server thread is running
+bool MetricsExporter::isRunning() const {
+    return listenSocket >= 0;
+}
+
+// Get the port being served (useful after start(0))
+int MetricsExporter::getPort() const {
+    return port;
+}
+
+// Accept scrapes one at a time (wakes periodically to notice stop())
+void MetricsExporter::serveLoop() {
+    while (!stopping) {
+        pollfd listener = {listenSocket, POLLIN, 0};
+        if (poll(&listener, 1, 200) <= 0) {
+            continue; // Timeout or signal
+        }
+        int connection = accept4(listenSocket, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection < 0) {
+            continue;
+        }
+        timeval timeout = {1, 0}; // A stalled client cannot hold the exporter
+        setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        handleConnection(connection);
+        close(connection);
+    }
+}
+
+// Read one request and send the response
+void MetricsExporter::handleConnection(int connection) const {
+    string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == string::npos && request.size() < 8192) {
+        ssize_t received = recv(connection, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    string status = "200 OK";
+    string contentType = "text/plain; version=0.0.4; charset=utf-8";
+    string body;
+    size_t pathEnd = request.find_first_of(" ?\r\n", 4);
+    string path = request.size() > 4 ? request.substr(4, pathEnd == string::npos ? string::npos : pathEnd - 4) : "";
+    if (request.compare(0, 4, "GET ") == 0 && path == "/metrics") {
+        body = renderPrometheus();
+    } else if (request.compare(0, 4, "GET ") == 0) {
+        status = "404 Not Found";
+        body = "Only /metrics is served.\n";
+    } else {
+        status = "405 Method Not Allowed";
+        body = "Only GET is supported.\n";
+    }
+
+    string response = "HTTP/1.1 " + status + "\r\nContent-Type: " + contentType +
+                      "\r\nContent-Length: " + to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t written = send(connection, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return; // Client went away
+        }
+        sent += static_cast<size_t>(written);
+    }
+}
@@ -0,0 +1,192 @@
+#include "MonthEndProcessor.h"
+#include "ConfigManager.h"
+#include "Metrics.h"
+#include "Tracing.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <iterator>
+
+using namespace std;
+
+// =============================================================================
+// CONSTRUCTOR
+// =============================================================================
+
+// Constructor
+MonthEndProcessor::MonthEndProcessor(TransactionManager& txnManager) : transactionManager(txnManager) {
+}
+
+// =============================================================================
+// MONTH-END PROCESSING
+// =============================================================================
+
+// Compute one partition's fees and interest
+void MonthEndProcessor::processPartition(const vector<Account*>& accounts, size_t begin, size_t end,
+                                         const MonthEndOptions& options, MonthEndSummary& partial,
+                                         vector<LedgerEntry>& entries, vector<PendingChange>& changes) const {
+    for (size_t i = begin; i < end; i++) {
+        Account* account = accounts[i];
+        if (account == nullptr) {
+            continue;
+        }
+        partial.accountsProcessed++;
+
+        if (account->getAccountType() == AccountType::CHECKING) {
+            CheckingAccount* checking = static_cast<CheckingAccount*>(account);
+            if (options.chargeFees && checking->isAccountActive() && options.monthlyFee > 0) {
+                if (checking->getAvailableBalance() >= options.monthlyFee) {
+                    double before = checking->getBalance();
+                    double after = before - options.monthlyFee;
+                    entries.push_back({checking->getAccountNumber(), TransactionType::FEE_CHARGE,
+                                       options.monthlyFee, "Monthly maintenance fee", before, after,
+                                       checking->getCustomerId()});
+                    changes.push_back({checking, TransactionType::FEE_CHARGE, options.monthlyFee, after});
+                } else {
+                    partial.feesSkipped++;
+                }
+            }
+        } else if (account->getAccountType() == AccountType::SAVINGS) {
+            SavingsAccount* savings = static_cast<SavingsAccount*>(account);
+            if (options.applyInterest && savings->isAccountActive()) {
+                double interest = savings->calculateInterest();
+                if (interest > 0) {
+                    double before = savings->getBalance();
+                    double after = before + interest;
+                    entries.push_back({savings->getAccountNumber(), TransactionType::INTEREST_CREDIT,
+                                       interest, "Monthly interest credit", before, after,
+                                       savings->getCustomerId()});
+                    changes.push_back({savings, TransactionType::INTEREST_CREDIT, interest, after});
+                }
+            }
+        }
+    }
+}
+
+// Run all enabled month-end steps
+MonthEndSummary MonthEndProcessor::run(const vector<Account*>& accounts, const MonthEndOptions& requested) {
+    METRICS_TIME_SCOPE("MonthEndProcessor::run");
+    TraceSpan span("monthend.run", "batch");
+    auto startTime = chrono::steady_clock::now();
+    MonthEndOptions options = requested;
+    if (options.monthlyFee < 0) {
+        options.monthlyFee = BankConfig().monthlyMaintenanceFee; // No configuration given: its default
+    }
+    ThreadPool& pool = transactionManager.getWorkerPool();
+    size_t total = accounts.size();
+    size_t partitions = min(total, pool.getThreadCount());
+    if (partitions == 0) {
+        partitions = 1;
+    }
+
+    cout << "Starting month-end processing for " << total << " accounts on "
+         << pool.getThreadCount() << " threads..." << endl;
+
+    vector<MonthEndSummary> partials(partitions);
+    vector<vector<LedgerEntry>> partitionEntries(partitions);
+    vector<vector<PendingChange>> partitionChanges(partitions);
+    atomic<size_t> processed(0);
+    mutex progressMutex;
+
+    pool.parallelFor(total, [&](size_t begin, size_t end, size_t partition) {
+        TraceSpan partitionSpan("monthend.partition", "batch");
+        // Work in progress-interval slices so long partitions still report
+        size_t slice = options.progressInterval > 0 ? options.progressInterval : end - begin;
+        partitionEntries[partition].reserve(end - begin);
+        partitionChanges[partition].reserve(end - begin);
+        for (size_t sliceBegin = begin; sliceBegin < end; sliceBegin += slice) {
+            size_t sliceEnd = min(end, sliceBegin + slice);
+            processPartition(accounts, sliceBegin, sliceEnd, options, partials[partition],
+                             partitionEntries[partition], partitionChanges[partition]);
+            size_t done = processed.fetch_add(sliceEnd - sliceBegin) + (sliceEnd - sliceBegin);
+            if (options.progressInterval > 0) {
+                lock_guard<mutex> lock(progressMutex);
+                if (options.progressCallback) {
+                    options.progressCallback(done, total);
+                } else {
+                    cout << "Month-end progress: " << done << "/" << total << " accounts" << endl;
+                }
+            }
+        }
+    });
+
+    // Merge partition results in partition order so ledger IDs are deterministic
+    MonthEndSummary summary;
+    vector<LedgerEntry> entries;
+    vector<PendingChange> changes;
+    size_t entryCount = 0;
+    for (const auto& partitionEntry : partitionEntries) {
+        entryCount += partitionEntry.size();
+    }
+    entries.reserve(entryCount);
+    changes.reserve(entryCount);
+    for (size_t p = 0; p < partitions; p++) {
+        summary.accountsProcessed += partials[p].accountsProcessed;
+        summary.feesSkipped += partials[p].feesSkipped;
+        move(partitionEntries[p].begin(), partitionEntries[p].end(), back_inserter(entries));
+        move(partitionChanges[p].begin(), partitionChanges[p].end(), back_inserter(changes));
+    }
+
+    // Commit first, then move only the balances whose entries were recorded
+    vector<string> transactionIds = transactionManager.processBatch(move(entries));
+    for (size_t i = 0; i < changes.size(); i++) {
+        if (transactionIds[i].empty()) {
+            continue; // Not in the ledger, so the balance stays as it was
+        }
+        const PendingChange& change = changes[i];
+        change.account->updateBalance(change.balanceAfter);
+        summary.ledgerEntries++;
+        if (change.transactionType == TransactionType::FEE_CHARGE) {
+            summary.feesCharged++;
+            summary.totalFees += change.amount;
+        } else {
+            summary.interestCredits++;
+            summary.totalInterest += change.amount;
+        }
+    }
+
+    if (options.resetCounters) {
+        atomic<size_t> countersReset(0);
+        pool.parallelFor(total, [&](size_t begin, size_t end, size_t) {
+            size_t reset = 0;
+            for (size_t i = begin; i < end; i++) {
+                if (SavingsAccount* savings = dynamic_cast<SavingsAccount*>(accounts[i])) {
+                    savings->resetWithdrawalCount();
+                    reset++;
+                } else if (CheckingAccount* checking = dynamic_cast<CheckingAccount*>(accounts[i])) {
+                    checking->resetTransactionCount();
+                    reset++;
+                }
+            }
+            countersReset += reset;
+        });
+        summary.countersReset = countersReset;
+    }
+
+    summary.threadsUsed = partitions;
+    summary.elapsedSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    summary.accountsPerSecond = summary.elapsedSeconds > 0 ? summary.accountsProcessed / summary.elapsedSeconds : 0.0;
+    return summary;
+}
+
+// =============================================================================
+// DISPLAY FUNCTIONS
+// =============================================================================
+
+// Display month-end run summary
+void MonthEndProcessor::displaySummary(const MonthEndSummary& summary) {
+    cout << "\n=== Month-End Processing Summary ===" << endl;
+    cout << "Accounts Processed: " << summary.accountsProcessed << endl;
+    cout << "Fees Charged: " << summary.feesCharged << " ($" << fixed << setprecision(2) << summary.totalFees << ")" << endl;
+    cout << "Fees Skipped (insufficient funds): " << summary.feesSkipped << endl;
+    cout << "Interest Credits: " << summary.interestCredits << " ($" << fixed << setprecision(2) << summary.totalInterest << ")" << endl;
+    cout << "Counters Reset: " << summary.countersReset << endl;
+    cout << "Ledger Entries Recorded: " << summary.ledgerEntries << endl;
+    cout << "Threads Used: " << summary.threadsUsed << endl;
+    cout << "Elapsed Time: " << fixed << setprecision(3) << summary.elapsedSeconds << " s" << endl;
+    cout << "Throughput: " << fixed << setprecision(0) << summary.accountsPerSecond << " accounts/s" << endl;
+    cout << "====================================" << endl;
+}
@@ -0,0 +1,533 @@
+#include "RecoveryManager.h"
+#include "Tracing.h"
+#include "Metrics.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <filesystem>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+using namespace std;
+
+// =============================================================================
+// WAL RECORD FRAMING
+// =============================================================================
+
+// Each WAL line is "W <payload length> <CRC-32 of payload, hex> <payload>", so a
+// torn or partly overwritten tail fails the length or checksum check instead of
+// depending on how many fields happen to survive.
+static const char WAL_FRAME_TAG = 'W';
+
+// CRC-32 (IEEE 802.3, reflected) of a byte range
+static uint32_t crc32(const char* data, size_t size) {
+    static const auto table = [] {
+        array<uint32_t, 256> entries{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++) {
+                value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+            }
+            entries[i] = value;
+        }
+        return entries;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Wrap a Transaction record in a WAL frame (including the newline)
+static string frameWalRecord(const string& payload) {
+    char header[48];
+    int length = snprintf(header, sizeof(header), "%c %zu %08x ", WAL_FRAME_TAG, payload.size(),
+                          static_cast<unsigned>(crc32(payload.data(), payload.size())));
+    string frame;
+    frame.reserve(length + payload.size() + 1);
+    frame.append(header, length);
+    frame += payload;
+    frame += '\n';
+    return frame;
+}
+
+// Check a WAL line's frame and point payload at the record inside it
+static bool unframeWalRecord(const string& line, string& payload) {
+    unsigned long long size = 0;
+    unsigned checksum = 0;
+    int headerLength = 0;
+    char tag = 0;
+    if (sscanf(line.c_str(), "%c %llu %8x%n", &tag, &size, &checksum, &headerLength) != 3 ||
+        tag != WAL_FRAME_TAG || headerLength <= 0 || line.compare(headerLength++, 1, " ") != 0 ||
+        line.size() - headerLength != size) {
+        return false;
+    }
+    if (crc32(line.data() + headerLength, size) != checksum) {
+        return false;
+    }
+    payload.assign(line, headerLength, string::npos);
+    return true;
+}
+
+// =============================================================================
+// CONSTRUCTOR AND DESTRUCTOR
+// =============================================================================
+
+// Constructor
+RecoveryManager::RecoveryManager(string ledgerFile, RecoveryOptions recoveryOptions) {
+    ledgerPath = ledgerFile;
+    options = recoveryOptions;
+    walFile = nullptr;
+    walGeneration = 0;
+    commitsSinceCheckpoint = 0;
+    lastCheckpointTime = chrono::steady_clock::now();
+    replayedRecords = 0;
+    pendingGeneration = 0;
+    checkpointInProgress = false;
+    stopping = false;
+    appendedRecords = 0;
+    durableRecords = 0;
+    syncFailed = false;
+    syncStopping = false;
+    checkpointThread = thread(&RecoveryManager::checkpointLoop, this);
+    syncThread = thread(&RecoveryManager::syncLoop, this);
+}
+
+// Destructor
+RecoveryManager::~RecoveryManager() {
+    {
+        lock_guard<mutex> lock(syncMutex);
+        syncStopping = true; // Remaining waiters are still flushed and completed
+    }
+    syncSignal.notify_all();
+    syncThread.join();
+    waitForCheckpoint();
+    {
+        lock_guard<mutex> lock(checkpointMutex);
+        stopping = true;
+    }
+    checkpointSignal.notify_all();
+    checkpointThread.join();
+    if (walFile != nullptr) {
+        fflush(walFile);
+        fsync(fileno(walFile));
+        fclose(walFile);
+    }
+}
+
+// =============================================================================
+// FILE LAYOUT
+// =============================================================================
+
+// Get WAL file path for a generation
+string RecoveryManager::getWalPath(uint64_t generation) const {
+    stringstream ss;
+    ss << ledgerPath << ".wal." << setfill('0') << setw(6) << generation;
+    return ss.str();
+}
+
+// Get checkpoint file path
+string RecoveryManager::getCheckpointPath() const {
+    return ledgerPath + ".checkpoint";
+}
+
+// Find existing WAL generations (ascending)
+vector<uint64_t> RecoveryManager::findWalGenerations() const {
+    vector<uint64_t> generations;
+    filesystem::path ledger(ledgerPath);
+    filesystem::path directory = ledger.has_parent_path() ? ledger.parent_path() : filesystem::path(".");
+    string prefix = ledger.filename().string() + ".wal.";
+    error_code error;
+    for (const auto& entry : filesystem::directory_iterator(directory, error)) {
+        string name = entry.path().filename().string();
+        if (name.compare(0, prefix.size(), prefix) == 0 && name.size() > prefix.size()) {
+            generations.push_back(strtoull(name.c_str() + prefix.size(), nullptr, 10));
+        }
+    }
+    sort(generations.begin(), generations.end());
+    return generations;
+}
+
+// Open (append) the WAL file for a generation, closing the previous one
+bool RecoveryManager::openWal(uint64_t generation) {
+    lock_guard<mutex> lock(walMutex);
+    if (walFile != nullptr) {
+        fflush(walFile);
+        if (fsync(fileno(walFile)) != 0) { // Everything before the rotation is durable
+            reportSyncFailure(errno);
+        }
+        fclose(walFile);
+        walFile = nullptr;
+    }
+    walGeneration = generation;
+    walFile = fopen(getWalPath(generation).c_str(), "ab");
+    if (walFile == nullptr) {
+        cout << "Failed to open write-ahead log: " << getWalPath(generation) << endl;
+        return false;
+    }
+    fseek(walFile, 0, SEEK_END); // So ftell() gives the append offset before the first write
+    return true;
+}
+
+// =============================================================================
+// RECOVERY
+// =============================================================================
+
+// Load the last checkpoint and replay the WAL tail
+bool RecoveryManager::recover(TransactionMap& transactions) {
+    TraceSpan span("ledger.recover", "ledger");
+    bool found = false;
+    uint64_t checkpointGeneration = 0;
+    replayedRecords = 0;
+
+    ifstream checkpoint(getCheckpointPath(), ios::binary);
+    if (checkpoint.is_open()) {
+        string header, line;
+        size_t expected = 0;
+        getline(checkpoint, line);
+        istringstream iss(line);
+        iss >> header >> checkpointGeneration >> expected;
+        if (header != "CHECKPOINT") {
+            cout << "Ignoring unrecognised checkpoint file: " << getCheckpointPath() << endl;
+            checkpointGeneration = 0;
+        } else {
+            transactions.clear();
+            while (getline(checkpoint, line)) {
+                Transaction txn;
+                if (Transaction::fromRecord(line, txn)) {
+                    storeTransaction(transactions, move(txn));
+                }
+            }
+            found = true;
+            cout << "Loaded checkpoint with " << transactions.size() << " of " << expected
+                 << " transactions (WAL generation " << checkpointGeneration << ")." << endl;
+        }
+    }
+
+    // Replay every WAL generation the checkpoint does not already cover
+    vector<uint64_t> generations = findWalGenerations();
+    uint64_t lastGeneration = checkpointGeneration;
+    for (uint64_t generation : generations) {
+        lastGeneration = max(lastGeneration, generation);
+        if (generation < checkpointGeneration) {
+            continue; // Left behind by an interrupted cleanup
+        }
+        ifstream wal(getWalPath(generation), ios::binary);
+        string line, record;
+        bool framed = wal.peek() == WAL_FRAME_TAG; // Segments from older versions hold bare records
+        while (getline(wal, line)) {
+            Transaction txn;
+            if (framed ? !unframeWalRecord(line, record) || !Transaction::fromRecord(record, txn)
+                       : !Transaction::fromRecord(line, txn)) {
+                break; // Torn write at the tail: everything after it was never acknowledged
+            }
+            storeTransaction(transactions, move(txn));
+            replayedRecords++;
+        }
+        found = true;
+    }
+    if (found) {
+        cout << "Replayed " << replayedRecords << " WAL records from "
+             << generations.size() << " log segments." << endl;
+    }
+
+    openWal(lastGeneration + 1);
+    commitsSinceCheckpoint = replayedRecords;
+    return found;
+}
+
+// =============================================================================
+// COMMIT LOGGING
+// =============================================================================
+
+// Append a committed change to the WAL
+bool RecoveryManager::logCommit(const Transaction& transaction) {
+    if (walFile == nullptr) {
+        vector<uint64_t> generations = findWalGenerations();
+        uint64_t lastGeneration = generations.empty() ? walGeneration : max(walGeneration, generations.back());
+        if (!openWal(lastGeneration + 1)) {
+            return false;
+        }
+    }
+    string record = frameWalRecord(transaction.toRecord());
+    {
+        lock_guard<mutex> lock(walMutex);
+        long recordStart = ftell(walFile);
+        // fflush: survives a process crash
+        if (fwrite(record.data(), 1, record.size(), walFile) != record.size() || fflush(walFile) != 0) {
+            cout << "Failed to append to write-ahead log: " << strerror(errno) << endl;
+            abandonWalSegment(recordStart);
+            return false;
+        }
+        if (options.syncEveryCommit) {
+            METRICS_TIME_SCOPE("RecoveryManager::fsync");
+            if (fsync(fileno(walFile)) != 0) { // Survives a power loss
+                reportSyncFailure(errno);
+                abandonWalSegment(recordStart);
+                return false;
+            }
+        }
+        appendedRecords++;
+        if (options.syncEveryCommit && !syncFailed) {
+            durableRecords = appendedRecords.load();
+        }
+    }
+    static const size_t walBytesCounter = Metrics::registerCounter("wal.bytes_written");
+    Metrics::incrementCounter(walBytesCounter, record.size());
+    commitsSinceCheckpoint++;
+    return true;
+}
+
+// Drop a record that did not reach the WAL: cut the segment back to where it
+// started (fclose may still flush part of it) and leave the next commit to open
+// a fresh generation, so nothing is ever appended after a torn record. Called
+// with walMutex held.
+void RecoveryManager::abandonWalSegment(long recordStart) {
+    int descriptor = dup(fileno(walFile));
+    fclose(walFile);
+    walFile = nullptr;
+    if (descriptor < 0 || recordStart < 0 || ftruncate(descriptor, recordStart) != 0 ||
+        fsync(descriptor) != 0) {
+        reportSyncFailure(errno); // The failed record may survive, or earlier ones may not
+    }
+    if (descriptor >= 0) {
+        close(descriptor);
+    }
+}
+
+// Check whether a checkpoint should be started
+bool RecoveryManager::isCheckpointDue() const {
+    if (commitsSinceCheckpoint == 0) {
+        return false;
+    }
+    {
+        lock_guard<mutex> lock(checkpointMutex);
+        if (checkpointInProgress) {
+            return false; // Let the running checkpoint finish first
+        }
+    }
+    if (commitsSinceCheckpoint >= options.checkpointEveryTransactions) {
+        return true;
+    }
+    auto elapsed = chrono::steady_clock::now() - lastCheckpointTime;
+    return elapsed >= chrono::seconds(options.checkpointIntervalSeconds);
+}
+
+// =============================================================================
+// CHECKPOINTING
+// =============================================================================
+
+// Rotate the WAL and hand the snapshot to the checkpoint thread
+bool RecoveryManager::beginCheckpoint(shared_ptr<const LedgerSnapshot> snapshot) {
+    {
+        lock_guard<mutex> lock(checkpointMutex);
+        if (checkpointInProgress) {
+            return false; // Previous checkpoint still writing; try again on a later commit
+        }
+        checkpointInProgress = true;
+    }
+    // Changes from here on go to the new generation, which the checkpoint does not cover
+    if (!openWal(walGeneration + 1)) {
+        lock_guard<mutex> lock(checkpointMutex);
+        checkpointInProgress = false;
+        return false;
+    }
+    {
+        lock_guard<mutex> lock(checkpointMutex);
+        pendingSnapshot = move(snapshot);
+        pendingGeneration = walGeneration;
+    }
+    checkpointSignal.notify_all();
+    commitsSinceCheckpoint = 0;
+    lastCheckpointTime = chrono::steady_clock::now();
+    return true;
+}
+
+// Block until no checkpoint is being written
+void RecoveryManager::waitForCheckpoint() {
+    unique_lock<mutex> lock(checkpointMutex);
+    checkpointSignal.wait(lock, [this] { return !checkpointInProgress; });
+}
+
+// Checkpoint thread main loop
+void RecoveryManager::checkpointLoop() {
+    Tracing::setThreadName("checkpoint");
+    while (true) {
+        shared_ptr<const LedgerSnapshot> snapshot;
+        uint64_t generation = 0;
+        {
+            unique_lock<mutex> lock(checkpointMutex);
+            checkpointSignal.wait(lock, [this] { return stopping || pendingSnapshot != nullptr; });
+            if (pendingSnapshot == nullptr) {
+                return; // Stopping
+            }
+            snapshot = move(pendingSnapshot);
+            pendingSnapshot = nullptr;
+            generation = pendingGeneration;
+        }
+
+        if (writeCheckpoint(*snapshot, generation)) {
+            // The checkpoint now covers every older generation
+            error_code error;
+            for (uint64_t oldGeneration : findWalGenerations()) {
+                if (oldGeneration < generation) {
+                    filesystem::remove(getWalPath(oldGeneration), error);
+                }
+            }
+        } else {
+            cout << "Checkpoint failed; WAL segments kept for replay." << endl;
+        }
+
+        {
+            lock_guard<mutex> lock(checkpointMutex);
+            checkpointInProgress = false;
+        }
+        checkpointSignal.notify_all();
+    }
+}
+
+// Write a checkpoint file atomically (temp file, fsync, rename)
+bool RecoveryManager::writeCheckpoint(const LedgerSnapshot& snapshot, uint64_t generation) const {
+    TraceSpan span("checkpoint.write", "ledger");
+    string tempPath = getCheckpointPath() + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    string buffer = "CHECKPOINT " + to_string(generation) + " " + to_string(snapshot.size()) + "\n";
+    bool ok = true;
+    snapshot.forEach([&](const Transaction& txn) {
+        buffer += txn.toRecord();
+        buffer += '\n';
+        if (buffer.size() >= (1 << 20)) {
+            ok = ok && fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+            buffer.clear();
+        }
+    });
+    ok = ok && fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    ok = ok && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    fclose(file);
+    if (!ok) {
+        remove(tempPath.c_str());
+        return false;
+    }
+    return rename(tempPath.c_str(), getCheckpointPath().c_str()) == 0;
+}
+
+// =============================================================================
+// STATISTICS
+// =============================================================================
+
+// Get number of WAL records replayed by the last recover()
+size_t RecoveryManager::getReplayedRecordCount() const {
+    return replayedRecords;
+}
+
+// Get current WAL generation
+uint64_t RecoveryManager::getWalGeneration() const {
+    return walGeneration;
+}
+
+// =============================================================================
+// GROUP COMMIT
+// =============================================================================
+
+// Check whether every logged commit is on disk
+bool RecoveryManager::isDurable() const {
+    return !syncFailed && durableRecords.load() >= appendedRecords.load();
+}
+
+// Run done(true) once the commits logged so far are on disk (done(false) after a failed fsync)
+void RecoveryManager::whenDurable(function<void(bool)> done) {
+    uint64_t target = appendedRecords.load();
+    if (syncFailed) {
+        done(false);
+        return;
+    }
+    if (durableRecords.load() >= target) {
+        done(true);
+        return;
+    }
+    {
+        lock_guard<mutex> lock(syncMutex);
+        durabilityWaiters.emplace_back(target, move(done));
+    }
+    syncSignal.notify_one();
+}
+
+// Mark the WAL as no longer durable (reported once)
+void RecoveryManager::reportSyncFailure(int error) {
+    if (!syncFailed.exchange(true)) {
+        cout << "Write-ahead log fsync failed: " << strerror(error)
+             << "; commits are no longer reported durable." << endl;
+    }
+}
+
+// Sync thread main loop: one fsync covers every waiter registered before it started
+void RecoveryManager::syncLoop() {
+    Tracing::setThreadName("wal sync");
+    static const size_t groupCounter = Metrics::registerCounter("wal.group_commits");
+    while (true) {
+        {
+            unique_lock<mutex> lock(syncMutex);
+            syncSignal.wait(lock, [this] { return syncStopping || !durabilityWaiters.empty(); });
+            if (durabilityWaiters.empty()) {
+                return; // Stopping
+            }
+        }
+
+        // Flush outside walMutex (on a duplicate descriptor) so commits keep appending meanwhile;
+        // a rotation in between has already synced the older generation itself
+        uint64_t target;
+        int descriptor = -1;
+        int syncError = 0;
+        {
+            lock_guard<mutex> lock(walMutex);
+            target = appendedRecords.load();
+            if (walFile != nullptr) {
+                descriptor = dup(fileno(walFile));
+                syncError = descriptor < 0 ? errno : 0;
+            }
+        }
+        if (descriptor >= 0) {
+            TraceSpan span("wal.group_sync", "ledger");
+            METRICS_TIME_SCOPE("RecoveryManager::fsync");
+            if (fsync(descriptor) != 0) {
+                syncError = errno;
+            }
+            close(descriptor);
+        }
+        if (syncError != 0) {
+            reportSyncFailure(syncError);
+        }
+        bool synced = !syncFailed;
+        if (synced) {
+            uint64_t durable = durableRecords.load();
+            while (durable < target && !durableRecords.compare_exchange_weak(durable, target)) {
+            }
+        }
+        Metrics::incrementCounter(groupCounter);
+
+        vector<function<void(bool)>> ready;
+        {
+            lock_guard<mutex> lock(syncMutex);
+            auto pending = durabilityWaiters.begin();
+            for (auto it = durabilityWaiters.begin(); it != durabilityWaiters.end(); ++it) {
+                if (it->first <= target || !synced) {
+                    ready.push_back(move(it->second));
+                } else {
+                    *pending++ = move(*it);
+                }
+            }
+            durabilityWaiters.erase(pending, durabilityWaiters.end());
+        }
+        for (function<void(bool)>& done : ready) {
+            done(synced);
+        }
+    }
+}
@@ -0,0 +1,159 @@
+#include "ThreadPool.h"
+#include "Tracing.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+using namespace std;
+
+// =============================================================================
+// CONSTRUCTOR AND DESTRUCTOR
+// =============================================================================
+
+// Constructor
+ThreadPool::ThreadPool(size_t threadCount) {
+    activeTasks = 0;
+    stopping = false;
+    if (threadCount == 0) {
+        threadCount = getDefaultThreadCount();
+    }
+    workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+// Destructor
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// =============================================================================
+// TASK EXECUTION
+// =============================================================================
+
+// Gauge of tasks waiting in every pool's queue
+static size_t getQueueDepthGauge() {
+    static const size_t gauge = Metrics::registerGauge("pool.queued_tasks");
+    return gauge;
+}
+
+// Worker thread main loop
+void ThreadPool::workerLoop(size_t workerIndex) {
+    Tracing::setThreadName("worker " + to_string(workerIndex));
+    while (true) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(queueMutex);
+            taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (tasks.empty()) {
+                return; // Stopping and nothing left to run
+            }
+            task = move(tasks.front());
+            tasks.pop();
+            activeTasks++;
+            Metrics::addGauge(getQueueDepthGauge(), -1);
+        }
+        try {
+            task();
+        } catch (const exception& error) {
+            // Submitted tasks own their errors; keep the worker alive
+            cout << "Unhandled exception in worker task: " << error.what() << endl;
+        } catch (...) {
+            cout << "Unhandled exception in worker task." << endl;
+        }
+        {
+            lock_guard<mutex> lock(queueMutex);
+            activeTasks--;
+            if (tasks.empty() && activeTasks == 0) {
+                tasksFinished.notify_all();
+            }
+        }
+    }
+}
+
+// Queue a task for execution
+void ThreadPool::submit(function<void()> task) {
+    {
+        lock_guard<mutex> lock(queueMutex);
+        tasks.push(move(task));
+        Metrics::addGauge(getQueueDepthGauge(), 1);
+    }
+    taskAvailable.notify_one();
+}
+
+// Block until every queued task has finished
+void ThreadPool::waitForAll() {
+    unique_lock<mutex> lock(queueMutex);
+    tasksFinished.wait(lock, [this] { return tasks.empty() && activeTasks == 0; });
+}
+
+// Run body over [0, count) split into contiguous partitions
+void ThreadPool::parallelFor(size_t count, const function<void(size_t, size_t, size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    size_t partitions = min(count, workers.size());
+    if (partitions <= 1) {
+        body(0, count, 0); // Not worth a hand-off
+        return;
+    }
+
+    // Partitions complete independently of any other work queued on the pool
+    mutex doneMutex;
+    condition_variable doneSignal;
+    size_t remaining = partitions;
+    exception_ptr failure; // First exception thrown by body, rethrown to the caller
+
+    size_t chunk = count / partitions;
+    size_t extra = count % partitions;
+    size_t begin = 0;
+    for (size_t p = 0; p < partitions; p++) {
+        size_t end = begin + chunk + (p < extra ? 1 : 0);
+        submit([&, begin, end, p] {
+            exception_ptr error;
+            try {
+                body(begin, end, p);
+            } catch (...) {
+                error = current_exception();
+            }
+            lock_guard<mutex> lock(doneMutex);
+            if (error && !failure) {
+                failure = error;
+            }
+            if (--remaining == 0) {
+                doneSignal.notify_one();
+            }
+        });
+        begin = end;
+    }
+
+    unique_lock<mutex> lock(doneMutex);
+    doneSignal.wait(lock, [&] { return remaining == 0; });
+    if (failure) {
+        rethrow_exception(failure);
+    }
+}
+
+// =============================================================================
+// GETTER FUNCTIONS
+// =============================================================================
+
+// Get number of worker threads
+size_t ThreadPool::getThreadCount() const {
+    return workers.size();
+}
+
+// Get default worker count (one per hardware thread)
+size_t ThreadPool::getDefaultThreadCount() {
+    unsigned int hardwareThreads = thread::hardware_concurrency();
+    return hardwareThreads == 0 ? 1 : hardwareThreads;
+}
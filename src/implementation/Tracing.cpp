@@ -0,0 +1,211 @@
+#include "Tracing.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdio>
+
+using namespace std;
+
+// =============================================================================
+// PER-THREAD BUFFERS
+// =============================================================================
+
+// One completed span
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    int64_t beginNanoseconds;       // Since the trace epoch
+    int64_t durationNanoseconds;
+};
+
+// One thread's span buffer (the lock is only contended while a trace is being written)
+struct ThreadTrace {
+    mutex bufferMutex;
+    vector<TraceEvent> events;
+    string threadName;
+    size_t threadId = 0;
+    size_t dropped = 0;
+};
+
+// Process-wide list of thread buffers
+struct TraceRegistry {
+    mutex registryMutex;
+    vector<shared_ptr<ThreadTrace>> threads;
+    size_t nextThreadId = 1;
+    atomic<bool> enabled{false};
+    atomic<int64_t> epochNanoseconds{0};    // steady_clock time of start(); read by recordSpan without the lock
+};
+
+// steady_clock time as nanoseconds since the clock's own epoch
+static int64_t steadyNanoseconds(chrono::steady_clock::time_point time) {
+    return chrono::duration_cast<chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// Get the registry (constructed on first use, never destroyed before its users)
+static TraceRegistry& getTraceRegistry() {
+    static TraceRegistry* registry = new TraceRegistry();
+    return *registry;
+}
+
+// Get the calling thread's buffer (registered on first use; kept after the thread exits)
+static ThreadTrace& getThreadTrace() {
+    thread_local shared_ptr<ThreadTrace> local = [] {
+        shared_ptr<ThreadTrace> trace = make_shared<ThreadTrace>();
+        TraceRegistry& registry = getTraceRegistry();
+        lock_guard<mutex> lock(registry.registryMutex);
+        trace->threadId = registry.nextThreadId++;
+        trace->threadName = "thread " + to_string(trace->threadId);
+        registry.threads.push_back(trace);
+        return trace;
+    }();
+    return *local;
+}
+
+// =============================================================================
+// RECORDING
+// =============================================================================
+
+// Begin a new trace
+void Tracing::start() {
+    TraceRegistry& registry = getTraceRegistry();
+    {
+        lock_guard<mutex> lock(registry.registryMutex);
+        for (const shared_ptr<ThreadTrace>& trace : registry.threads) {
+            lock_guard<mutex> bufferLock(trace->bufferMutex);
+            trace->events.clear();
+            trace->dropped = 0;
+        }
+        registry.epochNanoseconds.store(steadyNanoseconds(chrono::steady_clock::now()), memory_order_relaxed);
+    }
+    registry.enabled.store(true, memory_order_release);
+}
+
+// Stop recording (recorded spans are kept until the next start)
+void Tracing::stop() {
+    getTraceRegistry().enabled.store(false, memory_order_release);
+}
+
+// Check whether spans are being recorded
+bool Tracing::isEnabled() {
+    return getTraceRegistry().enabled.load(memory_order_relaxed);
+}
+
+// Record a finished span
+void Tracing::recordSpan(const char* name, const char* category,
+                         chrono::steady_clock::time_point begin, chrono::steady_clock::time_point end) {
+    TraceRegistry& registry = getTraceRegistry();
+    ThreadTrace& trace = getThreadTrace();
+    lock_guard<mutex> lock(trace.bufferMutex);
+    if (trace.events.size() >= MAX_EVENTS_PER_THREAD) {
+        trace.dropped++;
+        return;
+    }
+    TraceEvent event;
+    event.name = name;
+    event.category = category;
+    event.beginNanoseconds = steadyNanoseconds(begin) - registry.epochNanoseconds.load(memory_order_relaxed);
+    event.durationNanoseconds = chrono::duration_cast<chrono::nanoseconds>(end - begin).count();
+    trace.events.push_back(event);
+}
+
+// Name the calling thread
+void Tracing::setThreadName(const string& name) {
+    ThreadTrace& trace = getThreadTrace();
+    lock_guard<mutex> lock(trace.bufferMutex);
+    trace.threadName = name;
+}
+
+// Get number of dropped spans
+size_t Tracing::getDroppedSpanCount() {
+    TraceRegistry& registry = getTraceRegistry();
+    lock_guard<mutex> lock(registry.registryMutex);
+    size_t dropped = 0;
+    for (const shared_ptr<ThreadTrace>& trace : registry.threads) {
+        lock_guard<mutex> bufferLock(trace->bufferMutex);
+        dropped += trace->dropped;
+    }
+    return dropped;
+}
+
+// =============================================================================
+// OUTPUT
+// =============================================================================
+
+// Append a JSON string literal
+static void appendJsonString(string& out, const string& text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += ' ';
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+// Append nanoseconds as fractional microseconds (the trace format's unit)
+static void appendMicros(string& out, int64_t nanoseconds) {
+    out += to_string(nanoseconds / 1000);
+    int64_t fraction = nanoseconds % 1000;
+    if (fraction != 0) {
+        string digits = to_string(fraction < 0 ? -fraction : fraction);
+        out += '.';
+        out.append(3 - digits.size(), '0');
+        out += digits;
+    }
+}
+
+// Write all spans as Chrome trace-event JSON ("X" complete events plus thread names)
+bool Tracing::writeChromeTrace(const string& filename) {
+    TraceRegistry& registry = getTraceRegistry();
+    string tempPath = filename + ".tmp";
+    ofstream file(tempPath, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+        cout << "Failed to open trace file: " << filename << endl;
+        return false;
+    }
+    string buffer = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    size_t spans = 0;
+    lock_guard<mutex> lock(registry.registryMutex);
+    for (const shared_ptr<ThreadTrace>& trace : registry.threads) {
+        lock_guard<mutex> bufferLock(trace->bufferMutex);
+        string tid = to_string(trace->threadId);
+        buffer += first ? "" : ",\n";
+        first = false;
+        buffer += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+        appendJsonString(buffer, trace->threadName);
+        buffer += "}}";
+        for (const TraceEvent& event : trace->events) {
+            buffer += ",\n{\"name\":";
+            appendJsonString(buffer, event.name);
+            buffer += ",\"cat\":";
+            appendJsonString(buffer, event.category);
+            buffer += ",\"ph\":\"X\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+            appendMicros(buffer, event.beginNanoseconds);
+            buffer += ",\"dur\":";
+            appendMicros(buffer, event.durationNanoseconds);
+            buffer += '}';
+            if (buffer.size() >= (1 << 20)) {
+                file.write(buffer.data(), buffer.size());
+                buffer.clear();
+            }
+        }
+        spans += trace->events.size();
+    }
+    buffer += "\n]}\n";
+    file.write(buffer.data(), buffer.size());
+    file.close();
+    if (file.fail() || rename(tempPath.c_str(), filename.c_str()) != 0) {
+        cout << "Failed to write trace file: " << filename << endl;
+        return false;
+    }
+    cout << "Trace with " << spans << " spans written to: " << filename << endl;
+    return true;
+}
@@ -1,13 +1,206 @@
 #include "Transaction.h"
 #include "Utilities.h"
+#include "ThreadPool.h"
+#include "LedgerColumnar.h"
+#include "TransactionArchive.h"
+#include "TransactionRollups.h"
+#include "CustomerSummaries.h"
+#include "IdempotencyTable.h"
+#include "LimitEngine.h"
+#include "BackupManager.h"
+#include "RecoveryManager.h"
+#include "LedgerSnapshot.h"
+#include "Metrics.h"
+#include "Tracing.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <algorithm>
 #include <sstream>
+#include <charconv>
+#include <queue>
+#include <cmath>
+#include <atomic>
+#include <stdexcept>
 
 using namespace std;
 
+// Ledgers smaller than this are scanned on the calling thread
+static const size_t PARALLEL_SCAN_THRESHOLD = 50000;
+static const size_t RANGES_PER_WORKER = 8; // Key ranges per worker in a parallel scan (evens out uneven ranges)
+
+// Incremental backup sets allowed before the next backup is forced to be a full set
+static const int MAX_INCREMENTAL_BACKUPS = 24;
+
+// Changed IDs remembered for the next incremental set; past this the journal is
+// dropped and the next set is a full one instead (it would be nearly as big anyway)
+static const size_t MAX_BACKUP_JOURNAL = 1000000;
+
+// Rows formatted per CSV export block (each block becomes one sequential write)
+static const size_t CSV_BLOCK_ROWS = 32768;
+
+// Number of secondary indexes (TransactionIndex values other than ALL)
+static const size_t INDEX_COUNT = 3;
+
+// Sorted (key, transaction ID) pairs extracted by one partition during a reindex. The
+// strings are allocated from the target index's pool, so the merge moves them into the
+// index nodes without copying.
+typedef pair<pmr::string, pmr::string> IndexEntry;
+typedef vector<IndexEntry> IndexRun;
+
+// Part of a sorted run that falls into one key range of the merge
+typedef pair<IndexRun::iterator, IndexRun::iterator> IndexSlice;
+
+// Sampled (key, id) pairs cutting the runs into ranges of about equal size
+static vector<IndexEntry> chooseIndexSplitters(const vector<IndexRun> &runs, size_t ranges)
+{
+    size_t rows = 0;
+    for (const IndexRun &run : runs)
+    {
+        rows += run.size();
+    }
+    vector<const IndexEntry *> samples;
+    size_t stride = max<size_t>(1, rows / (ranges * 32)); // ~32 samples per range
+    for (const IndexRun &run : runs)
+    {
+        for (size_t i = stride / 2; i < run.size(); i += stride)
+        {
+            samples.push_back(&run[i]);
+        }
+    }
+    sort(samples.begin(), samples.end(),
+         [](const IndexEntry *a, const IndexEntry *b) { return *a < *b; });
+    vector<IndexEntry> splitters;
+    for (size_t r = 1; r < ranges && !samples.empty(); r++)
+    {
+        splitters.push_back(*samples[r * samples.size() / ranges]);
+    }
+    return splitters;
+}
+
+// Merge sorted slices into an index; keys arrive in order, so every insert is an O(1) hinted append
+static void mergeIndexSlices(const vector<IndexSlice> &slices, TransactionIndexMap &index)
+{
+    typedef pair<IndexRun::iterator, IndexRun::iterator> Cursor; // (next, end)
+    auto later = [](const Cursor &a, const Cursor &b)
+    { return *b.first < *a.first; };
+    priority_queue<Cursor, vector<Cursor>, decltype(later)> heap(later);
+    for (const IndexSlice &slice : slices)
+    {
+        if (slice.first != slice.second)
+        {
+            heap.push(slice);
+        }
+    }
+    while (!heap.empty())
+    {
+        Cursor cursor = heap.top();
+        heap.pop();
+        index.emplace_hint(index.end(), move(cursor.first->first), move(cursor.first->second));
+        if (++cursor.first != cursor.second)
+        {
+            heap.push(cursor);
+        }
+    }
+}
+
+// Append a CSV field, quoting it when it contains a delimiter, quote or line break
+static void appendCsvField(string &out, const string &field)
+{
+    if (field.find_first_of(",\"\r\n") == string::npos)
+    {
+        out += field;
+        return;
+    }
+    out += '"';
+    for (char c : field)
+    {
+        if (c == '"')
+        {
+            out += '"'; // Quotes are escaped by doubling
+        }
+        out += c;
+    }
+    out += '"';
+}
+
+// Append a number with two decimal places (no stream formatting state involved)
+static void appendFixed2(string &out, double value)
+{
+    char buffer[64];
+    auto result = to_chars(buffer, buffer + sizeof(buffer), value, chars_format::fixed, 2);
+    out.append(buffer, result.ptr);
+}
+
+// Append one transaction as a CSV row
+static void appendCsvRow(string &out, const Transaction &txn)
+{
+    appendCsvField(out, txn.getTransactionId());
+    out += ',';
+    appendCsvField(out, txn.getAccountNumber());
+    out += ',';
+    out += to_string(static_cast<int>(txn.getTransactionType()));
+    out += ',';
+    appendFixed2(out, txn.getAmount());
+    out += ',';
+    out += txn.getTimestamp().substr(0, 10);
+    out += ',';
+    out += txn.getStatusString();
+    out += ',';
+    appendCsvField(out, txn.getDescription());
+    out += '\n';
+}
+
+// =============================================================================
+// ENUM CONVERSIONS
+// =============================================================================
+
+// Convert transaction type to string
+string transactionTypeToString(TransactionType type)
+{
+    switch (type)
+    {
+    case TransactionType::DEPOSIT:
+        return "DEPOSIT";
+    case TransactionType::WITHDRAWAL:
+        return "WITHDRAWAL";
+    case TransactionType::TRANSFER_IN:
+        return "TRANSFER_IN";
+    case TransactionType::TRANSFER_OUT:
+        return "TRANSFER_OUT";
+    case TransactionType::FEE_CHARGE:
+        return "FEE_CHARGE";
+    case TransactionType::INTEREST_CREDIT:
+        return "INTEREST_CREDIT";
+    case TransactionType::ACCOUNT_OPENING:
+        return "ACCOUNT_OPENING";
+    case TransactionType::ACCOUNT_CLOSING:
+        return "ACCOUNT_CLOSING";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+// Convert transaction status to string
+string transactionStatusToString(TransactionStatus status)
+{
+    switch (status)
+    {
+    case TransactionStatus::PENDING:
+        return "PENDING";
+    case TransactionStatus::COMPLETED:
+        return "COMPLETED";
+    case TransactionStatus::FAILED:
+        return "FAILED";
+    case TransactionStatus::CANCELLED:
+        return "CANCELLED";
+    case TransactionStatus::REVERSED:
+        return "REVERSED";
+    default:
+        return "UNKNOWN";
+    }
+}
+
 // =============================================================================
 // TRANSACTION CLASS IMPLEMENTATIONS
 // =============================================================================
@@ -30,33 +223,36 @@ Transaction::Transaction()
     notes = "";
 }
 
-// Parameterized constructor
+// Parameterized constructor (string arguments are taken by value and moved into place)
 Transaction::Transaction(string txnId, string accNum, TransactionType type, double amt,
                          string desc, double beforeBal, double afterBal, string custId)
+    : transactionId(move(txnId)), accountNumber(move(accNum)), relatedAccountNumber(),
+      transactionType(type), amount(amt), timestamp(getCurrentDateTime()), description(move(desc)),
+      balanceBefore(beforeBal), balanceAfter(afterBal),
+      status(TransactionStatus::COMPLETED), // Default to completed
+      customerId(move(custId)), sessionId(), notes() // Session and notes empty by default
+{
+}
+
+// Restoring constructor (all fields, including timestamp and status, taken from storage)
+Transaction::Transaction(string txnId, string accNum, string relatedAccNum, TransactionType type, double amt,
+                         string time, string desc, double beforeBal, double afterBal, TransactionStatus txnStatus,
+                         string custId, string session, string txnNotes, string key)
+    : transactionId(move(txnId)), accountNumber(move(accNum)), relatedAccountNumber(move(relatedAccNum)),
+      transactionType(type), amount(amt), timestamp(move(time)), description(move(desc)),
+      balanceBefore(beforeBal), balanceAfter(afterBal), status(txnStatus),
+      customerId(move(custId)), sessionId(move(session)), notes(move(txnNotes)), idempotencyKey(move(key))
 {
-    transactionId = txnId;
-    accountNumber = accNum;
-    relatedAccountNumber = "";
-    transactionType = type;
-    amount = amt;
-    timestamp = getCurrentDateTime();
-    description = desc;
-    balanceBefore = beforeBal;
-    balanceAfter = afterBal;
-    status = TransactionStatus::COMPLETED; // Default to completed
-    customerId = custId;
-    sessionId = ""; // Set to empty by default
-    notes = "";     // Set to empty by default
 }
 
 // Get transaction ID
-string Transaction::getTransactionId() const
+const string &Transaction::getTransactionId() const
 {
     return transactionId;
 }
 
 // Get account number
-string Transaction::getAccountNumber() const
+const string &Transaction::getAccountNumber() const
 {
     return accountNumber;
 }
@@ -84,7 +280,7 @@ double Transaction::getAmount() const
 }
 
 // Get timestamp
-string Transaction::getTimestamp() const
+const string &Transaction::getTimestamp() const
 {
     return timestamp;
 }
@@ -179,7 +375,7 @@ void Transaction::setRelatedAccountNumber(string relatedAccNum)
 {
     if (!relatedAccNum.empty())
     {
-        relatedAccountNumber = relatedAccNum;
+        relatedAccountNumber = move(relatedAccNum);
     }
     else
     {
@@ -187,12 +383,24 @@ void Transaction::setRelatedAccountNumber(string relatedAccNum)
     }
 }
 
+// Get idempotency key (empty if the request carried none)
+const string &Transaction::getIdempotencyKey() const
+{
+    return idempotencyKey;
+}
+
+// Set idempotency key
+void Transaction::setIdempotencyKey(string key)
+{
+    idempotencyKey = move(key);
+}
+
 // Set session ID
 void Transaction::setSessionId(string sessionId)
 {
     if (!sessionId.empty())
     {
-        this->sessionId = sessionId;
+        this->sessionId = move(sessionId);
     }
     else
     {
@@ -205,7 +413,7 @@ void Transaction::setNotes(string notes)
 {
     if (!notes.empty())
     {
-        this->notes = notes;
+        this->notes = move(notes);
     }
     else
     {
@@ -229,39 +437,13 @@ void Transaction::setBalanceAfter(double balance)
 // Get transaction type as string
 string Transaction::getTransactionTypeString() const
 {
-    switch (transactionType)
-    {
-    case TransactionType::DEPOSIT:
-        return "DEPOSIT";
-    case TransactionType::WITHDRAWAL:
-        return "WITHDRAWAL";
-    case TransactionType::TRANSFER_IN:
-        return "TRANSFER_IN";
-    case TransactionType::TRANSFER_OUT:
-        return "TRANSFER_OUT";
-    case TransactionType::FEE_CHARGE:
-        return "FEE_CHARGE";
-    case TransactionType::INTEREST_CREDIT:
-        return "INTEREST_CREDIT";
-    default:
-        return "UNKNOWN";
-    }
+    return transactionTypeToString(transactionType);
 }
 
 // Get status as string
 string Transaction::getStatusString() const
 {
-    switch (status)
-    {
-    case TransactionStatus::PENDING:
-        return "PENDING";
-    case TransactionStatus::COMPLETED:
-        return "COMPLETED";
-    case TransactionStatus::FAILED:
-        return "FAILED";
-    default:
-        return "UNKNOWN";
-    }
+    return transactionStatusToString(status);
 }
 
 // Check if transaction was successful
@@ -330,6 +512,115 @@ void Transaction::displayTransactionSummary() const
          << endl;
 }
 
+// Escape a record field (tabs and line breaks would split the record)
+static void appendRecordField(string &out, const string &field)
+{
+    for (char c : field)
+    {
+        switch (c)
+        {
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        default:
+            out += c;
+        }
+    }
+    out += '\t';
+}
+
+// Append a number that parses back to exactly the same double
+static void appendRecordNumber(string &out, double value)
+{
+    char buffer[64];
+    auto result = to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+    out += '\t';
+}
+
+// Serialize to a single-line record
+string Transaction::toRecord() const
+{
+    string record;
+    record.reserve(160);
+    appendRecordField(record, transactionId);
+    appendRecordField(record, accountNumber);
+    appendRecordField(record, relatedAccountNumber);
+    appendRecordNumber(record, static_cast<int>(transactionType));
+    appendRecordNumber(record, amount);
+    appendRecordField(record, timestamp);
+    appendRecordField(record, description);
+    appendRecordNumber(record, balanceBefore);
+    appendRecordNumber(record, balanceAfter);
+    appendRecordNumber(record, static_cast<int>(status));
+    appendRecordField(record, customerId);
+    appendRecordField(record, sessionId);
+    appendRecordField(record, notes);
+    if (!idempotencyKey.empty())
+    {
+        appendRecordField(record, idempotencyKey); // Optional 14th field
+    }
+    record.pop_back(); // No trailing separator
+    return record;
+}
+
+// Parse a record written by toRecord()
+bool Transaction::fromRecord(const string &record, Transaction &transaction)
+{
+    vector<string> fields(1);
+    for (size_t i = 0; i < record.size(); i++)
+    {
+        char c = record[i];
+        if (c == '\t')
+        {
+            fields.emplace_back();
+        }
+        else if (c == '\\' && i + 1 < record.size())
+        {
+            char next = record[++i];
+            fields.back() += next == 't' ? '\t' : next == 'n' ? '\n' : next == 'r' ? '\r' : next;
+        }
+        else
+        {
+            fields.back() += c;
+        }
+    }
+    if (fields.size() != 13 && fields.size() != 14)
+    {
+        return false; // Truncated or foreign line
+    }
+    if (fields.size() == 13)
+    {
+        fields.emplace_back(); // Written without an idempotency key
+    }
+    double numbers[5];
+    const int numericFields[5] = {3, 4, 7, 8, 9};
+    for (int i = 0; i < 5; i++)
+    {
+        const string &field = fields[numericFields[i]];
+        auto result = from_chars(field.data(), field.data() + field.size(), numbers[i]);
+        if (result.ec != errc() || result.ptr != field.data() + field.size())
+        {
+            return false;
+        }
+    }
+    transaction = Transaction(move(fields[0]), move(fields[1]), move(fields[2]),
+                              static_cast<TransactionType>(static_cast<int>(numbers[0])),
+                              numbers[1], move(fields[5]), move(fields[6]), numbers[2], numbers[3],
+                              static_cast<TransactionStatus>(static_cast<int>(numbers[4])),
+                              move(fields[10]), move(fields[11]), move(fields[12]), move(fields[13]));
+    return true;
+}
+
 // Comparison operator for sorting
 bool Transaction::operator<(const Transaction &other) const
 {
@@ -342,29 +633,124 @@ bool Transaction::operator==(const Transaction &other) const
     return transactionId == other.transactionId;
 }
 
+// =============================================================================
+// TRANSACTION STATISTICS IMPLEMENTATIONS
+// =============================================================================
+
+// Accumulate one transaction
+void TransactionStatistics::add(const Transaction &transaction)
+{
+    size_t status = static_cast<size_t>(transaction.getStatus());
+    size_t type = static_cast<size_t>(transaction.getTransactionType());
+    double amount = transaction.getAmount();
+    totalTransactions++;
+    totalVolume += transaction.getNetAmount();
+    if (status < TRANSACTION_STATUS_COUNT)
+    {
+        statusCounts[status]++;
+        statusAmounts[status] += amount;
+    }
+    if (type < TRANSACTION_TYPE_COUNT)
+    {
+        typeCounts[type]++;
+        typeAmounts[type] += amount;
+    }
+}
+
+// Merge another partial result into this one
+void TransactionStatistics::merge(const TransactionStatistics &other)
+{
+    totalTransactions += other.totalTransactions;
+    totalVolume += other.totalVolume;
+    for (size_t i = 0; i < TRANSACTION_STATUS_COUNT; i++)
+    {
+        statusCounts[i] += other.statusCounts[i];
+        statusAmounts[i] += other.statusAmounts[i];
+    }
+    for (size_t i = 0; i < TRANSACTION_TYPE_COUNT; i++)
+    {
+        typeCounts[i] += other.typeCounts[i];
+        typeAmounts[i] += other.typeAmounts[i];
+    }
+}
+
 // =============================================================================
 // TRANSACTION MANAGER CLASS IMPLEMENTATIONS
 // =============================================================================
 
 // Constructor
-TransactionManager::TransactionManager(string logFile)
+TransactionManager::TransactionManager(string logFile, string archiveDirectory, pmr::memory_resource *upstream)
+    : historyMemory(upstream, "memory.transaction_history_bytes"),
+      accountIndexMemory(upstream, "memory.account_index_bytes"),
+      customerIndexMemory(upstream, "memory.customer_index_bytes"),
+      dateIndexMemory(upstream, "memory.date_index_bytes"),
+      historyPool(&historyMemory), accountIndexPool(&accountIndexMemory),
+      customerIndexPool(&customerIndexMemory), dateIndexPool(&dateIndexMemory),
+      transactionHistory(&historyPool), accountTransactions(&accountIndexPool),
+      customerTransactions(&customerIndexPool), dateTransactions(&dateIndexPool)
 {
     logFilePath = logFile;
+    ledgerVersion = 0;
+    backupJournalOverflowed = false;
+    snapshotLayoutValid = false;
+    workerPool.reset(new ThreadPool()); // Before any scan, so const readers never create it
+    archive.reset(new TransactionArchive(archiveDirectory));
+    archive->loadCatalog();
+    rollups.reset(new TransactionRollups());
+    archivedRollups.reset(new TransactionRollups());
+    customerSummaries.reset(new CustomerSummaries());
+    archivedCustomerSummaries.reset(new CustomerSummaries());
+    idempotencyKeys.reset(new IdempotencyTable());
+    limits.reset(new LimitEngine());
+    bool rollupsLoaded = archivedRollups->load(archive->getArchiveDirectory() + "rollups.txt");
+    bool summariesLoaded = archivedCustomerSummaries->load(archive->getArchiveDirectory() + "customer_summaries.txt");
+    if ((!rollupsLoaded || !summariesLoaded) && archive->getSegmentCount() > 0)
+    {
+        // Archive written before these existed: total it once, oldest first for the recent rings
+        vector<Transaction> archivedRows = archive->findByDateRange("0000-00-00", "9999-12-31");
+        sort(archivedRows.begin(), archivedRows.end(), [](const Transaction &a, const Transaction &b)
+             { return a.getTimestamp() != b.getTimestamp() ? a.getTimestamp() < b.getTimestamp()
+                                                           : a.getTransactionId() < b.getTransactionId(); });
+        archivedRollups->clear();
+        archivedCustomerSummaries->clear();
+        for (const Transaction &txn : archivedRows)
+        {
+            archivedRollups->add(txn);
+            archivedCustomerSummaries->add(txn);
+        }
+        archivedRollups->save(archive->getArchiveDirectory() + "rollups.txt");
+        archivedCustomerSummaries->save(archive->getArchiveDirectory() + "customer_summaries.txt");
+    }
+    recovery.reset(new RecoveryManager(logFile));
     // Initialize empty maps and multimaps
     transactionHistory.clear();
     accountTransactions.clear();
     customerTransactions.clear();
     dateTransactions.clear();
     nextTransactionNumber = 1; // Start with transaction number 1
-    if (!loadTransactionHistory())
+    if (recovery->recover(transactionHistory))
+    {
+        invalidateSnapshot();
+        // Checkpoint + WAL replay is newer than the plain history file
+        reindexTransactions();
+        for (const auto &pair : transactionHistory)
+        {
+            updateNextTransactionNumber(pair.first);
+        }
+        cout << "Transaction history recovered from checkpoint and write-ahead log." << endl;
+    }
+    else if (!loadTransactionHistory())
     {
         cout << "No existing transaction history found. Starting fresh." << endl;
     }
     else
     {
+        checkpoint(); // First checkpoint, so a crash never falls back to an empty ledger
         cout << "Transaction history loaded successfully." << endl;
         cout << "Transaction Manager initialized with log file: " << logFilePath << endl;
     }
+    rebuildRollups();
+    publishLedgerSize();
     cout << "Next transaction number: " << nextTransactionNumber << endl;
     cout << "----------------------------------------" << endl;
 }
@@ -372,6 +758,7 @@ TransactionManager::TransactionManager(string logFile)
 // Destructor
 TransactionManager::~TransactionManager()
 {
+    waitForBackup(); // The writer reads from a snapshot, but reports back into this object
     if (!saveTransactionHistory())
     {
         cout << "Failed to save transaction history on exit." << endl;
@@ -380,19 +767,30 @@ TransactionManager::~TransactionManager()
     {
         cout << "Transaction history saved successfully on exit." << endl;
     }
+    // Final checkpoint so the next start has no WAL to replay
+    checkpoint();
+    recovery->waitForCheckpoint();
     cout << "Transaction Manager destroyed." << endl;
 }
 
 // Process deposit transaction
-string TransactionManager::processDeposit(string accountNumber, double amount, string description,double balanceBefore, double balanceAfter, string customerId)
+string TransactionManager::processDeposit(string accountNumber, double amount, string description,double balanceBefore, double balanceAfter, string customerId,
+                                          string idempotencyKey)
 {
+    METRICS_TIME_SCOPE("TransactionManager::processDeposit");
+    if (refuseCommittedRequest(idempotencyKey))
+    {
+        return "";
+    }
     string transactionId = generateTransactionId();
-    Transaction transaction(transactionId, accountNumber, TransactionType::DEPOSIT, amount,
-                            description, balanceBefore, balanceAfter, customerId);
+    Transaction transaction(transactionId, move(accountNumber), TransactionType::DEPOSIT, amount,
+                            move(description), balanceBefore, balanceAfter, move(customerId));
     transaction.setStatus(TransactionStatus::COMPLETED); // Set status to completed
-    if (addTransaction(transaction))
+    transaction.setIdempotencyKey(move(idempotencyKey));
+    if (addTransaction(move(transaction)))
     {
         cout << "Deposit transaction processed successfully: " << transactionId << endl;
+        rememberIdempotencyKey(transactionId);
         return transactionId; // Return the transaction ID
     }
     else
@@ -404,15 +802,23 @@ string TransactionManager::processDeposit(string accountNumber, double amount, s
 
 // Process withdrawal transaction
 string TransactionManager::processWithdrawal(string accountNumber, double amount, string description,
-                                             double balanceBefore, double balanceAfter, string customerId)
+                                             double balanceBefore, double balanceAfter, string customerId,
+                                             string idempotencyKey)
 {
+    METRICS_TIME_SCOPE("TransactionManager::processWithdrawal");
+    if (refuseCommittedRequest(idempotencyKey))
+    {
+        return "";
+    }
     string transactionId = generateTransactionId();
-    Transaction transaction(transactionId, accountNumber, TransactionType::WITHDRAWAL, amount,
-                            description, balanceBefore, balanceAfter, customerId);
+    Transaction transaction(transactionId, move(accountNumber), TransactionType::WITHDRAWAL, amount,
+                            move(description), balanceBefore, balanceAfter, move(customerId));
     transaction.setStatus(TransactionStatus::COMPLETED); // Set status to completed
-    if (addTransaction(transaction))
+    transaction.setIdempotencyKey(move(idempotencyKey));
+    if (addTransaction(move(transaction)))
     {
         cout << "Withdrawal transaction processed successfully: " << transactionId << endl;
+        rememberIdempotencyKey(transactionId);
         return transactionId; // Return the transaction ID
     }
     else
@@ -425,14 +831,21 @@ string TransactionManager::processWithdrawal(string accountNumber, double amount
 // Process transfer transaction
 string TransactionManager::processTransfer(string fromAccount, string toAccount, double amount,
                                            string description, double fromBalBefore, double fromBalAfter,
-                                           double toBalBefore, double toBalAfter, string customerId)
+                                           double toBalBefore, double toBalAfter, string customerId,
+                                           string idempotencyKey)
 {
+    METRICS_TIME_SCOPE("TransactionManager::processTransfer");
+    if (refuseCommittedRequest(idempotencyKey))
+    {
+        return "";
+    }
     string transferOutId = generateTransactionId();
     Transaction transferOut(transferOutId, fromAccount, TransactionType::TRANSFER_OUT, amount,
                             description, fromBalBefore, fromBalAfter, customerId);
     transferOut.setRelatedAccountNumber(toAccount);
     transferOut.setStatus(TransactionStatus::COMPLETED); // Set status to completed
-    if (!addTransaction(transferOut))
+    transferOut.setIdempotencyKey(move(idempotencyKey)); // The transfer is found by its OUT leg
+    if (!addTransaction(move(transferOut)))
     {
         cout << "Failed to process transfer OUT transaction." << endl;
         return ""; // Return empty string on failure
@@ -440,30 +853,144 @@ string TransactionManager::processTransfer(string fromAccount, string toAccount,
     cout << "Transfer OUT transaction processed successfully: " << transferOutId << endl;
     // Now create the transfer IN transaction
     string transferInId = generateTransactionId();
-    Transaction transferIn(transferInId, toAccount, TransactionType::TRANSFER_IN, amount,
-                           description, toBalBefore, toBalAfter, customerId);
-    transferIn.setRelatedAccountNumber(fromAccount);
+    Transaction transferIn(transferInId, move(toAccount), TransactionType::TRANSFER_IN, amount,
+                           move(description), toBalBefore, toBalAfter, move(customerId));
+    transferIn.setRelatedAccountNumber(move(fromAccount));
     transferIn.setStatus(TransactionStatus::COMPLETED); // Set status to completed
-    if (!addTransaction(transferIn))
+    if (!addTransaction(move(transferIn)))
     {
         cout << "Failed to process transfer IN transaction." << endl;
         // Rollback the transfer OUT transaction
-        updateTransactionStatus(transferOutId, TransactionStatus::FAILED);
-        cout << "Transfer OUT transaction rolled back due to failure in transfer IN." << endl;
+        if (updateTransactionStatus(transferOutId, TransactionStatus::FAILED))
+        {
+            cout << "Transfer OUT transaction rolled back due to failure in transfer IN." << endl;
+        }
+        else
+        {
+            cout << "Transfer OUT transaction " << transferOutId << " could not be marked FAILED." << endl;
+        }
         return ""; // Return empty string on failure
     }
     cout << "Transfer IN transaction processed successfully: " << transferInId << endl;
+    rememberIdempotencyKey(transferOutId); // Only now is the whole transfer committed
     return transferOutId; // Return the transfer OUT transaction ID
 }
+
+// Whether a row in this status still answers a retry of its request (a failed,
+// cancelled or reversed one does not)
+static bool standsForRequest(TransactionStatus status)
+{
+    return status == TransactionStatus::PENDING || status == TransactionStatus::COMPLETED;
+}
+
+// Register the request key of an operation that has fully committed
+void TransactionManager::rememberIdempotencyKey(const string &transactionId)
+{
+    auto it = transactionHistory.find(transactionId);
+    if (it != transactionHistory.end() && !it->second.getIdempotencyKey().empty() &&
+        standsForRequest(it->second.getStatus()))
+    {
+        idempotencyKeys->remember(it->second.getIdempotencyKey(), transactionId);
+    }
+}
+
+// Refuse a request whose key is already committed. The caller should have
+// checked before changing balances; recording nothing makes it undo its change
+// instead of hiding a second one.
+bool TransactionManager::refuseCommittedRequest(const string &idempotencyKey) const
+{
+    string existingId;
+    if (!findIdempotentCommit(idempotencyKey, existingId))
+    {
+        return false;
+    }
+    cout << "Request " << idempotencyKey << " was already committed as " << existingId << "." << endl;
+    return true;
+}
+
+// Look up a request key committed within the TTL
+bool TransactionManager::findIdempotentCommit(const string &idempotencyKey, string &transactionId) const
+{
+    return !idempotencyKey.empty() && idempotencyKeys->find(idempotencyKey, transactionId);
+}
+
+// Process deposit transaction, resuming once it is durable
+Task<string> TransactionManager::processDepositAsync(string accountNumber, double amount, string description,
+                                                     double balanceBefore, double balanceAfter, string customerId,
+                                                     string idempotencyKey)
+{
+    string transactionId = processDeposit(move(accountNumber), amount, move(description),
+                                          balanceBefore, balanceAfter, move(customerId), move(idempotencyKey));
+    if (!co_await waitForDurableCommit())
+    {
+        throw runtime_error("write-ahead log sync failed");
+    }
+    co_return transactionId;
+}
+
+// Process withdrawal transaction, resuming once it is durable
+Task<string> TransactionManager::processWithdrawalAsync(string accountNumber, double amount, string description,
+                                                        double balanceBefore, double balanceAfter, string customerId,
+                                                        string idempotencyKey)
+{
+    string transactionId = processWithdrawal(move(accountNumber), amount, move(description),
+                                             balanceBefore, balanceAfter, move(customerId), move(idempotencyKey));
+    if (!co_await waitForDurableCommit())
+    {
+        throw runtime_error("write-ahead log sync failed");
+    }
+    co_return transactionId;
+}
+
+// Process transfer transaction, resuming once both legs are durable
+Task<string> TransactionManager::processTransferAsync(string fromAccount, string toAccount, double amount,
+                                                      string description, double fromBalBefore, double fromBalAfter,
+                                                      double toBalBefore, double toBalAfter, string customerId,
+                                                      string idempotencyKey)
+{
+    string transferOutId = processTransfer(move(fromAccount), move(toAccount), amount, move(description),
+                                           fromBalBefore, fromBalAfter, toBalBefore, toBalAfter, move(customerId),
+                                           move(idempotencyKey));
+    if (!co_await waitForDurableCommit())
+    {
+        throw runtime_error("write-ahead log sync failed");
+    }
+    co_return transferOutId;
+}
+
+// Suspend until the WAL holds every commit so far on disk
+Task<bool> TransactionManager::waitForDurableCommit()
+{
+    RecoveryManager *manager = recovery.get();
+    if (manager->isDurable())
+    {
+        co_return true;
+    }
+    bool durable = false;
+    co_await whenCalled([manager, &durable](function<void()> resume) {
+        manager->whenDurable([&durable, resume = move(resume)](bool synced) {
+            durable = synced;
+            resume();
+        });
+    });
+    co_return durable;
+}
 // Update transaction status
 bool TransactionManager::updateTransactionStatus(string transactionId, TransactionStatus newStatus)
 {
+    METRICS_TIME_SCOPE("TransactionManager::updateTransactionStatus");
     auto it = transactionHistory.find(transactionId);
     if (it != transactionHistory.end())
     {
         Transaction &transaction = it->second;
         TransactionStatus oldStatus = transaction.getStatus();
         transaction.setStatus(newStatus);
+        if (!recordCommit(transaction, &oldStatus))
+        {
+            transaction.setStatus(oldStatus);
+            cout << "Transaction status update failed." << endl;
+            return false; // Not logged
+        }
         cout << "Transaction " << transactionId << " status changed from "
              << static_cast<int>(oldStatus) << " to " << static_cast<int>(newStatus)
              << " at " << getCurrentDateTime() << endl;
@@ -480,13 +1007,11 @@ bool TransactionManager::updateTransactionStatus(string transactionId, Transacti
         {
             cout << "Failed to open log file for writing." << endl;
         }
-        // Update the transaction in the history
-        transactionHistory[transactionId] = transaction;
         // Update the status in the accountTransactions, customerTransactions, and dateTransactions maps
         auto range = accountTransactions.equal_range(transaction.getAccountNumber());
         for (auto it = range.first; it != range.second; ++it)
         {
-            if (it->second == transactionId)
+            if (it->second.compare(transactionId) == 0)
             {
                 accountTransactions.erase(it);
                 accountTransactions.emplace(transaction.getAccountNumber(), transactionId);
@@ -496,7 +1021,7 @@ bool TransactionManager::updateTransactionStatus(string transactionId, Transacti
         range = customerTransactions.equal_range(transaction.getCustomerId());
         for (auto it = range.first; it != range.second; ++it)
         {
-            if (it->second == transactionId)
+            if (it->second.compare(transactionId) == 0)
             {
                 customerTransactions.erase(it);
                 customerTransactions.emplace(transaction.getCustomerId(), transactionId);
@@ -506,7 +1031,7 @@ bool TransactionManager::updateTransactionStatus(string transactionId, Transacti
         range = dateTransactions.equal_range(transaction.getTimestamp().substr(0, 10)); // Use date part
         for (auto it = range.first; it != range.second; ++it)
         {
-            if (it->second == transactionId)
+            if (it->second.compare(transactionId) == 0)
             {
                 dateTransactions.erase(it);
                 dateTransactions.emplace(transaction.getTimestamp().substr(0, 10), transactionId);
@@ -528,6 +1053,7 @@ bool TransactionManager::updateTransactionStatus(string transactionId, Transacti
 // Reverse a transaction
 bool TransactionManager::reverseTransaction(string transactionId, string reason)
 {
+    METRICS_TIME_SCOPE("TransactionManager::reverseTransaction");
     auto it = transactionHistory.find(transactionId);
     if (it != transactionHistory.end())
     {
@@ -539,8 +1065,17 @@ bool TransactionManager::reverseTransaction(string transactionId, string reason)
             return false; // Cannot reverse non-completed transactions
         }
         // Set original transaction status to REVERSED
+        const TransactionStatus previousStatus = originalTransaction.getStatus();
+        string previousNotes = originalTransaction.getNotes();
         originalTransaction.setStatus(TransactionStatus::REVERSED);
         originalTransaction.setNotes("Reversed: " + reason);
+        if (!recordCommit(originalTransaction, &previousStatus))
+        {
+            originalTransaction.setStatus(previousStatus);
+            originalTransaction.setNotes(move(previousNotes));
+            cout << "Transaction " << transactionId << " could not be reversed." << endl;
+            return false; // Not logged
+        }
         cout << "Transaction " << transactionId << " has been reversed." << endl;
         // Determine reversal type based on original transaction type
         TransactionType reversalType;
@@ -584,7 +1119,7 @@ bool TransactionManager::reverseTransaction(string transactionId, string reason)
                                         originalTransaction.getCustomerId());
         reversalTransaction.setRelatedAccountNumber(originalTransaction.getRelatedAccountNumber());
         reversalTransaction.setStatus(TransactionStatus::COMPLETED); // Set status to completed
-        if (addTransaction(reversalTransaction))
+        if (addTransaction(move(reversalTransaction)))
         {
             cout << "Reversal transaction created successfully: " << reversalId << endl;
             return true; // Successfully created reversal transaction
@@ -605,44 +1140,338 @@ bool TransactionManager::reverseTransaction(string transactionId, string reason)
 // Add transaction to system
 bool TransactionManager::addTransaction(Transaction transaction)
 {
+    METRICS_TIME_SCOPE("TransactionManager::addTransaction");
     string transactionId = transaction.getTransactionId();
     if (transactionHistory.find(transactionId) != transactionHistory.end())
     {
         cout << "Transaction with ID " << transactionId << " already exists." << endl;
         return false; // Transaction already exists
     }
-    // Add to transaction history
-    transactionHistory[transactionId] = transaction;
-    // Add to account transactions
-    accountTransactions.emplace(transaction.getAccountNumber(), transactionId);
-    // Add to customer transactions
-    transaction.setSessionId(""); // Reset session ID if not set
-    customerTransactions.emplace(transaction.getCustomerId(), transactionId);
-    // Add to date transactions
-    string date = transaction.getTimestamp().substr(0, 10); // Use date part
-    dateTransactions.emplace(date, transactionId);
-    // Update next transaction number if necessary
-    size_t lastDash = transactionId.find_last_of('-');
-    if (lastDash != string::npos && lastDash + 1 < transactionId.length())
+    if (!insertTransaction(move(transaction)))
     {
-        string numericPart = transactionId.substr(lastDash + 1);
-        int txnNumber = stoi(numericPart);
-        if (nextTransactionNumber <= txnNumber)
-        {
-            nextTransactionNumber = txnNumber + 1;
-        }
+        cout << "Transaction " << transactionId << " could not be written to the write-ahead log." << endl;
+        return false; // Not committed
     }
     cout << "Transaction " << transactionId << " added successfully." << endl;
     return true; // Successfully added
 }
 
-// Find transaction by ID
-Transaction *TransactionManager::findTransaction(string transactionId)
+// Insert or replace a transaction under its ID; returns the stored row
+const Transaction &storeTransaction(TransactionMap &transactions, Transaction transaction)
 {
-    auto it = transactionHistory.find(transactionId);
-    if (it != transactionHistory.end())
+    TransactionMap::key_type transactionId(transaction.getTransactionId(), transactions.get_allocator());
+    return transactions.insert_or_assign(move(transactionId), move(transaction)).first->second;
+}
+
+// Insert transaction into history and indexes
+bool TransactionManager::insertTransaction(Transaction &&incoming)
+{
+    auto inserted = transactionHistory.try_emplace(
+        TransactionMap::key_type(incoming.getTransactionId(), transactionHistory.get_allocator()), move(incoming));
+    if (!inserted.second)
     {
-        return &it->second; // Return pointer to the found transaction
+        return false; // Transaction already exists (incoming is left untouched)
+    }
+    const Transaction &transaction = inserted.first->second;
+    const pmr::string &transactionId = inserted.first->first;
+    if (!recordCommit(transaction))
+    {
+        transactionHistory.erase(inserted.first); // Not logged, so not committed
+        return false;
+    }
+    // Add to account transactions
+    accountTransactions.emplace(transaction.getAccountNumber(), transactionId);
+    // Add to customer transactions
+    customerTransactions.emplace(transaction.getCustomerId(), transactionId);
+    // Add to date transactions
+    string date = transaction.getTimestamp().substr(0, 10); // Use date part
+    dateTransactions.emplace(date, transactionId);
+    // Update next transaction number if necessary
+    updateNextTransactionNumber(transactionId);
+    return true; // Successfully added
+}
+
+// Advance nextTransactionNumber past an existing ID ("TXN2025-07-001" or "TXN20250725001")
+void TransactionManager::updateNextTransactionNumber(string_view transactionId)
+{
+    size_t sequenceStart = transactionId.find_last_of('-');
+    if (sequenceStart != string::npos)
+    {
+        sequenceStart++;
+    }
+    else if (transactionId.compare(0, 3, "TXN") == 0 && transactionId.size() > 11)
+    {
+        sequenceStart = 11; // After "TXN" + YYYYMMDD
+    }
+    else
+    {
+        return; // Not a generated ID
+    }
+    if (sequenceStart >= transactionId.size() ||
+        !all_of(transactionId.begin() + sequenceStart, transactionId.end(), [](char c)
+                { return isdigit(static_cast<unsigned char>(c)) != 0; }))
+    {
+        return;
+    }
+    long long txnNumber = stoll(string(transactionId.substr(sequenceStart)));
+    if (txnNumber < INT_MAX && nextTransactionNumber <= txnNumber)
+    {
+        nextTransactionNumber = static_cast<int>(txnNumber) + 1;
+    }
+}
+
+// Record a committed change; returns false (and records nothing) when the WAL refuses it
+bool TransactionManager::recordCommit(const Transaction &transaction, const TransactionStatus *previousStatus)
+{
+    if (!recovery->logCommit(transaction))
+    {
+        return false; // The caller undoes the change
+    }
+    static const size_t commitCounter = Metrics::registerCounter("ledger.commits");
+    static const array<size_t, TRANSACTION_TYPE_COUNT> typeCounters = []
+    {
+        array<size_t, TRANSACTION_TYPE_COUNT> ids;
+        for (size_t i = 0; i < TRANSACTION_TYPE_COUNT; i++)
+        {
+            ids[i] = Metrics::registerCounter("ledger.commits." + transactionTypeToString(static_cast<TransactionType>(i)));
+        }
+        return ids;
+    }();
+    static const array<size_t, TRANSACTION_STATUS_COUNT> statusCounters = []
+    {
+        array<size_t, TRANSACTION_STATUS_COUNT> ids;
+        for (size_t i = 0; i < TRANSACTION_STATUS_COUNT; i++)
+        {
+            ids[i] = Metrics::registerCounter("ledger.status_changes." + transactionStatusToString(static_cast<TransactionStatus>(i)));
+        }
+        return ids;
+    }();
+    Metrics::incrementCounter(commitCounter);
+    Metrics::incrementCounter(typeCounters[static_cast<size_t>(transaction.getTransactionType())]);
+    Metrics::incrementCounter(statusCounters[static_cast<size_t>(transaction.getStatus())]);
+    publishLedgerSize();
+    markSnapshotChunk(transaction.getTransactionId());
+    if (previousStatus == nullptr)
+    {
+        rollups->add(transaction);
+        customerSummaries->add(transaction);
+        limits->add(transaction); // The request key is registered once the whole operation commits
+    }
+    else
+    {
+        rollups->changeStatus(transaction, *previousStatus);
+        limits->changeStatus(transaction, *previousStatus);
+        if (!transaction.getIdempotencyKey().empty() && !standsForRequest(transaction.getStatus()))
+        {
+            idempotencyKeys->forget(transaction.getIdempotencyKey()); // A retry must commit again
+        }
+    }
+    if (!backupJournalOverflowed)
+    {
+        backupJournal.push_back(transaction.getTransactionId());
+        capBackupJournal();
+    }
+    if (recovery->isCheckpointDue())
+    {
+        checkpoint();
+    }
+    return true;
+}
+
+// Drop an over-long backup journal and force the next backup set to be FULL
+void TransactionManager::capBackupJournal() const
+{
+    if (backupJournal.size() <= MAX_BACKUP_JOURNAL)
+    {
+        return;
+    }
+    backupJournal.clear();
+    backupJournal.shrink_to_fit();
+    backupJournalOverflowed = true;
+}
+
+// Publish the ledger size gauge
+void TransactionManager::publishLedgerSize() const
+{
+    static const size_t sizeGauge = Metrics::registerGauge("ledger.transactions");
+    Metrics::setGauge(sizeGauge, static_cast<double>(transactionHistory.size()));
+}
+
+// Start a checkpoint of the current ledger (written in the background)
+bool TransactionManager::checkpoint()
+{
+    METRICS_TIME_SCOPE("TransactionManager::checkpoint");
+    TraceSpan span("checkpoint.snapshot", "ledger");
+    static const size_t checkpointCounter = Metrics::registerCounter("ledger.checkpoints");
+    Metrics::incrementCounter(checkpointCounter);
+    recovery->waitForCheckpoint(); // An explicit checkpoint must not be skipped
+    return recovery->beginCheckpoint(getSnapshot()); // Unchanged chunks still pinned are shared, not copied
+}
+
+// Mark the snapshot chunk covering a committed transaction as stale
+void TransactionManager::markSnapshotChunk(const string &transactionId)
+{
+    lock_guard<mutex> lock(snapshotMutex);
+    ledgerVersion++;
+    currentSnapshot.reset();
+    if (!snapshotLayoutValid || snapshotChunkStarts.empty())
+    {
+        return; // Everything is rebuilt anyway
+    }
+    // Chunk i covers IDs from its first row up to the next chunk's first row
+    auto next = upper_bound(snapshotChunkStarts.begin() + 1, snapshotChunkStarts.end(), transactionId);
+    dirtySnapshotChunks[(next - snapshotChunkStarts.begin()) - 1] = true;
+}
+
+// Drop the chunk layout after a bulk change (the next snapshot copies every chunk)
+void TransactionManager::invalidateSnapshot()
+{
+    lock_guard<mutex> lock(snapshotMutex);
+    ledgerVersion++;
+    currentSnapshot.reset();
+    snapshotLayoutValid = false;
+    snapshotChunks.clear();
+    snapshotChunkStarts.clear();
+    dirtySnapshotChunks.clear();
+}
+
+// Pin the current ledger version, copying only the chunks that changed or were released
+// since the last snapshot
+shared_ptr<const LedgerSnapshot> TransactionManager::getSnapshot() const
+{
+    lock_guard<mutex> lock(snapshotMutex);
+    if (shared_ptr<const LedgerSnapshot> current = currentSnapshot.lock())
+    {
+        return current; // No commit since and still pinned: readers share the version
+    }
+    METRICS_TIME_SCOPE("TransactionManager::getSnapshot");
+    TraceSpan span("ledger.snapshot", "ledger");
+    static const size_t rebuiltCounter = Metrics::registerCounter("ledger.snapshot_chunks_rebuilt");
+    const size_t CHUNK_ROWS = 1024; // Split size; a chunk grows to twice this before splitting
+
+    vector<shared_ptr<const LedgerChunk>> chunks;
+    size_t rebuilt = 0;
+    // Copy rows starting at first into new chunks, splitting ranges of 2 * CHUNK_ROWS or more
+    auto buildChunks = [&](TransactionMap::const_iterator first, size_t rows)
+    {
+        size_t pieces = rows < 2 * CHUNK_ROWS ? 1 : rows / CHUNK_ROWS;
+        for (size_t piece = 0; piece < pieces; piece++)
+        {
+            auto chunk = make_shared<LedgerChunk>();
+            size_t take = piece + 1 == pieces ? rows - piece * (rows / pieces) : rows / pieces;
+            chunk->rows.reserve(take);
+            for (size_t i = 0; i < take; i++, ++first)
+            {
+                chunk->rows.push_back(first->second);
+            }
+            chunks.push_back(move(chunk));
+            rebuilt++;
+        }
+    };
+
+    if (!snapshotLayoutValid || snapshotChunks.empty())
+    {
+        if (!transactionHistory.empty())
+        {
+            buildChunks(transactionHistory.begin(), transactionHistory.size());
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < snapshotChunks.size(); i++)
+        {
+            shared_ptr<const LedgerChunk> chunk = dirtySnapshotChunks[i] ? nullptr : snapshotChunks[i].lock();
+            if (chunk != nullptr)
+            {
+                chunks.push_back(move(chunk)); // Unchanged and pinned: shared with older versions
+                continue;
+            }
+            auto first = i == 0 ? transactionHistory.begin()
+                                : transactionHistory.lower_bound(snapshotChunkStarts[i]);
+            auto last = i + 1 == snapshotChunks.size()
+                            ? transactionHistory.end()
+                            : transactionHistory.lower_bound(snapshotChunkStarts[i + 1]);
+            size_t rows = static_cast<size_t>(distance(first, last));
+            if (rows > 0)
+            {
+                buildChunks(first, rows);
+            }
+        }
+    }
+    Metrics::incrementCounter(rebuiltCounter, rebuilt);
+
+    snapshotChunks.assign(chunks.begin(), chunks.end());
+    snapshotChunkStarts.clear();
+    snapshotChunkStarts.reserve(chunks.size());
+    for (const shared_ptr<const LedgerChunk> &chunk : chunks)
+    {
+        snapshotChunkStarts.push_back(chunk->rows.front().getTransactionId());
+    }
+    dirtySnapshotChunks.assign(snapshotChunks.size(), false);
+    snapshotLayoutValid = true;
+    auto snapshot = make_shared<const LedgerSnapshot>(ledgerVersion, move(chunks));
+    currentSnapshot = snapshot;
+    return snapshot;
+}
+
+// Get the latest completed balance recorded for every account (for reconciling accounts after a restart)
+map<string, double> TransactionManager::getLastKnownBalances() const
+{
+    METRICS_TIME_SCOPE("TransactionManager::getLastKnownBalances");
+    map<string, const Transaction *> latest;
+    for (const auto &pair : transactionHistory)
+    {
+        const Transaction &txn = pair.second;
+        if (txn.getStatus() != TransactionStatus::COMPLETED)
+        {
+            continue;
+        }
+        const Transaction *&current = latest[txn.getAccountNumber()];
+        if (current == nullptr || current->getTimestamp() < txn.getTimestamp() ||
+            (current->getTimestamp() == txn.getTimestamp() && current->getTransactionId() < txn.getTransactionId()))
+        {
+            current = &txn;
+        }
+    }
+    map<string, double> balances;
+    for (const auto &pair : latest)
+    {
+        balances[pair.first] = pair.second->getBalanceAfter();
+    }
+    return balances;
+}
+
+// Commit a batch of ledger entries (one summary line instead of per-row output)
+vector<string> TransactionManager::processBatch(vector<LedgerEntry> entries)
+{
+    METRICS_TIME_SCOPE("TransactionManager::processBatch");
+    TraceSpan span("batch.commit", "batch");
+    vector<string> transactionIds;
+    transactionIds.reserve(entries.size());
+    size_t recordedCount = 0;
+    for (LedgerEntry &entry : entries)
+    {
+        string transactionId = generateTransactionId();
+        Transaction transaction(transactionId, move(entry.accountNumber), entry.transactionType, entry.amount,
+                                move(entry.description), entry.balanceBefore, entry.balanceAfter,
+                                move(entry.customerId));
+        bool recorded = insertTransaction(move(transaction));
+        transactionIds.push_back(recorded ? move(transactionId) : string());
+        recordedCount += recorded;
+    }
+    cout << "Batch committed: " << recordedCount << " of " << entries.size()
+         << " ledger entries recorded." << endl;
+    return transactionIds; // In batch order; empty where the entry was not recorded
+}
+
+// Find transaction by ID
+Transaction *TransactionManager::findTransaction(string transactionId)
+{
+    METRICS_TIME_SCOPE("TransactionManager::findTransaction");
+    auto it = transactionHistory.find(transactionId);
+    if (it != transactionHistory.end())
+    {
+        return &it->second; // Return pointer to the found transaction
     }
     else
     {
@@ -654,17 +1483,25 @@ Transaction *TransactionManager::findTransaction(string transactionId)
 // Get account transaction history
 vector<Transaction> TransactionManager::getAccountHistory(string accountNumber, int limit) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::getAccountHistory");
+    TraceSpan span("query.account_history", "query");
     vector<Transaction> history;
     auto range = accountTransactions.equal_range(accountNumber);
     for (auto it = range.first; it != range.second && history.size() < static_cast<size_t>(limit); ++it)
     {
-        const string &transactionId = it->second;
+        const pmr::string &transactionId = it->second;
         auto txnIt = transactionHistory.find(transactionId);
         if (txnIt != transactionHistory.end())
         {
             history.push_back(txnIt->second); // Add transaction to history
         }
     }
+    // Archived rows are older than anything still live, so only top up from the archive
+    if (history.size() < static_cast<size_t>(limit) && archive->getSegmentCount() > 0)
+    {
+        vector<Transaction> archived = archive->findByAccount(accountNumber, limit - history.size());
+        history.insert(history.end(), archived.begin(), archived.end());
+    }
     // Sort history by timestamp (newest first)
     sort(history.begin(), history.end(), [](const Transaction &a, const Transaction &b)
          {
@@ -677,17 +1514,25 @@ vector<Transaction> TransactionManager::getAccountHistory(string accountNumber,
 // Get customer transaction history
 vector<Transaction> TransactionManager::getCustomerHistory(string customerId, int limit) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::getCustomerHistory");
+    TraceSpan span("query.customer_history", "query");
     vector<Transaction> history;
     auto range = customerTransactions.equal_range(customerId);
     for (auto it = range.first; it != range.second && history.size() < static_cast<size_t>(limit); ++it)
     {
-        const string &transactionId = it->second;
+        const pmr::string &transactionId = it->second;
         auto txnIt = transactionHistory.find(transactionId);
         if (txnIt != transactionHistory.end())
         {
             history.push_back(txnIt->second); // Add transaction to history
         }
     }
+    // Archived rows are older than anything still live, so only top up from the archive
+    if (history.size() < static_cast<size_t>(limit) && archive->getSegmentCount() > 0)
+    {
+        vector<Transaction> archived = archive->findByCustomer(customerId, limit - history.size());
+        history.insert(history.end(), archived.begin(), archived.end());
+    }
     // Sort history by timestamp (newest first)
     sort(history.begin(), history.end(), [](const Transaction &a, const Transaction &b)
          {
@@ -700,6 +1545,8 @@ vector<Transaction> TransactionManager::getCustomerHistory(string customerId, in
 // Get transactions by type
 vector<Transaction> TransactionManager::getTransactionsByType(TransactionType type, int limit) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::getTransactionsByType");
+    TraceSpan span("query.by_type", "query");
     vector<Transaction> transactions;
     for (const auto &pair : transactionHistory)
     {
@@ -726,6 +1573,7 @@ vector<Transaction> TransactionManager::getTransactionsByType(TransactionType ty
 // Display transaction history for account
 void TransactionManager::displayTransactionHistory(string accountNumber, int limit) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::displayTransactionHistory");
     vector<Transaction> history = getAccountHistory(accountNumber, limit);
     cout << "Transaction History for Account: " << accountNumber << endl;
     cout << "--------------------------------------------------------" << endl;
@@ -759,6 +1607,7 @@ void TransactionManager::displayTransactionHistory(string accountNumber, int lim
 // Get total deposits for account
 double TransactionManager::getTotalDeposits(string accountNumber, string startDate, string endDate) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::getTotalDeposits");
     double totalDeposits = 0.0;
     vector<Transaction> history = getAccountHistory(accountNumber, INT_MAX); // Get all transactions
     for (const Transaction &txn : history)
@@ -791,6 +1640,8 @@ string TransactionManager::generateTransactionId()
 // Save transaction history to file
 bool TransactionManager::saveTransactionHistory() const
 {
+    METRICS_TIME_SCOPE("TransactionManager::saveTransactionHistory");
+    TraceSpan span("ledger.save", "ledger");
     ofstream file(logFilePath);
     if (!file.is_open())
     {
@@ -800,22 +1651,14 @@ bool TransactionManager::saveTransactionHistory() const
     file << transactionHistory.size() << endl; // Write number of transactions
     for (const auto &pair : transactionHistory)
     {
-        const Transaction &txn = pair.second;
-        file << txn.getTransactionId() << " "
-             << txn.getAccountNumber() << " "
-             << txn.getRelatedAccountNumber() << " "
-             << static_cast<int>(txn.getTransactionType()) << " "
-             << fixed << setprecision(2) << txn.getAmount() << " "
-             << fixed << setprecision(2) << txn.getBalanceBefore() << " "
-             << fixed << setprecision(2) << txn.getBalanceAfter() << " "
-             << txn.getTimestamp() << " "
-             << txn.getDescription() << " "
-             << static_cast<int>(txn.getStatus()) << " "
-             << txn.getCustomerId() << " "
-             << txn.getSessionId() << " "
-             << txn.getNotes() << endl;
+        file << pair.second.toRecord() << '\n'; // Same record as the WAL and checkpoint, request key included
     }
     file.close();
+    if (file.fail())
+    {
+        cout << "Failed to write transaction history file: " << logFilePath << endl;
+        return false;
+    }
     cout << "Transaction history saved successfully to: " << logFilePath << endl;
     return true;
 }
@@ -823,6 +1666,8 @@ bool TransactionManager::saveTransactionHistory() const
 // Load transaction history from file
 bool TransactionManager::loadTransactionHistory()
 {
+    METRICS_TIME_SCOPE("TransactionManager::loadTransactionHistory");
+    TraceSpan span("ledger.load", "ledger");
     ifstream file(logFilePath);
     if (!file.is_open())
     {
@@ -838,39 +1683,42 @@ bool TransactionManager::loadTransactionHistory()
         Transaction transaction;
         string line;
         getline(file, line);
-        istringstream iss(line);
-        string txnId, accNum, relatedAccNum, typeStr, desc, timestamp,
-            statusStr, custId, sessionId, notes;
-        double amount, beforeBal, afterBal;
-        int typeInt = 0, statusInt = 0;
-        iss >> txnId >> accNum >> relatedAccNum >> typeInt >> amount >> beforeBal >> afterBal >> timestamp >> desc >> statusStr >> custId >> sessionId >> notes;
-        transaction = Transaction(txnId, accNum, static_cast<TransactionType>(typeInt),
-                                  amount, desc, beforeBal, afterBal, custId);
-        transaction.setRelatedAccountNumber(relatedAccNum);
-        transaction.setSessionId(sessionId);
-        transaction.setNotes(notes);
-        transaction.setStatus(static_cast<TransactionStatus>(statusInt));
-        // Add to transaction history
-        transactionHistory[txnId] = transaction;
-        // Add to account transactions
-        accountTransactions.emplace(accNum, txnId);
-        // Add to customer transactions
-        customerTransactions.emplace(custId, txnId);
-        // Add to date transactions
-        dateTransactions.emplace(timestamp.substr(0, 10), txnId); // Use date part
-        // Update next transaction number
-        size_t lastDash = txnId.find_last_of('-');
-        if (lastDash != string::npos && lastDash + 1 < txnId.length())
+        if (!Transaction::fromRecord(line, transaction))
         {
-            string numericPart = txnId.substr(lastDash + 1);
-            int txnNumber = stoi(numericPart);
-            if (nextTransactionNumber <= txnNumber)
+            // Space-separated row written by earlier versions
+            istringstream iss(line);
+            string txnId, accNum, relatedAccNum, typeStr, desc, timestamp,
+                statusStr, custId, sessionId, notes;
+            double amount, beforeBal, afterBal;
+            int typeInt = 0, statusInt = 0;
+            iss >> txnId >> accNum >> relatedAccNum >> typeInt >> amount >> beforeBal >> afterBal >> timestamp >> desc >> statusStr >> custId >> sessionId >> notes;
+            auto parsed = from_chars(statusStr.data(), statusStr.data() + statusStr.size(), statusInt);
+            if (parsed.ec != errc() || statusInt < 0 || statusInt >= static_cast<int>(TRANSACTION_STATUS_COUNT))
             {
-                nextTransactionNumber = txnNumber + 1;
+                statusInt = static_cast<int>(TransactionStatus::FAILED); // Unreadable: never counted as settled
             }
+            transaction = Transaction(txnId, accNum, static_cast<TransactionType>(typeInt),
+                                      amount, desc, beforeBal, afterBal, custId);
+            transaction.setRelatedAccountNumber(relatedAccNum);
+            transaction.setSessionId(sessionId);
+            transaction.setNotes(notes);
+            transaction.setStatus(static_cast<TransactionStatus>(statusInt));
         }
+        // Add to transaction history (moved, not copied)
+        const Transaction &stored = storeTransaction(transactionHistory, move(transaction));
+        const string &txnId = stored.getTransactionId();
+        // Add to account transactions
+        accountTransactions.emplace(stored.getAccountNumber(), txnId);
+        // Add to customer transactions
+        customerTransactions.emplace(stored.getCustomerId(), txnId);
+        // Add to date transactions
+        dateTransactions.emplace(stored.getTimestamp().substr(0, 10), txnId); // Use date part
+        // Update next transaction number
+        updateNextTransactionNumber(txnId);
     }
     file.close();
+    invalidateSnapshot();
+    rebuildRollups();
     cout << "Loaded " << transactionCount << " transactions." << endl;
     return true; // Successfully loaded
 }
@@ -878,56 +1726,183 @@ bool TransactionManager::loadTransactionHistory()
 // Display transaction statistics
 void TransactionManager::displayTransactionStatistics() const
 {
+    METRICS_TIME_SCOPE("TransactionManager::displayTransactionStatistics");
+    TransactionStatistics stats = computeStatistics();
     cout << "Transaction Statistics:" << endl;
     cout << "----------------------------------------" << endl;
-    cout << "Total Transactions: " << transactionHistory.size() << endl;
-    double totalVolume = 0.0;
-    int successfulCount = 0;
-    int failedCount = 0;
-    for (const auto &pair : transactionHistory)
+    cout << "Total Transactions: " << stats.totalTransactions << endl;
+    cout << "Total Volume: " << fixed << setprecision(2) << stats.totalVolume << endl;
+    cout << "Successful Transactions: " << stats.statusCounts[static_cast<size_t>(TransactionStatus::COMPLETED)] << endl;
+    cout << "Failed Transactions: " << stats.statusCounts[static_cast<size_t>(TransactionStatus::FAILED)] << endl;
+    cout << "----------------------------------------" << endl;
+    cout << "Transaction Status Breakdown:" << endl;
+    for (size_t i = 0; i < TRANSACTION_STATUS_COUNT; i++)
     {
-        const Transaction &txn = pair.second;
-        totalVolume += txn.getNetAmount(); // Sum net amounts
-        if (txn.getStatus() == TransactionStatus::COMPLETED)
-        {
-            successfulCount++;
-        }
-        else if (txn.getStatus() == TransactionStatus::FAILED)
+        if (stats.statusCounts[i] == 0)
         {
-            failedCount++;
+            continue;
         }
+        cout << "Status: " << transactionStatusToString(static_cast<TransactionStatus>(i))
+             << ", Count: " << stats.statusCounts[i]
+             << ", Amount: " << fixed << setprecision(2) << stats.statusAmounts[i] << endl;
     }
-    cout << "Total Volume: " << fixed << setprecision(2) << totalVolume << endl;
-    cout << "Successful Transactions: " << successfulCount << endl;
-    cout << "Failed Transactions: " << failedCount << endl;
     cout << "----------------------------------------" << endl;
     cout << "Transaction Types Breakdown:" << endl;
-    map<TransactionType, int> typeCount;
-    for (const auto &pair : transactionHistory)
-    {
-        const Transaction &txn = pair.second;
-        typeCount[txn.getTransactionType()]++; // Count each type
-    }
-    for (const auto &pair : typeCount)
+    for (size_t i = 0; i < TRANSACTION_TYPE_COUNT; i++)
     {
-        cout << "Type: " << static_cast<int>(pair.first)
-             << ", Count: " << pair.second << endl;
+        if (stats.typeCounts[i] == 0)
+        {
+            continue;
+        }
+        cout << "Type: " << transactionTypeToString(static_cast<TransactionType>(i))
+             << ", Count: " << stats.typeCounts[i]
+             << ", Amount: " << fixed << setprecision(2) << stats.typeAmounts[i] << endl;
     }
     cout << "----------------------------------------" << endl;
     cout << "End of Transaction Statistics" << endl;
     cout << "----------------------------------------" << endl;
 }
+
+// Compute ledger statistics in one pass (per-thread accumulators, then merge)
+TransactionStatistics TransactionManager::computeStatistics() const
+{
+    METRICS_TIME_SCOPE("TransactionManager::computeStatistics");
+    TraceSpan span("statistics", "query");
+    TransactionStatistics stats;
+    if (transactionHistory.size() < PARALLEL_SCAN_THRESHOLD)
+    {
+        for (const auto &pair : transactionHistory)
+        {
+            stats.add(pair.second);
+        }
+        return stats;
+    }
+
+    // Several key ranges per worker, each taken by the next free worker (see partitionHistory)
+    ThreadPool &pool = getWorkerPool();
+    size_t workers = pool.getThreadCount();
+    size_t partitions = workers * RANGES_PER_WORKER;
+    vector<TransactionMap::const_iterator> bounds = partitionHistory(partitions);
+
+    vector<TransactionStatistics> partials(partitions);
+    atomic<size_t> nextRange(0);
+    pool.parallelFor(workers, [&](size_t, size_t, size_t)
+                     {
+                         TraceSpan partitionSpan("statistics.partition", "query");
+                         for (size_t p = nextRange++; p < partitions; p = nextRange++)
+                         {
+                             for (auto txnIt = bounds[p]; txnIt != bounds[p + 1]; ++txnIt)
+                             {
+                                 partials[p].add(txnIt->second);
+                             }
+                         } });
+    for (const TransactionStatistics &partial : partials)
+    {
+        stats.merge(partial);
+    }
+    return stats;
+}
+
+// Split transactionHistory into contiguous ranges without walking it: the
+// bounds are lower_bound lookups of keys spaced evenly between the first and
+// last transaction ID. The keys after their shared prefix are read as numbers
+// whose digits are the characters in use (digits only for generated IDs), so
+// ranges are about even when IDs are spread evenly over that span; callers
+// take several ranges per worker to even out the rest.
+vector<TransactionMap::const_iterator> TransactionManager::partitionHistory(size_t partitions) const
+{
+    vector<TransactionMap::const_iterator> bounds;
+    bounds.reserve(partitions + 1);
+    bounds.push_back(transactionHistory.begin());
+    if (partitions > 1 && transactionHistory.size() > 1)
+    {
+        string_view first = transactionHistory.begin()->first;
+        string_view last = transactionHistory.rbegin()->first;
+        size_t prefix = 0;
+        while (prefix < first.size() && prefix < last.size() && first[prefix] == last[prefix])
+        {
+            prefix++;
+        }
+        // Characters in use after the prefix; digit 0 stands for "end of key"
+        unsigned char lowest = 255, highest = 0;
+        for (const string_view *key : {&first, &last})
+        {
+            for (size_t i = prefix; i < key->size(); i++)
+            {
+                lowest = min(lowest, static_cast<unsigned char>((*key)[i]));
+                highest = max(highest, static_cast<unsigned char>((*key)[i]));
+            }
+        }
+        long double base = highest - lowest + 2.0L;
+        size_t digits = max<size_t>(1, static_cast<size_t>(60.0L / log2l(base)));
+        auto keyValue = [&](string_view key)
+        {
+            long double value = 0;
+            for (size_t i = 0; i < digits; i++)
+            {
+                int digit = 0;
+                if (prefix + i < key.size())
+                {
+                    int offset = static_cast<unsigned char>(key[prefix + i]) - lowest + 1;
+                    digit = min(max(offset, 1), static_cast<int>(base) - 1);
+                }
+                value = value * base + digit;
+            }
+            return value;
+        };
+        long double low = keyValue(first);
+        long double span = keyValue(last) - low;
+        vector<int> keyDigits(digits);
+        for (size_t p = 1; p < partitions; p++)
+        {
+            long double value = floorl(low + span * p / partitions);
+            for (size_t i = digits; i-- > 0;)
+            {
+                long double quotient = floorl(value / base);
+                keyDigits[i] = static_cast<int>(value - quotient * base);
+                value = quotient;
+            }
+            string key(first.substr(0, prefix));
+            for (size_t i = 0; i < digits && keyDigits[i] != 0; i++)
+            {
+                key.push_back(static_cast<char>(lowest + keyDigits[i] - 1));
+            }
+            bounds.push_back(transactionHistory.lower_bound(key));
+        }
+    }
+    while (bounds.size() < partitions)
+    {
+        bounds.push_back(transactionHistory.end());
+    }
+    bounds.push_back(transactionHistory.end());
+    return bounds;
+}
+
+// Get the shared worker pool
+ThreadPool &TransactionManager::getWorkerPool() const
+{
+    return *workerPool;
+}
+
 // Process fee charge transaction
 string TransactionManager::processFeeCharge(string accountNumber, double amount, string description,
-                                            double balanceBefore, double balanceAfter, string customerId)
+                                            double balanceBefore, double balanceAfter, string customerId,
+                                            string idempotencyKey)
 {
+    METRICS_TIME_SCOPE("TransactionManager::processFeeCharge");
+    if (refuseCommittedRequest(idempotencyKey))
+    {
+        return "";
+    }
     string transactionId = generateTransactionId();
-    Transaction transaction(transactionId, accountNumber, TransactionType::FEE_CHARGE, amount,
-                            description, balanceBefore, balanceAfter, customerId);
+    Transaction transaction(transactionId, move(accountNumber), TransactionType::FEE_CHARGE, amount,
+                            move(description), balanceBefore, balanceAfter, move(customerId));
     transaction.setStatus(TransactionStatus::COMPLETED); // Set status to completed
-    if (addTransaction(transaction))
+    transaction.setIdempotencyKey(move(idempotencyKey));
+    if (addTransaction(move(transaction)))
     {
         cout << "Fee charge transaction processed successfully: " << transactionId << endl;
+        rememberIdempotencyKey(transactionId);
         return transactionId; // Return the transaction ID
     }
     else
@@ -939,15 +1914,23 @@ string TransactionManager::processFeeCharge(string accountNumber, double amount,
 
 // Process interest credit transaction
 string TransactionManager::processInterestCredit(string accountNumber, double amount, string description,
-                                                 double balanceBefore, double balanceAfter, string customerId)
+                                                 double balanceBefore, double balanceAfter, string customerId,
+                                                 string idempotencyKey)
 {
+    METRICS_TIME_SCOPE("TransactionManager::processInterestCredit");
+    if (refuseCommittedRequest(idempotencyKey))
+    {
+        return "";
+    }
     string transactionId = generateTransactionId();
-    Transaction transaction(transactionId, accountNumber, TransactionType::INTEREST_CREDIT, amount,
-                            description, balanceBefore, balanceAfter, customerId);
+    Transaction transaction(transactionId, move(accountNumber), TransactionType::INTEREST_CREDIT, amount,
+                            move(description), balanceBefore, balanceAfter, move(customerId));
     transaction.setStatus(TransactionStatus::COMPLETED); // Set status to completed
-    if (addTransaction(transaction))
+    transaction.setIdempotencyKey(move(idempotencyKey));
+    if (addTransaction(move(transaction)))
     {
         cout << "Interest credit transaction processed successfully: " << transactionId << endl;
+        rememberIdempotencyKey(transactionId);
         return transactionId; // Return the transaction ID
     }
     else
@@ -960,18 +1943,21 @@ string TransactionManager::processInterestCredit(string accountNumber, double am
 // Get transactions by date range
 vector<Transaction> TransactionManager::getTransactionsByDateRange(string startDate, string endDate) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::getTransactionsByDateRange");
+    TraceSpan span("query.date_range", "query");
     vector<Transaction> transactions;
-    for (const auto &pair : dateTransactions)
+    if (archive->getSegmentCount() > 0)
+    {
+        transactions = archive->findByDateRange(startDate, endDate); // Sparse index skips other months
+    }
+    auto first = dateTransactions.lower_bound(startDate);
+    auto last = dateTransactions.upper_bound(endDate);
+    for (auto pairIt = first; pairIt != last && startDate <= endDate; ++pairIt)
     {
-        const string &date = pair.first;
-        const string &transactionId = pair.second;
-        if (date >= startDate && date <= endDate)
+        auto it = transactionHistory.find(pairIt->second);
+        if (it != transactionHistory.end())
         {
-            auto it = transactionHistory.find(transactionId);
-            if (it != transactionHistory.end())
-            {
-                transactions.push_back(it->second); // Add transaction to vector
-            }
+            transactions.push_back(it->second); // Add transaction to vector
         }
     }
     // Sort transactions by timestamp (newest first)
@@ -987,6 +1973,8 @@ vector<Transaction> TransactionManager::getTransactionsByDateRange(string startD
 // Get transactions by amount range
 vector<Transaction> TransactionManager::getTransactionsByAmountRange(double minAmount, double maxAmount) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::getTransactionsByAmountRange");
+    TraceSpan span("query.amount_range", "query");
     vector<Transaction> transactions;
     for (const auto &pair : transactionHistory)
     {
@@ -1010,6 +1998,7 @@ vector<Transaction> TransactionManager::getTransactionsByAmountRange(double minA
 // Get failed transactions
 vector<Transaction> TransactionManager::getFailedTransactions() const
 {
+    METRICS_TIME_SCOPE("TransactionManager::getFailedTransactions");
     vector<Transaction> failedTransactions;
     for (const auto &pair : transactionHistory)
     {
@@ -1031,6 +2020,7 @@ vector<Transaction> TransactionManager::getFailedTransactions() const
 // Get pending transactions
 vector<Transaction> TransactionManager::getPendingTransactions() const
 {
+    METRICS_TIME_SCOPE("TransactionManager::getPendingTransactions");
     vector<Transaction> pendingTransactions;
     for (const auto &pair : transactionHistory)
     {
@@ -1052,6 +2042,7 @@ vector<Transaction> TransactionManager::getPendingTransactions() const
 // Get total withdrawals for account
 double TransactionManager::getTotalWithdrawals(string accountNumber, string startDate, string endDate) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::getTotalWithdrawals");
     double totalWithdrawals = 0.0;
     vector<Transaction> history = getAccountHistory(accountNumber, INT_MAX); // Get all transactions
     for (const Transaction &txn : history)
@@ -1074,6 +2065,7 @@ double TransactionManager::getTotalWithdrawals(string accountNumber, string star
 // Get net flow for account
 double TransactionManager::getNetFlow(string accountNumber, string startDate, string endDate) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::getNetFlow");
     double totalDeposits = getTotalDeposits(accountNumber, startDate, endDate);
     double totalWithdrawals = getTotalWithdrawals(accountNumber, startDate, endDate);
     double netFlow = totalDeposits - totalWithdrawals;
@@ -1085,6 +2077,7 @@ double TransactionManager::getNetFlow(string accountNumber, string startDate, st
 // Get transaction count for account
 int TransactionManager::getTransactionCount(string accountNumber, string startDate, string endDate) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::getTransactionCount");
     vector<Transaction> history = getAccountHistory(accountNumber, INT_MAX); // Get all transactions
     int count = 0;
     for (const Transaction &txn : history)
@@ -1103,6 +2096,7 @@ int TransactionManager::getTransactionCount(string accountNumber, string startDa
 // Get average transaction amount by type
 double TransactionManager::getAverageTransactionAmount(string accountNumber, TransactionType type) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::getAverageTransactionAmount");
     vector<Transaction> history = getAccountHistory(accountNumber, INT_MAX); // Get all transactions
     double totalAmount = 0.0;
     int count = 0;
@@ -1130,77 +2124,48 @@ string TransactionManager::getCurrentDateTime() const
 // Display customer transaction summary
 void TransactionManager::displayCustomerTransactionSummary(string customerId) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::displayCustomerTransactionSummary");
     cout << "\n=== Transaction Summary for Customer: " << customerId << " ===" << endl;
 
-    vector<Transaction> customerTxns = getCustomerHistory(customerId, 100);
-    if (customerTxns.empty())
+    // Lifetime totals across all of the customer's accounts, maintained on commit
+    const CustomerSummary *summary = customerSummaries->find(customerId);
+    if (summary == nullptr || summary->getTotal().count == 0)
     {
         cout << "No transactions found for this customer." << endl;
         return;
     }
-
-    // Calculate statistics
-    double totalDeposits = 0, totalWithdrawals = 0, totalTransfers = 0, totalFees = 0, totalInterest = 0;
-    int depositCount = 0, withdrawalCount = 0, transferCount = 0, feeCount = 0, interestCount = 0, otherCount = 0;
-
-    for (const auto &txn : customerTxns)
-    {
-        switch (txn.getTransactionType())
-        {
-        case TransactionType::DEPOSIT:
-            totalDeposits += txn.getAmount();
-            depositCount++;
-            break;
-        case TransactionType::WITHDRAWAL:
-            totalWithdrawals += txn.getAmount();
-            withdrawalCount++;
-            break;
-        case TransactionType::TRANSFER_IN:
-        case TransactionType::TRANSFER_OUT:
-            totalTransfers += txn.getAmount();
-            transferCount++;
-            break;
-        case TransactionType::FEE_CHARGE:
-            totalFees += txn.getAmount();
-            feeCount++;
-            break;
-        case TransactionType::INTEREST_CREDIT:
-            totalInterest += txn.getAmount();
-            interestCount++;
-            break;
-        case TransactionType::ACCOUNT_OPENING:
-        case TransactionType::ACCOUNT_CLOSING:
-        default:
-            otherCount++;
-            break;
-        }
-    }
-
-    // Update the display section to include new categories:
-    cout << "Total Transactions: " << customerTxns.size() << endl;
-    cout << "Deposits: " << depositCount << " ($" << fixed << setprecision(2) << totalDeposits << ")" << endl;
-    cout << "Withdrawals: " << withdrawalCount << " ($" << fixed << setprecision(2) << totalWithdrawals << ")" << endl;
-    cout << "Transfers: " << transferCount << " ($" << fixed << setprecision(2) << totalTransfers << ")" << endl;
-    cout << "Fees: " << feeCount << " ($" << fixed << setprecision(2) << totalFees << ")" << endl;
-    cout << "Interest: " << interestCount << " ($" << fixed << setprecision(2) << totalInterest << ")" << endl;
+    auto typeTotals = [summary](TransactionType type)
+    {
+        return summary->typeTotals[static_cast<size_t>(type)];
+    };
+    RollupTotals deposits = typeTotals(TransactionType::DEPOSIT);
+    RollupTotals withdrawals = typeTotals(TransactionType::WITHDRAWAL);
+    RollupTotals transfers = typeTotals(TransactionType::TRANSFER_IN);
+    transfers.merge(typeTotals(TransactionType::TRANSFER_OUT));
+    RollupTotals fees = typeTotals(TransactionType::FEE_CHARGE);
+    RollupTotals interest = typeTotals(TransactionType::INTEREST_CREDIT);
+    int64_t totalCount = summary->getTotal().count;
+    int64_t otherCount = totalCount - deposits.count - withdrawals.count - transfers.count - fees.count - interest.count;
+
+    cout << "Total Transactions: " << totalCount << endl;
+    cout << "Deposits: " << deposits.count << " ($" << fixed << setprecision(2) << deposits.amount << ")" << endl;
+    cout << "Withdrawals: " << withdrawals.count << " ($" << fixed << setprecision(2) << withdrawals.amount << ")" << endl;
+    cout << "Transfers: " << transfers.count << " ($" << fixed << setprecision(2) << transfers.amount << ")" << endl;
+    cout << "Fees: " << fees.count << " ($" << fixed << setprecision(2) << fees.amount << ")" << endl;
+    cout << "Interest: " << interest.count << " ($" << fixed << setprecision(2) << interest.amount << ")" << endl;
     cout << "Other: " << otherCount << endl;
-    cout << "Net Flow: $" << fixed << setprecision(2) << (totalDeposits + totalInterest - totalWithdrawals - totalFees) << endl;
+    cout << "Net Flow: $" << fixed << setprecision(2) << (deposits.amount + interest.amount - withdrawals.amount - fees.amount) << endl;
 
     // Display recent transactions
     cout << "\nRecent Transactions (Last 5):" << endl;
     cout << left << setw(15) << "Transaction ID" << setw(12) << "Type" << setw(10) << "Amount" << setw(12) << "Date" << endl;
     cout << string(50, '-') << endl;
-
-    int count = 0;
-    for (const auto &txn : customerTxns)
+    for (const RecentTransaction &txn : summary->getRecent(5))
     {
-        if (count >= 5)
-            break;
-        cout << left << setw(15) << txn.getTransactionId()
-             << setw(12) << txn.getTransactionTypeString()
-             << setw(10) << fixed << setprecision(2) << txn.getAmount()
-             << setw(12) << txn.getTimestamp().substr(0, 10) << endl;
-        count++;
+        cout << left << setw(15) << txn.transactionId
+             << setw(12) << transactionTypeToString(txn.type)
+             << setw(10) << fixed << setprecision(2) << txn.amount
+             << setw(12) << txn.date << endl;
     }
     cout << "======================================================" << endl;
 }
@@ -1213,16 +2178,13 @@ int TransactionManager::getTotalTransactionCount() const
 // Get total system volume
 double TransactionManager::getTotalSystemVolume() const
 {
-    double totalVolume = 0.0;
-    for (const auto &txn : transactionHistory)
-    {
-        totalVolume += txn.second.getNetAmount(); // Sum net amounts of all transactions
-    }
-    return totalVolume;
+    METRICS_TIME_SCOPE("TransactionManager::getTotalSystemVolume");
+    return computeStatistics().totalVolume;
 }
 // Display transactions by type
 void TransactionManager::displayTransactionsByType(TransactionType type, int limit) const
 {
+    METRICS_TIME_SCOPE("TransactionManager::displayTransactionsByType");
     vector<Transaction> transactions = getTransactionsByType(type, limit);
     cout << "Transactions of Type: " << static_cast<int>(type) << endl;
     cout << "--------------------------------------------------------" << endl;
@@ -1261,44 +2223,32 @@ void TransactionManager::displayTransactionsByType(TransactionType type, int lim
 // Display daily transaction summary
 void TransactionManager::displayDailyTransactionSummary(string date) const
 {
-    vector<Transaction> transactions = getTransactionsByDateRange(date, date);
-    if (transactions.empty())
+    METRICS_TIME_SCOPE("TransactionManager::displayDailyTransactionSummary");
+    RollupTable totals = rollups->getDay(date); // Per-type totals without touching the ledger
+    if (totals.getTotal().count == 0)
     {
         cout << "No transactions found for date: " << date << endl;
         return; // No transactions for the date
     }
 
-    // Group transactions by type
-    map<TransactionType, vector<Transaction>> groupedTransactions;
-    for (const auto &txn : transactions)
-    {
-        groupedTransactions[txn.getTransactionType()].push_back(txn);
-    }
-
-    // Calculate totals for each type
-    map<TransactionType, double> typeTotals;
-    for (const auto &[type, txns] : groupedTransactions)
-    {
-        double total = 0.0;
-        for (const auto &txn : txns)
-        {
-            total += txn.getAmount();
-        }
-        typeTotals[type] = total;
-    }
-
     // Display report
     cout << "Daily Transaction Summary for Date: " << date << endl;
     cout << "--------------------------------------------------------" << endl;
-    for (const auto &[type, total] : typeTotals)
+    for (size_t type = 0; type < TRANSACTION_TYPE_COUNT; type++)
     {
-        cout << "Transaction Type: " << static_cast<int>(type) << endl;
-        cout << "Total Transactions: " << groupedTransactions[type].size() << endl;
-        cout << "Total Amount: " << fixed << setprecision(2) << total << endl;
+        RollupTotals typeTotals = totals.getType(static_cast<TransactionType>(type));
+        if (typeTotals.count == 0)
+        {
+            continue;
+        }
+        cout << "Transaction Type: " << type << endl;
+        cout << "Total Transactions: " << typeTotals.count << endl;
+        cout << "Total Amount: " << fixed << setprecision(2) << typeTotals.amount << endl;
         cout << "--------------------------------------------------------" << endl;
     }
 
     // Display all transactions
+    vector<Transaction> transactions = getTransactionsByDateRange(date, date);
     cout << "All Transactions for Date: " << date << endl;
     cout << "--------------------------------------------------------" << endl;
     for (const auto &txn : transactions)
@@ -1311,14 +2261,45 @@ void TransactionManager::displayDailyTransactionSummary(string date) const
              << setw(30) << txn.getDescription() << endl;
     }
     cout << "--------------------------------------------------------" << endl;
-    double netFlow = 0.0;
-    for (const auto &txn : transactions)
+    cout << "Net Flow for Date: " << date << " is " << fixed << setprecision(2) << totals.getTotal().netAmount << endl;
+    cout << "--------------------------------------------------------" << endl;
+    cout << "End of Daily Transaction Summary" << endl;
+    cout << "--------------------------------------------------------" << endl;
+}
+
+// Display monthly transaction summary (type x status totals from the rollups)
+void TransactionManager::displayMonthlyTransactionSummary(string month) const
+{
+    METRICS_TIME_SCOPE("TransactionManager::displayMonthlyTransactionSummary");
+    RollupTable totals = rollups->getMonth(month);
+    if (totals.getTotal().count == 0)
     {
-        netFlow += txn.getNetAmount(); // Calculate net flow for the day
+        cout << "No transactions found for month: " << month << endl;
+        return;
     }
-    cout << "Net Flow for Date: " << date << " is " << fixed << setprecision(2) << netFlow << endl;
+    cout << "Monthly Transaction Summary for: " << month << endl;
     cout << "--------------------------------------------------------" << endl;
-    cout << "End of Daily Transaction Summary" << endl;
+    cout << left << setw(20) << "Type" << setw(12) << "Status" << right << setw(10) << "Count"
+         << setw(18) << "Amount" << endl;
+    for (size_t type = 0; type < TRANSACTION_TYPE_COUNT; type++)
+    {
+        for (size_t status = 0; status < TRANSACTION_STATUS_COUNT; status++)
+        {
+            const RollupTotals &cell = totals.cells[type][status];
+            if (cell.count == 0)
+            {
+                continue;
+            }
+            cout << left << setw(20) << transactionTypeToString(static_cast<TransactionType>(type))
+                 << setw(12) << transactionStatusToString(static_cast<TransactionStatus>(status))
+                 << right << setw(10) << cell.count
+                 << setw(18) << fixed << setprecision(2) << cell.amount << endl;
+        }
+    }
+    RollupTotals all = totals.getTotal();
+    cout << "--------------------------------------------------------" << endl;
+    cout << "Total Transactions: " << all.count << endl;
+    cout << "Net Flow for Month: " << month << " is " << fixed << setprecision(2) << all.netAmount << endl;
     cout << "--------------------------------------------------------" << endl;
 }
 // Validate transaction ID format
@@ -1349,94 +2330,524 @@ string TransactionManager::getCurrentDate() const
 // Export transactions to CSV
 bool TransactionManager::exportTransactionsToCSV(string filename, string accountNumber) const
 {
-    ofstream file(filename);
+    METRICS_TIME_SCOPE("TransactionManager::exportTransactionsToCSV");
+    TraceSpan span("export.csv", "export");
+    ofstream file(filename, ios::binary);
     if (!file.is_open())
     {
         cout << "Failed to open file for writing: " << filename << endl;
         return false; // File could not be opened
     }
 
-    // Write CSV header
-    file << "ID,Account,Type,Amount,Date,Status,Description" << endl;
+    vector<const Transaction *> rows = selectExportRows(accountNumber);
 
-    // Write each transaction as CSV row
-    for (const auto &txn : transactionHistory)
-    {
-        if (!accountNumber.empty() && txn.second.getAccountNumber() != accountNumber)
+    // Write CSV header
+    const string header = "ID,Account,Type,Amount,Date,Status,Description\n";
+    file.write(header.data(), header.size());
+
+    // Format blocks of rows in parallel, then write them in order; one wave of
+    // blocks per pass keeps memory bounded regardless of ledger size
+    size_t blockCount = (rows.size() + CSV_BLOCK_ROWS - 1) / CSV_BLOCK_ROWS;
+    ThreadPool *pool = rows.size() < PARALLEL_SCAN_THRESHOLD ? nullptr : &getWorkerPool();
+    size_t blocksPerWave = pool ? pool->getThreadCount() * 2 : 1;
+    vector<string> blocks(blocksPerWave);
+    for (size_t waveStart = 0; waveStart < blockCount; waveStart += blocksPerWave)
+    {
+        size_t waveBlocks = min(blocksPerWave, blockCount - waveStart);
+        auto formatBlocks = [&](size_t begin, size_t end, size_t)
         {
-            continue; // Skip transactions not matching accountNumber
+            TraceSpan formatSpan("export.csv.format", "export");
+            for (size_t b = begin; b < end; b++)
+            {
+                size_t firstRow = (waveStart + b) * CSV_BLOCK_ROWS;
+                size_t lastRow = min(rows.size(), firstRow + CSV_BLOCK_ROWS);
+                string &block = blocks[b];
+                block.clear();
+                block.reserve((lastRow - firstRow) * 96);
+                for (size_t r = firstRow; r < lastRow; r++)
+                {
+                    appendCsvRow(block, *rows[r]);
+                }
+            }
+        };
+        if (pool)
+        {
+            pool->parallelFor(waveBlocks, formatBlocks);
+        }
+        else
+        {
+            formatBlocks(0, waveBlocks, 0);
+        }
+        TraceSpan writeSpan("export.csv.write", "export");
+        for (size_t b = 0; b < waveBlocks; b++)
+        {
+            file.write(blocks[b].data(), blocks[b].size());
         }
-        file << txn.second.getTransactionId() << ","
-             << txn.second.getAccountNumber() << ","
-             << static_cast<int>(txn.second.getTransactionType()) << ","
-             << fixed << setprecision(2) << txn.second.getAmount() << ","
-             << txn.second.getTimestamp().substr(0, 10) << ","
-             << txn.second.getStatusString() << ","
-             << txn.second.getDescription() << endl;
     }
 
     file.close();
+    if (file.fail())
+    {
+        cout << "Failed to write CSV export: " << filename << endl;
+        return false; // Write error
+    }
+    cout << "Exported " << rows.size() << " transactions to: " << filename << endl;
     return true; // Export successful
 }
 
-// Create backup of transaction data
+// Export transactions to a columnar file (typed columns, dictionary strings, row group stats)
+bool TransactionManager::exportTransactionsToColumnar(string filename, string accountNumber,
+                                                      size_t rowGroupSize) const
+{
+    METRICS_TIME_SCOPE("TransactionManager::exportTransactionsToColumnar");
+    TraceSpan span("export.columnar", "export");
+    vector<const Transaction *> rows = selectExportRows(accountNumber);
+    ColumnarLedgerWriter writer(rowGroupSize);
+    if (!writer.write(filename, rows))
+    {
+        return false; // Writer reports the failure
+    }
+    cout << "Exported " << rows.size() << " transactions (columnar) to: " << filename << endl;
+    return true; // Export successful
+}
+
+// Select rows for an export
+vector<const Transaction *> TransactionManager::selectExportRows(const string &accountNumber) const
+{
+    vector<const Transaction *> rows;
+    if (!accountNumber.empty())
+    {
+        auto range = accountTransactions.equal_range(accountNumber);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            auto txnIt = transactionHistory.find(it->second);
+            if (txnIt != transactionHistory.end())
+            {
+                rows.push_back(&txnIt->second);
+            }
+        }
+        sort(rows.begin(), rows.end(), [](const Transaction *a, const Transaction *b)
+             { return a->getTransactionId() < b->getTransactionId(); });
+    }
+    else
+    {
+        rows.reserve(transactionHistory.size());
+        for (const auto &pair : transactionHistory)
+        {
+            rows.push_back(&pair.second);
+        }
+    }
+    return rows;
+}
+
+// Create backup of transaction data (incremental when a full set already exists)
 bool TransactionManager::createBackup(string backupPath) const
 {
-    string backupFile = backupPath + "/transaction_backup_" + getCurrentDateTime() + ".log";
-    ifstream src(logFilePath, ios::binary);
-    ofstream dst(backupFile, ios::binary);
-    if (!src.is_open() || !dst.is_open())
+    METRICS_TIME_SCOPE("TransactionManager::createBackup");
+    TraceSpan span("backup.create", "ledger");
+    return startBackup(move(backupPath), 0) && waitForBackup();
+}
+
+// Pin the ledger and write the backup set on a background thread
+bool TransactionManager::startBackup(string backupPath, size_t maxBytesPerSecond) const
+{
+    METRICS_TIME_SCOPE("TransactionManager::startBackup");
+    TraceSpan span("backup.snapshot", "ledger");
+    waitForBackup(); // One set at a time: whether the next is FULL depends on this one
+    auto job = make_unique<BackupJob>(backupPath);
+    job->full = lastBackupDirectory != job->manager.getBackupDirectory() ||
+                job->manager.getIncrementalsSinceFull() < 0 ||
+                job->manager.getIncrementalsSinceFull() >= MAX_INCREMENTAL_BACKUPS ||
+                backupJournalOverflowed;
+    backupJournalOverflowed = false; // A full set covers everything the journal dropped
+    job->maxBytesPerSecond = maxBytesPerSecond;
+    job->snapshot = getSnapshot();
+    if (job->full)
+    {
+        job->records.reserve(job->snapshot->size());
+        job->snapshot->forEach([&](const Transaction &transaction)
+                               { job->records.push_back(&transaction); });
+    }
+    else
+    {
+        // Only records added or changed since the previous set (each once)
+        sort(backupJournal.begin(), backupJournal.end());
+        backupJournal.erase(unique(backupJournal.begin(), backupJournal.end()), backupJournal.end());
+        for (const string &transactionId : backupJournal)
+        {
+            const Transaction *transaction = job->snapshot->findTransaction(transactionId);
+            if (transaction != nullptr)
+            {
+                job->records.push_back(transaction);
+            }
+        }
+    }
+    job->journal = move(backupJournal);
+    backupJournal.clear(); // Commits from here on belong to the next set
+
+    BackupJob *running = job.get();
+    running->writer = thread([running]
+                             {
+                                 Tracing::setThreadName("backup");
+                                 TraceSpan writeSpan("backup.write", "ledger");
+                                 running->succeeded = running->manager.writeBackup(running->records, running->full,
+                                                                                   running->entry, running->maxBytesPerSecond);
+                                 running->finished = true;
+                             });
+    backupJob = move(job);
+    return true;
+}
+
+// Check whether a background backup is still writing
+bool TransactionManager::isBackupInProgress() const
+{
+    return backupJob != nullptr && !backupJob->finished;
+}
+
+// Wait for the background backup and record its outcome
+bool TransactionManager::waitForBackup() const
+{
+    if (backupJob == nullptr)
     {
-        cout << "Failed to create backup file: " << backupFile << endl;
-        return false; // Backup file could not be opened
+        return true;
     }
-    dst << src.rdbuf(); // Copy contents
-    src.close();
-    dst.close();
-    cout << "Backup created successfully at: " << backupFile << endl;
+    unique_ptr<BackupJob> job = move(backupJob);
+    job->writer.join();
+    if (!job->succeeded)
+    {
+        cout << "Failed to create backup in: " << job->manager.getBackupDirectory() << endl;
+        if (job->full)
+        {
+            // Whatever made this set FULL still applies, so the next one is FULL too
+            backupJournal.clear();
+            backupJournalOverflowed = true;
+        }
+        else
+        {
+            // Keep the journal so the next attempt still covers these changes
+            backupJournal.insert(backupJournal.end(), job->journal.begin(), job->journal.end());
+            capBackupJournal();
+        }
+        return false;
+    }
+    lastBackupDirectory = job->manager.getBackupDirectory();
+    cout << (job->full ? "Full" : "Incremental") << " backup #" << job->entry.sequence << " created with "
+         << job->entry.recordCount << " records at: " << job->manager.getBackupDirectory()
+         << job->entry.fileName << endl;
     return true; // Backup successful
 }
 
+// Restore transaction history from the backup chain
+bool TransactionManager::restoreFromBackup(string backupPath, int upToSequence)
+{
+    METRICS_TIME_SCOPE("TransactionManager::restoreFromBackup");
+    TraceSpan span("backup.restore", "ledger");
+    waitForBackup(); // Its outcome must not land on top of the restored ledger
+    BackupManager manager(backupPath);
+    TransactionMap restored(&historyPool); // Same pool, so the move below just takes the nodes
+    if (!manager.restore(restored, upToSequence))
+    {
+        cout << "Restore failed; current transaction history left unchanged." << endl;
+        return false;
+    }
+    transactionHistory = move(restored);
+    invalidateSnapshot();
+    rebuildRollups();
+    reindexTransactions();
+    for (const auto &pair : transactionHistory)
+    {
+        updateNextTransactionNumber(pair.first);
+    }
+    backupJournal.clear();
+    backupJournalOverflowed = false;
+    checkpoint(); // The WAL no longer describes this ledger
+    lastBackupDirectory.clear(); // The restored state is not yet a backup base
+    cout << "Restored " << transactionHistory.size() << " transactions from: " << backupPath << endl;
+    return saveTransactionHistory();
+}
+
 // Cleanup old transactions (archival)
 void TransactionManager::cleanupOldTransactions(int daysOld)
 {
-    string cutoffDate = getCurrentDateTime(); // Placeholder for actual cutoff date calculation
-    cout << "Cleaning up transactions older than " << daysOld << " days..." << endl;
-    int removedCount = 0;
-    for (auto it = transactionHistory.begin(); it != transactionHistory.end();)
+    METRICS_TIME_SCOPE("TransactionManager::cleanupOldTransactions");
+    string cutoffDate = ::getDateDaysAgo(daysOld);
+    cout << "Archiving transactions older than " << daysOld << " days (before " << cutoffDate << ")..." << endl;
+    int archivedCount = archiveTransactionsBefore(cutoffDate);
+    cout << "Cleanup complete. Archived " << archivedCount << " old transactions." << endl;
+}
+
+// Move transactions dated before the cutoff (YYYY-MM-DD) into archive segments
+int TransactionManager::archiveTransactionsBefore(string cutoffDate)
+{
+    METRICS_TIME_SCOPE("TransactionManager::archiveTransactionsBefore");
+    TraceSpan span("archive", "ledger");
+    waitForBackup(); // Archiving resets the backup chain below
+    // The date index is ordered, so old rows are a prefix of it
+    vector<const Transaction *> rows;
+    auto cutoff = dateTransactions.lower_bound(cutoffDate);
+    for (auto it = dateTransactions.begin(); it != cutoff; ++it)
     {
-        const Transaction &txn = it->second;
-        if (txn.getTimestamp() < cutoffDate) // Check if transaction is older than cutoff
+        auto txnIt = transactionHistory.find(it->second);
+        if (txnIt != transactionHistory.end())
         {
-            // Remove from all indexes
-            accountTransactions.erase(txn.getAccountNumber());
-            customerTransactions.erase(txn.getCustomerId());
-            dateTransactions.erase(txn.getTimestamp().substr(0, 10)); // Use date part only
-            it = transactionHistory.erase(it);                        // Remove from history and get next iterator
-            removedCount++;                                           // Increment removed count
-            cout << "Removed transaction: " << txn.getTransactionId() << endl;
+            rows.push_back(&txnIt->second);
         }
-        else
+    }
+    if (rows.empty())
+    {
+        return 0; // Nothing old enough
+    }
+    if (!archive->archiveTransactions(rows))
+    {
+        cout << "Archiving failed; transactions kept in the live ledger." << endl;
+        return 0;
+    }
+
+    // Remove exactly the archived (key, transaction) pairs from every index
+    auto eraseIndexEntry = [](TransactionIndexMap &index, const string &key, const string &transactionId)
+    {
+        auto range = index.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second.compare(transactionId) == 0)
+            {
+                index.erase(it);
+                return;
+            }
+        }
+    };
+    vector<string> archivedIds;
+    archivedIds.reserve(rows.size());
+    for (const Transaction *txn : rows)
+    {
+        const string transactionId = txn->getTransactionId();
+        eraseIndexEntry(accountTransactions, txn->getAccountNumber(), transactionId);
+        eraseIndexEntry(customerTransactions, txn->getCustomerId(), transactionId);
+        archivedIds.push_back(transactionId);
+    }
+    dateTransactions.erase(dateTransactions.begin(), cutoff);
+    // The rows stay in the rollups; only the record of which tier holds them changes
+    for (const Transaction *txn : rows)
+    {
+        archivedRollups->add(*txn);
+        archivedCustomerSummaries->add(*txn);
+    }
+    if (!archivedRollups->save(archive->getArchiveDirectory() + "rollups.txt") ||
+        !archivedCustomerSummaries->save(archive->getArchiveDirectory() + "customer_summaries.txt"))
+    {
+        cout << "Failed to save archived rollups to: " << archive->getArchiveDirectory() << endl;
+    }
+    // Freed nodes go back to the pools and are reused by newer transactions
+    for (const string &transactionId : archivedIds)
+    {
+        auto it = transactionHistory.find(transactionId);
+        if (it != transactionHistory.end())
         {
-            ++it; // Move to next transaction
+            transactionHistory.erase(it);
         }
     }
-    cout << "Cleanup complete. Removed " << removedCount << " old transactions." << endl;
+    invalidateSnapshot();
+    lastBackupDirectory.clear(); // Removals are not expressible as an incremental set
+    checkpoint();                // Neither are they in the WAL
+    static const size_t archivedCounter = Metrics::registerCounter("ledger.archived_transactions");
+    Metrics::incrementCounter(archivedCounter, archivedIds.size());
+    publishLedgerSize();
+    return static_cast<int>(archivedIds.size());
+}
+
+// Get the archive tier (read-only)
+const TransactionArchive &TransactionManager::getArchive() const
+{
+    return *archive;
+}
+
+// Get the daily/monthly rollups (read-only)
+const TransactionRollups &TransactionManager::getRollups() const
+{
+    return *rollups;
+}
+
+// Get a customer's lifetime summary
+const CustomerSummary *TransactionManager::getCustomerSummary(const string &customerId) const
+{
+    return customerSummaries->find(customerId);
+}
+
+// Get the per-account limit engine
+LimitEngine &TransactionManager::getLimitEngine()
+{
+    return *limits;
+}
+
+// Recompute the rollups and customer summaries from the archived totals plus
+// the live ledger, and re-register the live rows' idempotency keys and limit usage
+void TransactionManager::rebuildRollups()
+{
+    TraceSpan span("rollups.rebuild", "ledger");
+    rollups->clear();
+    rollups->merge(*archivedRollups);
+    customerSummaries->clear();
+    idempotencyKeys->clear();
+    limits->clear();
+    for (const auto &pair : transactionHistory)
+    {
+        rollups->add(pair.second);
+        customerSummaries->add(pair.second); // ID order is commit order
+        limits->add(pair.second);
+        if (!pair.second.getIdempotencyKey().empty() && standsForRequest(pair.second.getStatus()))
+        {
+            // Keys expire relative to the original commit, not the restart
+            idempotencyKeys->remember(pair.second.getIdempotencyKey(), pair.second.getTransactionId(),
+                                      parseDateTime(pair.second.getTimestamp()));
+        }
+    }
+    customerSummaries->merge(*archivedCustomerSummaries);
 }
 // Rebuild transaction indexes
-void TransactionManager::reindexTransactions()
+void TransactionManager::reindexTransactions(TransactionIndex index)
 {
+    METRICS_TIME_SCOPE("TransactionManager::reindexTransactions");
+    TraceSpan span("reindex", "index");
     cout << "Rebuilding transaction indexes..." << endl;
-    accountTransactions.clear();
-    customerTransactions.clear();
-    dateTransactions.clear();
-    for (const auto &pair : transactionHistory)
+    TransactionIndexMap *indexes[INDEX_COUNT] = {&accountTransactions, &customerTransactions, &dateTransactions};
+    bool selected[INDEX_COUNT];
+    for (size_t i = 0; i < INDEX_COUNT; i++)
     {
-        const Transaction &txn = pair.second;
-        accountTransactions.emplace(txn.getAccountNumber(), txn.getTransactionId());
-        customerTransactions.emplace(txn.getCustomerId(), txn.getTransactionId());
-        dateTransactions.emplace(txn.getTimestamp().substr(0, 10), txn.getTransactionId()); // Use date part only
+        selected[i] = index == TransactionIndex::ALL || index == static_cast<TransactionIndex>(i);
     }
+
+    // Each key range extracts and sorts its own (key, id) runs (several ranges
+    // per worker, each taken by the next free worker; see partitionHistory)...
+    size_t workers = transactionHistory.size() < PARALLEL_SCAN_THRESHOLD ? 1 : getWorkerPool().getThreadCount();
+    size_t partitions = workers == 1 ? 1 : workers * RANGES_PER_WORKER;
+    vector<TransactionMap::const_iterator> bounds = partitionHistory(partitions);
+    vector<vector<IndexRun>> runs(INDEX_COUNT, vector<IndexRun>(partitions));
+    auto addEntry = [&](size_t i, size_t p, string_view key, const pmr::string &transactionId)
+    {
+        pmr::memory_resource *pool = indexes[i]->get_allocator().resource();
+        runs[i][p].emplace_back(piecewise_construct, forward_as_tuple(key, pool),
+                                forward_as_tuple(transactionId, pool));
+    };
+    auto extractRange = [&](size_t p)
+    {
+        size_t rows = distance(bounds[p], bounds[p + 1]);
+        for (size_t i = 0; i < INDEX_COUNT; i++)
+        {
+            if (selected[i])
+            {
+                runs[i][p].reserve(rows);
+            }
+        }
+        for (auto txnIt = bounds[p]; txnIt != bounds[p + 1]; ++txnIt)
+        {
+            const Transaction &txn = txnIt->second;
+            if (selected[0])
+            {
+                addEntry(0, p, txn.getAccountNumber(), txnIt->first);
+            }
+            if (selected[1])
+            {
+                addEntry(1, p, txn.getCustomerId(), txnIt->first);
+            }
+            if (selected[2])
+            {
+                addEntry(2, p, string_view(txn.getTimestamp()).substr(0, 10), txnIt->first); // Use date part only
+            }
+        }
+        for (size_t i = 0; i < INDEX_COUNT; i++)
+        {
+            sort(runs[i][p].begin(), runs[i][p].end());
+        }
+    };
+    atomic<size_t> nextRange(0);
+    auto extract = [&](size_t, size_t, size_t)
+    {
+        TraceSpan extractSpan("reindex.extract", "index");
+        for (size_t p = nextRange++; p < partitions; p = nextRange++)
+        {
+            extractRange(p);
+        }
+    };
+    if (workers == 1)
+    {
+        extract(0, 1, 0);
+    }
+    else
+    {
+        getWorkerPool().parallelFor(workers, extract);
+    }
+
+    // ...then the (key, id) space is cut into ranges at sampled splitters; each
+    // range of each index is merged into its own partial tree by the next free
+    // worker, and the partial trees are spliced into the index in key order.
+    // Splicing moves node handles (the trees share the index's pool), so it
+    // neither copies keys nor allocates.
+    size_t ranges = workers == 1 ? 1 : workers * RANGES_PER_WORKER;
+    vector<vector<TransactionIndexMap>> partials(INDEX_COUNT);
+    vector<vector<vector<IndexSlice>>> slices(INDEX_COUNT);
+    vector<pair<size_t, size_t>> mergeTasks; // (index, range)
+    for (size_t i = 0; i < INDEX_COUNT; i++)
+    {
+        if (!selected[i])
+        {
+            continue;
+        }
+        indexes[i]->clear();
+        vector<IndexEntry> splitters = chooseIndexSplitters(runs[i], ranges);
+        partials[i].reserve(splitters.size() + 1);
+        slices[i].resize(splitters.size() + 1);
+        for (size_t r = 0; r <= splitters.size(); r++)
+        {
+            partials[i].emplace_back(indexes[i]->get_allocator()); // Same pool, so nodes can be spliced
+            mergeTasks.emplace_back(i, r);
+        }
+        for (IndexRun &run : runs[i])
+        {
+            auto begin = run.begin();
+            for (size_t r = 0; r <= splitters.size(); r++)
+            {
+                auto end = r < splitters.size() ? lower_bound(begin, run.end(), splitters[r]) : run.end();
+                slices[i][r].emplace_back(begin, end);
+                begin = end;
+            }
+        }
+    }
+    atomic<size_t> nextTask(0);
+    auto merge = [&](size_t, size_t, size_t)
+    {
+        TraceSpan mergeSpan("reindex.merge", "index");
+        for (size_t t = nextTask++; t < mergeTasks.size(); t = nextTask++)
+        {
+            mergeIndexSlices(slices[mergeTasks[t].first][mergeTasks[t].second],
+                             partials[mergeTasks[t].first][mergeTasks[t].second]);
+        }
+    };
+    auto splice = [&](size_t begin, size_t end, size_t)
+    {
+        TraceSpan spliceSpan("reindex.splice", "index");
+        for (size_t i = begin; i < end; i++)
+        {
+            vector<IndexRun>().swap(runs[i]); // Keys were moved out by the merge
+            for (TransactionIndexMap &partial : partials[i])
+            {
+                while (!partial.empty())
+                {
+                    indexes[i]->insert(indexes[i]->end(), partial.extract(partial.begin()));
+                }
+            }
+        }
+    };
+    if (workers == 1)
+    {
+        merge(0, 1, 0);
+        splice(0, INDEX_COUNT, 0);
+    }
+    else
+    {
+        getWorkerPool().parallelFor(workers, merge);
+        getWorkerPool().parallelFor(INDEX_COUNT, splice);
+    }
+
     cout << "Transaction indexes rebuilt successfully." << endl;
     cout << "Total Transactions: " << transactionHistory.size() << endl;
     cout << "Total Accounts: " << accountTransactions.size() << endl;
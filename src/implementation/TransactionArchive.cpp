@@ -0,0 +1,412 @@
+#include "TransactionArchive.h"
+#include "LedgerColumnar.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
+#include <cstdlib>
+#include <cctype>
+
+using namespace std;
+
+// =============================================================================
+// CONSTRUCTOR AND CATALOG
+// =============================================================================
+
+// Constructor
+TransactionArchive::TransactionArchive(string directory, size_t cachedRowGroups) {
+    archiveDirectory = directory.empty() ? "archive/" : directory;
+    if (archiveDirectory.back() != '/') {
+        archiveDirectory += '/';
+    }
+    maxCachedRowGroups = cachedRowGroups == 0 ? 1 : cachedRowGroups;
+    nextSegmentNumber = 1;
+}
+
+// Sequence number in a segment file name (transactions_YYYY-MM_NNNN.seg), 0 if none
+static uint64_t segmentNumber(const string& segmentFile) {
+    size_t end = segmentFile.rfind(".seg");
+    size_t start = segmentFile.rfind('_', end);
+    if (end == string::npos || start == string::npos || start + 1 >= end) {
+        return 0;
+    }
+    uint64_t number = 0;
+    for (size_t i = start + 1; i < end; i++) {
+        if (!isdigit(static_cast<unsigned char>(segmentFile[i]))) {
+            return 0;
+        }
+        number = number * 10 + (segmentFile[i] - '0');
+    }
+    return number;
+}
+
+// Get catalog file path
+string TransactionArchive::getCatalogPath() const {
+    return archiveDirectory + "catalog.txt";
+}
+
+// Load the segment catalog and every segment's sparse index (segment data stays on disk)
+bool TransactionArchive::loadCatalog() {
+    segments.clear();
+    rowGroupCache.clear();
+    nextSegmentNumber = 1;
+    ifstream catalog(getCatalogPath());
+    if (!catalog.is_open()) {
+        return false; // No archive yet
+    }
+    string segmentFile;
+    while (getline(catalog, segmentFile)) {
+        if (segmentFile.empty()) {
+            continue;
+        }
+        if (segmentFile.rfind("#next ", 0) == 0) {
+            nextSegmentNumber = max<uint64_t>(nextSegmentNumber, strtoull(segmentFile.c_str() + 6, nullptr, 10));
+            continue;
+        }
+        // Numbers of skipped segments stay taken too (catalogs older than "#next" have only the names)
+        nextSegmentNumber = max(nextSegmentNumber, segmentNumber(segmentFile) + 1);
+        ArchiveSegmentInfo info;
+        info.path = archiveDirectory + segmentFile;
+        if (!readSegmentIndex(info)) {
+            cout << "Skipping archive segment with missing or damaged index: " << info.path << endl;
+            continue;
+        }
+        segments.push_back(move(info));
+    }
+    stable_sort(segments.begin(), segments.end(), [](const ArchiveSegmentInfo& a, const ArchiveSegmentInfo& b) {
+        return a.month < b.month;
+    });
+    cout << "Archive catalog loaded: " << segments.size() << " segments, "
+         << getArchivedTransactionCount() << " transactions." << endl;
+    return true;
+}
+
+// Rewrite the catalog (the next segment number, then one segment file name per line)
+bool TransactionArchive::writeCatalog() const {
+    string tempPath = getCatalogPath() + ".tmp";
+    ofstream catalog(tempPath, ios::trunc);
+    if (!catalog.is_open()) {
+        cout << "Failed to write archive catalog: " << tempPath << endl;
+        return false;
+    }
+    catalog << "#next " << nextSegmentNumber << "\n";
+    for (const ArchiveSegmentInfo& info : segments) {
+        catalog << filesystem::path(info.path).filename().string() << "\n";
+    }
+    catalog.close();
+    if (catalog.fail()) {
+        return false;
+    }
+    error_code error;
+    filesystem::rename(tempPath, getCatalogPath(), error); // Replace atomically
+    return !error;
+}
+
+// Get number of archived segments
+size_t TransactionArchive::getSegmentCount() const {
+    return segments.size();
+}
+
+string TransactionArchive::getArchiveDirectory() const {
+    return archiveDirectory;
+}
+
+// Get number of archived transactions
+uint64_t TransactionArchive::getArchivedTransactionCount() const {
+    uint64_t total = 0;
+    for (const ArchiveSegmentInfo& info : segments) {
+        total += info.rowCount;
+    }
+    return total;
+}
+
+// =============================================================================
+// SPARSE INDEX FILES
+// =============================================================================
+//
+// <segment>.idx is line based: month, row count, min and max timestamp, row
+// group count, then per row group its min and max timestamp, an "A" line of
+// account numbers and a "C" line of customer IDs.
+
+// Write the sparse index next to its segment
+bool TransactionArchive::writeSegmentIndex(const ArchiveSegmentInfo& info) const {
+    ofstream file(info.path + ".idx", ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << info.month << "\n" << info.rowCount << "\n"
+         << info.minTimestamp << "\n" << info.maxTimestamp << "\n"
+         << info.rowGroupAccounts.size() << "\n";
+    for (size_t g = 0; g < info.rowGroupAccounts.size(); g++) {
+        file << info.rowGroupMinTimestamps[g] << "\n" << info.rowGroupMaxTimestamps[g] << "\n";
+        file << "A";
+        for (const string& account : info.rowGroupAccounts[g]) {
+            file << " " << account;
+        }
+        file << "\nC";
+        for (const string& customer : info.rowGroupCustomers[g]) {
+            file << " " << customer;
+        }
+        file << "\n";
+    }
+    file.close();
+    return !file.fail();
+}
+
+// Read a segment's sparse index
+bool TransactionArchive::readSegmentIndex(ArchiveSegmentInfo& info) const {
+    ifstream file(info.path + ".idx");
+    if (!file.is_open()) {
+        return false;
+    }
+    string line;
+    size_t rowGroups = 0;
+    getline(file, info.month);
+    getline(file, line);
+    info.rowCount = strtoull(line.c_str(), nullptr, 10);
+    getline(file, info.minTimestamp);
+    getline(file, info.maxTimestamp);
+    getline(file, line);
+    rowGroups = strtoull(line.c_str(), nullptr, 10);
+    for (size_t g = 0; g < rowGroups && file; g++) {
+        string minTimestamp, maxTimestamp, accountLine, customerLine;
+        getline(file, minTimestamp);
+        getline(file, maxTimestamp);
+        getline(file, accountLine);
+        getline(file, customerLine);
+        vector<string> accounts, customers;
+        string token;
+        istringstream accountStream(accountLine);
+        accountStream >> token; // "A"
+        while (accountStream >> token) {
+            accounts.push_back(token);
+        }
+        istringstream customerStream(customerLine);
+        customerStream >> token; // "C"
+        while (customerStream >> token) {
+            customers.push_back(token);
+        }
+        info.rowGroupMinTimestamps.push_back(minTimestamp);
+        info.rowGroupMaxTimestamps.push_back(maxTimestamp);
+        info.rowGroupAccounts.push_back(move(accounts));
+        info.rowGroupCustomers.push_back(move(customers));
+    }
+    return static_cast<bool>(file) && info.rowGroupAccounts.size() == rowGroups;
+}
+
+// =============================================================================
+// ARCHIVING
+// =============================================================================
+
+// Move rows into new per-month segments
+bool TransactionArchive::archiveTransactions(const vector<const Transaction*>& rows, size_t rowGroupSize) {
+    if (rows.empty()) {
+        return false;
+    }
+    if (rowGroupSize == 0) {
+        rowGroupSize = 65536;
+    }
+    error_code error;
+    filesystem::create_directories(archiveDirectory, error);
+
+    // Group by month, oldest first within each month so row groups cover narrow time ranges
+    map<string, vector<const Transaction*>> byMonth;
+    for (const Transaction* txn : rows) {
+        byMonth[txn->getTimestamp().substr(0, 7)].push_back(txn);
+    }
+
+    size_t existingSegments = segments.size();
+    vector<string> writtenFiles;
+    bool ok = true;
+    for (auto& [month, monthRows] : byMonth) {
+        sort(monthRows.begin(), monthRows.end(), [](const Transaction* a, const Transaction* b) {
+            return a->getTimestamp() < b->getTimestamp();
+        });
+
+        // Never reuse a number, even one whose segment was skipped as damaged
+        ArchiveSegmentInfo info;
+        do {
+            stringstream name;
+            name << "transactions_" << month << "_" << setfill('0') << setw(4) << nextSegmentNumber++ << ".seg";
+            info.path = archiveDirectory + name.str();
+        } while (filesystem::exists(info.path, error));
+        info.month = month;
+        info.rowCount = monthRows.size();
+        info.minTimestamp = monthRows.front()->getTimestamp();
+        info.maxTimestamp = monthRows.back()->getTimestamp();
+
+        // Sparse index mirrors the writer's row group boundaries
+        for (size_t begin = 0; begin < monthRows.size(); begin += rowGroupSize) {
+            size_t end = min(monthRows.size(), begin + rowGroupSize);
+            vector<string> accounts, customers;
+            for (size_t i = begin; i < end; i++) {
+                accounts.push_back(monthRows[i]->getAccountNumber());
+                customers.push_back(monthRows[i]->getCustomerId());
+            }
+            sort(accounts.begin(), accounts.end());
+            accounts.erase(unique(accounts.begin(), accounts.end()), accounts.end());
+            sort(customers.begin(), customers.end());
+            customers.erase(unique(customers.begin(), customers.end()), customers.end());
+            info.rowGroupMinTimestamps.push_back(monthRows[begin]->getTimestamp());
+            info.rowGroupMaxTimestamps.push_back(monthRows[end - 1]->getTimestamp());
+            info.rowGroupAccounts.push_back(move(accounts));
+            info.rowGroupCustomers.push_back(move(customers));
+        }
+
+        ColumnarLedgerWriter writer(rowGroupSize);
+        writtenFiles.push_back(info.path);
+        if (!writer.write(info.path, monthRows) || !writeSegmentIndex(info)) {
+            cout << "Failed to write archive segment: " << info.path << endl;
+            ok = false;
+            break;
+        }
+        segments.push_back(move(info));
+    }
+
+    if (ok) {
+        stable_sort(segments.begin(), segments.end(), [](const ArchiveSegmentInfo& a, const ArchiveSegmentInfo& b) {
+            return a.month < b.month;
+        });
+        ok = writeCatalog();
+    }
+    if (!ok) {
+        // Leave the archive exactly as it was; the caller keeps the rows live
+        for (const string& path : writtenFiles) {
+            filesystem::remove(path, error);
+            filesystem::remove(path + ".idx", error);
+        }
+        loadCatalog();
+        return false;
+    }
+    rowGroupCache.clear(); // Segment positions may have shifted after sorting
+    cout << "Archived " << rows.size() << " transactions into " << (segments.size() - existingSegments)
+         << " segments." << endl;
+    return true;
+}
+
+// =============================================================================
+// QUERIES
+// =============================================================================
+
+// Decode a row group, going through the LRU cache (failed reads are reported, not cached)
+const vector<Transaction>& TransactionArchive::loadRowGroup(size_t segment, size_t rowGroup) const {
+    pair<size_t, size_t> key(segment, rowGroup);
+    for (auto it = rowGroupCache.begin(); it != rowGroupCache.end(); ++it) {
+        if (it->first == key) {
+            rowGroupCache.splice(rowGroupCache.begin(), rowGroupCache, it); // Mark most recent
+            return rowGroupCache.front().second;
+        }
+    }
+    vector<Transaction> rows;
+    ColumnarLedgerReader reader(segments[segment].path);
+    if (!reader.isValid() || !reader.readTransactions(rowGroup, rows)) {
+        // Not cached, so the next search retries the read
+        cout << "Failed to read row group " << rowGroup << " of archive segment: " << segments[segment].path << endl;
+        static const vector<Transaction> unreadable;
+        return unreadable;
+    }
+    rowGroupCache.emplace_front(key, move(rows));
+    if (rowGroupCache.size() > maxCachedRowGroups) {
+        rowGroupCache.pop_back();
+    }
+    return rowGroupCache.front().second;
+}
+
+// Find archived transactions for an account
+vector<Transaction> TransactionArchive::findByAccount(const string& accountNumber, size_t limit) const {
+    vector<Transaction> results;
+    // Newest segments and row groups first; skip anything older than the current limit-th match
+    for (size_t s = segments.size(); s-- > 0;) {
+        const ArchiveSegmentInfo& info = segments[s];
+        for (size_t g = info.rowGroupAccounts.size(); g-- > 0;) {
+            if (results.size() >= limit && info.rowGroupMaxTimestamps[g] < results[limit - 1].getTimestamp()) {
+                continue;
+            }
+            if (!binary_search(info.rowGroupAccounts[g].begin(), info.rowGroupAccounts[g].end(), accountNumber)) {
+                continue;
+            }
+            for (const Transaction& txn : loadRowGroup(s, g)) {
+                if (txn.getAccountNumber() == accountNumber) {
+                    results.push_back(txn);
+                }
+            }
+            sort(results.begin(), results.end(), [](const Transaction& a, const Transaction& b) {
+                return a.getTimestamp() > b.getTimestamp();
+            });
+        }
+    }
+    if (results.size() > limit) {
+        results.resize(limit);
+    }
+    return results;
+}
+
+// Find archived transactions for a customer
+vector<Transaction> TransactionArchive::findByCustomer(const string& customerId, size_t limit) const {
+    vector<Transaction> results;
+    for (size_t s = segments.size(); s-- > 0;) {
+        const ArchiveSegmentInfo& info = segments[s];
+        for (size_t g = info.rowGroupCustomers.size(); g-- > 0;) {
+            if (results.size() >= limit && info.rowGroupMaxTimestamps[g] < results[limit - 1].getTimestamp()) {
+                continue;
+            }
+            if (!binary_search(info.rowGroupCustomers[g].begin(), info.rowGroupCustomers[g].end(), customerId)) {
+                continue;
+            }
+            for (const Transaction& txn : loadRowGroup(s, g)) {
+                if (txn.getCustomerId() == customerId) {
+                    results.push_back(txn);
+                }
+            }
+            sort(results.begin(), results.end(), [](const Transaction& a, const Transaction& b) {
+                return a.getTimestamp() > b.getTimestamp();
+            });
+        }
+    }
+    if (results.size() > limit) {
+        results.resize(limit);
+    }
+    return results;
+}
+
+// Find archived transactions within a date range (inclusive, YYYY-MM-DD)
+vector<Transaction> TransactionArchive::findByDateRange(const string& startDate, const string& endDate) const {
+    vector<Transaction> results;
+    for (size_t s = 0; s < segments.size(); s++) {
+        const ArchiveSegmentInfo& info = segments[s];
+        if (info.maxTimestamp.substr(0, 10) < startDate || info.minTimestamp.substr(0, 10) > endDate) {
+            continue; // Whole segment outside the range
+        }
+        for (size_t g = 0; g < info.rowGroupAccounts.size(); g++) {
+            if (info.rowGroupMaxTimestamps[g].substr(0, 10) < startDate ||
+                info.rowGroupMinTimestamps[g].substr(0, 10) > endDate) {
+                continue;
+            }
+            for (const Transaction& txn : loadRowGroup(s, g)) {
+                string date = txn.getTimestamp().substr(0, 10);
+                if (date >= startDate && date <= endDate) {
+                    results.push_back(txn);
+                }
+            }
+        }
+    }
+    return results;
+}
+
+// =============================================================================
+// DISPLAY FUNCTIONS
+// =============================================================================
+
+// Display archive summary
+void TransactionArchive::displayArchiveSummary() const {
+    cout << "Archive Directory: " << archiveDirectory << endl;
+    cout << "Archived Segments: " << segments.size() << endl;
+    cout << "Archived Transactions: " << getArchivedTransactionCount() << endl;
+    for (const ArchiveSegmentInfo& info : segments) {
+        cout << "  " << info.month << " | " << info.rowCount << " rows | "
+             << info.rowGroupAccounts.size() << " row groups | "
+             << filesystem::path(info.path).filename().string() << endl;
+    }
+}
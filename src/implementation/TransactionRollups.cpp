@@ -0,0 +1,199 @@
+#include "TransactionRollups.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+
+using namespace std;
+
+// =============================================================================
+// TOTALS
+// =============================================================================
+
+void RollupTotals::merge(const RollupTotals& other) {
+    count += other.count;
+    amount += other.amount;
+    netAmount += other.netAmount;
+}
+
+void RollupTable::merge(const RollupTable& other) {
+    for (size_t type = 0; type < TRANSACTION_TYPE_COUNT; type++) {
+        for (size_t status = 0; status < TRANSACTION_STATUS_COUNT; status++) {
+            cells[type][status].merge(other.cells[type][status]);
+        }
+    }
+}
+
+// Totals for one type across every status
+RollupTotals RollupTable::getType(TransactionType type) const {
+    RollupTotals totals;
+    size_t row = static_cast<size_t>(type);
+    for (size_t status = 0; status < TRANSACTION_STATUS_COUNT && row < TRANSACTION_TYPE_COUNT; status++) {
+        totals.merge(cells[row][status]);
+    }
+    return totals;
+}
+
+// Totals for one status across every type
+RollupTotals RollupTable::getStatus(TransactionStatus status) const {
+    RollupTotals totals;
+    size_t column = static_cast<size_t>(status);
+    for (size_t type = 0; type < TRANSACTION_TYPE_COUNT && column < TRANSACTION_STATUS_COUNT; type++) {
+        totals.merge(cells[type][column]);
+    }
+    return totals;
+}
+
+RollupTotals RollupTable::getTotal() const {
+    RollupTotals totals;
+    for (const auto& row : cells) {
+        for (const RollupTotals& cell : row) {
+            totals.merge(cell);
+        }
+    }
+    return totals;
+}
+
+// =============================================================================
+// MAINTENANCE
+// =============================================================================
+
+// Add (direction 1) or remove (-1) a transaction under the given status
+void TransactionRollups::apply(const Transaction& transaction, TransactionStatus status, int direction) {
+    size_t type = static_cast<size_t>(transaction.getTransactionType());
+    size_t column = static_cast<size_t>(status);
+    const string& timestamp = transaction.getTimestamp();
+    if (type >= TRANSACTION_TYPE_COUNT || column >= TRANSACTION_STATUS_COUNT || timestamp.size() < 10) {
+        return;
+    }
+    double amount = transaction.getAmount() * direction;
+    double netAmount = transaction.getNetAmount() * direction;
+    for (RollupTable* table : {&daily[timestamp.substr(0, 10)], &monthly[timestamp.substr(0, 7)]}) {
+        RollupTotals& cell = table->cells[type][column];
+        cell.count += direction;
+        cell.amount += amount;
+        cell.netAmount += netAmount;
+    }
+}
+
+// Count a new transaction
+void TransactionRollups::add(const Transaction& transaction) {
+    apply(transaction, transaction.getStatus(), 1);
+}
+
+// Move a transaction from its previous status cell to its current one
+void TransactionRollups::changeStatus(const Transaction& transaction, TransactionStatus previousStatus) {
+    if (previousStatus != transaction.getStatus()) {
+        apply(transaction, previousStatus, -1);
+        apply(transaction, transaction.getStatus(), 1);
+    }
+}
+
+void TransactionRollups::merge(const TransactionRollups& other) {
+    for (const auto& pair : other.daily) {
+        daily[pair.first].merge(pair.second);
+    }
+    for (const auto& pair : other.monthly) {
+        monthly[pair.first].merge(pair.second);
+    }
+}
+
+void TransactionRollups::clear() {
+    daily.clear();
+    monthly.clear();
+}
+
+// =============================================================================
+// LOOKUPS
+// =============================================================================
+
+RollupTable TransactionRollups::getDay(const string& date) const {
+    auto it = daily.find(date);
+    return it != daily.end() ? it->second : RollupTable();
+}
+
+RollupTable TransactionRollups::getMonth(const string& month) const {
+    auto it = monthly.find(month);
+    return it != monthly.end() ? it->second : RollupTable();
+}
+
+// Sum an inclusive date range: monthly entries for whole months, daily ones at the edges
+RollupTable TransactionRollups::getRange(const string& startDate, const string& endDate) const {
+    RollupTable totals;
+    if (startDate > endDate) {
+        return totals;
+    }
+    auto last = monthly.upper_bound(endDate.substr(0, 7));
+    for (auto month = monthly.lower_bound(startDate.substr(0, 7)); month != last; ++month) {
+        if (month->first + "-01" >= startDate && month->first + "-31" <= endDate) {
+            totals.merge(month->second);
+            continue;
+        }
+        auto lastDay = daily.upper_bound(min(month->first + "-31", endDate));
+        for (auto day = daily.lower_bound(max(month->first + "-01", startDate)); day != lastDay; ++day) {
+            totals.merge(day->second);
+        }
+    }
+    return totals;
+}
+
+size_t TransactionRollups::getDayCount() const {
+    return daily.size();
+}
+
+// =============================================================================
+// PERSISTENCE
+// =============================================================================
+
+// Write every non-empty daily cell (monthly totals are derived on load)
+bool TransactionRollups::save(const string& path) const {
+    string tempPath = path + ".tmp";
+    ofstream file(tempPath, ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << setprecision(17);
+    for (const auto& pair : daily) {
+        for (size_t type = 0; type < TRANSACTION_TYPE_COUNT; type++) {
+            for (size_t status = 0; status < TRANSACTION_STATUS_COUNT; status++) {
+                const RollupTotals& cell = pair.second.cells[type][status];
+                if (cell.count != 0) {
+                    file << pair.first << ' ' << type << ' ' << status << ' ' << cell.count << ' '
+                         << cell.amount << ' ' << cell.netAmount << '\n';
+                }
+            }
+        }
+    }
+    file.close();
+    error_code error;
+    if (file.fail()) {
+        filesystem::remove(tempPath, error); // Keep the previous file rather than a truncated one
+        return false;
+    }
+    filesystem::rename(tempPath, path, error);
+    return !error;
+}
+
+// Replace the contents with a saved file (false if it is missing or malformed)
+bool TransactionRollups::load(const string& path) {
+    ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    clear();
+    string line;
+    while (getline(file, line)) {
+        istringstream fields(line);
+        string day;
+        size_t type = 0, status = 0;
+        RollupTotals cell;
+        if (!(fields >> day >> type >> status >> cell.count >> cell.amount >> cell.netAmount) ||
+            day.size() != 10 || type >= TRANSACTION_TYPE_COUNT || status >= TRANSACTION_STATUS_COUNT) {
+            clear();
+            return false;
+        }
+        daily[day].cells[type][status].merge(cell);
+        monthly[day.substr(0, 7)].cells[type][status].merge(cell);
+    }
+    return true;
+}
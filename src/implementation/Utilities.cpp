@@ -5,13 +5,15 @@
 #include <iomanip>
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
 
 using namespace std;
 
-// Get current date in YYYY-MM-DD format
+// Get current date in YYYY-MM-DD format (localtime_r throughout: background threads format dates too)
 string getCurrentDate() {
     time_t now = time(0);
-    tm* ltm = localtime(&now);
+    tm local;
+    tm* ltm = localtime_r(&now, &local);
     
     stringstream ss;
     ss << (1900 + ltm->tm_year) << "-"
@@ -21,6 +23,37 @@ string getCurrentDate() {
     return ss.str();
 }
 
+// Get current date and time in YYYYMMDD_HHMMSS format (safe for file names)
+string getFileTimestamp() {
+    time_t now = time(0);
+    tm local;
+    tm* ltm = localtime_r(&now, &local);
+
+    stringstream ss;
+    ss << (1900 + ltm->tm_year)
+       << setfill('0') << setw(2) << (1 + ltm->tm_mon)
+       << setfill('0') << setw(2) << ltm->tm_mday << "_"
+       << setfill('0') << setw(2) << ltm->tm_hour
+       << setfill('0') << setw(2) << ltm->tm_min
+       << setfill('0') << setw(2) << ltm->tm_sec;
+
+    return ss.str();
+}
+
+// Get the date N days before today in YYYY-MM-DD format
+string getDateDaysAgo(int days) {
+    time_t then = time(0) - static_cast<time_t>(days) * 24 * 60 * 60;
+    tm local;
+    tm* ltm = localtime_r(&then, &local);
+
+    stringstream ss;
+    ss << (1900 + ltm->tm_year) << "-"
+       << setfill('0') << setw(2) << (1 + ltm->tm_mon) << "-"
+       << setfill('0') << setw(2) << ltm->tm_mday;
+
+    return ss.str();
+}
+
 // Simple hash function for PIN security
 string simpleHash(const string& input) {
     if (input.empty()) return "0";
@@ -121,10 +154,23 @@ bool isValidAccountNumber(const string& accountNumber) {
 bool isValidAmount(const double& amount) {
     return amount >= 0.0; // Valid amounts are non-negative
 }
+// Convert a local YYYY-MM-DD HH:MM:SS timestamp to time_t
+time_t parseDateTime(const string& dateTime) {
+    tm local = {};
+    if (sscanf(dateTime.c_str(), "%d-%d-%d %d:%d:%d", &local.tm_year, &local.tm_mon, &local.tm_mday,
+               &local.tm_hour, &local.tm_min, &local.tm_sec) != 6) {
+        return -1;
+    }
+    local.tm_year -= 1900;
+    local.tm_mon -= 1;
+    local.tm_isdst = -1; // Let mktime decide
+    return mktime(&local);
+}
 // Add to Utilities.cpp
 string getCurrentDateTime() {
     time_t now = time(0);
-    tm* ltm = localtime(&now);
+    tm local;
+    tm* ltm = localtime_r(&now, &local);
     
     stringstream ss;
     ss << (1900 + ltm->tm_year) << "-"
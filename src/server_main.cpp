@@ -0,0 +1,77 @@
+// Banking server entry point
+//
+// Loads the bank's data, serves it over TCP (and optionally a Unix socket)
+// until SIGINT/SIGTERM, then saves everything back. See BankServer.h for the
+// request protocol.
+//
+//   banking_server [--bind 127.0.0.1] [--port 7878] [--unix path]
+//                  [--reactors N] [--workers N] [--max-connections N]
+//                  [--metrics-port N]
+
+#include "Bank.h"
+#include "BankServer.h"
+#include <iostream>
+#include <string>
+#include <csignal>
+#include <pthread.h>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    BankServerOptions options;
+    int metricsPort = -1;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        string value = i + 1 < argc ? argv[i + 1] : "";
+        if (arg == "--bind") {
+            options.bindAddress = value;
+        } else if (arg == "--port") {
+            options.port = atoi(value.c_str());
+        } else if (arg == "--unix") {
+            options.unixSocketPath = value;
+        } else if (arg == "--reactors") {
+            options.reactorCount = strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--workers") {
+            options.workerCount = strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--max-connections") {
+            options.maxConnections = strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--metrics-port") {
+            metricsPort = atoi(value.c_str());
+        } else {
+            cout << "Usage: " << argv[0] << " [--bind address] [--port N] [--unix path]"
+                 << " [--reactors N] [--workers N] [--max-connections N] [--metrics-port N]" << endl;
+            return arg == "--help" ? 0 : 1;
+        }
+        i++;
+    }
+
+    // Block the shutdown signals before any thread starts so only sigwait sees them
+    sigset_t shutdownSignals;
+    sigemptyset(&shutdownSignals);
+    sigaddset(&shutdownSignals, SIGINT);
+    sigaddset(&shutdownSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &shutdownSignals, nullptr);
+
+    Bank bank("Banking System");
+    bank.loadConfiguration();
+    bank.loadAllData();
+
+    if (metricsPort >= 0 && !bank.startMetricsExporter(metricsPort)) {
+        return 1;
+    }
+    BankServer server(bank, options);
+    if (!server.start()) {
+        return 1;
+    }
+
+    int received = 0;
+    sigwait(&shutdownSignals, &received);
+    cout << "Shutting down (signal " << received << ")..." << endl;
+    server.stop();
+    bank.stopMetricsExporter();
+    if (!bank.saveAllData()) {
+        cout << "Failed to save bank data." << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,793 @@
+// Banking System benchmark suite
+//
+// Measures throughput and latency percentiles of the transaction pipeline and
+// the Bank facade at several ledger sizes, and writes the results as JSON so
+// runs can be compared for regressions. The server_ cases time binary protocol
+// round trips to a BankServer over loopback TCP. The ingest_copies check counts the
+// allocations of a deposit to verify its description is copied exactly once;
+// the exit status is 1 if it fails.
+//
+//   banking_bench [--sizes 1000,10000,100000] [--ops 10000] [--repeat 5]
+//                 [--filter name] [--output bench_results.json] [--work-dir bench_data]
+//
+// Console output of the library is suppressed while an operation is timed.
+
+#include "Transaction.h"
+#include "Bank.h"
+#include "LimitEngine.h"
+#include "Utilities.h"
+#include "BankServer.h"
+#include "BankProtocol.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <cstdlib>
+#include <cmath>
+#include <new>
+#include <cstddef>
+#include <filesystem>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+using namespace std;
+
+// =============================================================================
+// ALLOCATION COUNTING
+// =============================================================================
+
+// Every heap allocation made by the process is counted (reported per operation).
+// All replaceable forms are defined so every new is paired with a delete of the
+// same family; nothrow and sized forms forward to these.
+static atomic<size_t> allocationCount(0);
+
+// Count and allocate, aligned when alignment exceeds what malloc guarantees
+static void* countedAllocate(size_t size, size_t alignment) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+    void* memory = nullptr;
+    if (alignment <= alignof(max_align_t)) {
+        memory = malloc(size);
+    } else if (posix_memalign(&memory, alignment, size) != 0) {
+        memory = nullptr;
+    }
+    if (memory == nullptr) {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new(size_t size) {
+    return countedAllocate(size, alignof(max_align_t));
+}
+
+void* operator new[](size_t size) {
+    return countedAllocate(size, alignof(max_align_t));
+}
+
+void* operator new(size_t size, align_val_t alignment) {
+    return countedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, align_val_t alignment) {
+    return countedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, align_val_t) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory, align_val_t) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t, align_val_t) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory, size_t, align_val_t) noexcept {
+    free(memory);
+}
+
+// =============================================================================
+// CONSOLE SILENCING
+// =============================================================================
+
+// Stream buffer that discards everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+    streamsize xsputn(const char*, streamsize count) override {
+        return count;
+    }
+};
+
+// Redirect cout to a null buffer for the lifetime of the object
+class QuietScope {
+private:
+    NullBuffer nullBuffer;
+    streambuf* previous;
+
+public:
+    QuietScope() {
+        previous = cout.rdbuf(&nullBuffer);
+    }
+    ~QuietScope() {
+        cout.rdbuf(previous);
+    }
+};
+
+// =============================================================================
+// MEASUREMENT
+// =============================================================================
+
+// Benchmark options from the command line
+struct BenchOptions {
+    vector<size_t> sizes = {1000, 10000, 100000};
+    size_t operations = 10000;      // Operations per cheap benchmark
+    size_t repeat = 5;              // Repetitions of whole-ledger benchmarks
+    string filter;                  // Only run benchmarks whose name contains this
+    string outputFile = "bench_results.json";
+    string workDirectory = "bench_data";
+};
+
+// Result of one benchmark at one ledger size
+struct BenchResult {
+    string name;
+    size_t records = 0;
+    size_t operations = 0;
+    double seconds = 0.0;           // Wall-clock time of the timed loop (setup excluded)
+    double operationsPerSecond = 0.0;
+    double allocationsPerOperation = 0.0;
+    uint64_t p50 = 0, p90 = 0, p99 = 0, p999 = 0, maxLatency = 0;     // Nanoseconds
+};
+
+// Get a percentile from sorted samples
+static uint64_t percentile(const vector<uint64_t>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[min(index, sorted.size() - 1)];
+}
+
+// Time each call of op(i) for i in [0, operations); setup(i) runs before it, untimed
+template <typename Setup, typename Operation>
+static BenchResult measure(const string& name, size_t records, size_t operations, Setup setup, Operation op) {
+    vector<uint64_t> samples;
+    samples.reserve(operations);
+    size_t allocations = 0;
+    chrono::steady_clock::duration setupTime(0);
+    auto loopBegin = chrono::steady_clock::now();
+    {
+        QuietScope quiet;
+        for (size_t i = 0; i < operations; i++) {
+            auto setupBegin = chrono::steady_clock::now();
+            setup(i);
+            size_t allocationsBefore = allocationCount.load(memory_order_relaxed);
+            auto begin = chrono::steady_clock::now();
+            setupTime += begin - setupBegin;
+            op(i);
+            auto end = chrono::steady_clock::now();
+            allocations += allocationCount.load(memory_order_relaxed) - allocationsBefore;
+            samples.push_back(static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(end - begin).count()));
+        }
+    }
+    auto loopEnd = chrono::steady_clock::now();
+
+    BenchResult result;
+    result.name = name;
+    result.records = records;
+    result.operations = operations;
+    // Wall-clock time of the loop without the setup calls, so it also covers the
+    // gaps between samples (timer reads, bookkeeping) that a sum of samples misses
+    result.seconds = chrono::duration<double>(loopEnd - loopBegin - setupTime).count();
+    result.operationsPerSecond = result.seconds > 0 ? operations / result.seconds : 0.0;
+    result.allocationsPerOperation = operations > 0 ? static_cast<double>(allocations) / operations : 0.0;
+    sort(samples.begin(), samples.end());
+    result.p50 = percentile(samples, 0.50);
+    result.p90 = percentile(samples, 0.90);
+    result.p99 = percentile(samples, 0.99);
+    result.p999 = percentile(samples, 0.999);
+    result.maxLatency = samples.empty() ? 0 : samples.back();
+    return result;
+}
+
+// Time each call of op(i) with no per-operation setup
+template <typename Operation>
+static BenchResult measure(const string& name, size_t records, size_t operations, Operation op) {
+    return measure(name, records, operations, [](size_t) {}, op);
+}
+
+// Format nanoseconds for the console table
+static string formatLatency(uint64_t nanoseconds) {
+    stringstream ss;
+    ss << fixed << setprecision(1);
+    if (nanoseconds >= 1000000000ULL) {
+        ss << nanoseconds / 1e9 << " s";
+    } else if (nanoseconds >= 1000000ULL) {
+        ss << nanoseconds / 1e6 << " ms";
+    } else if (nanoseconds >= 1000ULL) {
+        ss << nanoseconds / 1e3 << " us";
+    } else {
+        ss << nanoseconds << " ns";
+    }
+    return ss.str();
+}
+
+// Print one result row
+static void displayResult(const BenchResult& result) {
+    cout << left << setw(24) << result.name << right << setw(10) << result.records
+         << setw(10) << result.operations << setw(14) << fixed << setprecision(0) << result.operationsPerSecond
+         << setw(12) << formatLatency(result.p50) << setw(12) << formatLatency(result.p99)
+         << setw(12) << formatLatency(result.maxLatency) << setw(10) << setprecision(1)
+         << result.allocationsPerOperation << endl;
+}
+
+// =============================================================================
+// LEDGER SETUP
+// =============================================================================
+
+// Account number used by the benchmarks
+static string benchAccount(size_t index) {
+    stringstream ss;
+    ss << "SAV" << setfill('0') << setw(8) << index;
+    return ss.str();
+}
+
+// Customer ID used by the benchmarks
+static string benchCustomer(size_t index) {
+    stringstream ss;
+    ss << "CUST" << setfill('0') << setw(7) << index;
+    return ss.str();
+}
+
+// Number of accounts a ledger of the given size is spread over
+static size_t accountsFor(size_t records) {
+    return max<size_t>(10, records / 100);
+}
+
+// Fill a ledger with deposits spread round-robin over the accounts
+static void populateLedger(TransactionManager& manager, size_t records) {
+    const size_t batchSize = 100000;
+    size_t accounts = accountsFor(records);
+    QuietScope quiet;
+    for (size_t done = 0; done < records; done += batchSize) {
+        vector<LedgerEntry> batch;
+        size_t count = min(batchSize, records - done);
+        batch.reserve(count);
+        for (size_t i = done; i < done + count; i++) {
+            LedgerEntry entry;
+            entry.accountNumber = benchAccount(i % accounts);
+            entry.transactionType = TransactionType::DEPOSIT;
+            entry.amount = 10.0 + (i % 500);
+            entry.description = "Benchmark deposit";
+            entry.balanceBefore = 0.0;
+            entry.balanceAfter = entry.amount;
+            entry.customerId = benchCustomer((i % accounts) / 2);
+            batch.push_back(move(entry));
+        }
+        manager.processBatch(move(batch));
+    }
+}
+
+// Fresh, empty directory for one ledger
+static string prepareDirectory(const BenchOptions& options, const string& name) {
+    filesystem::path directory = filesystem::path(options.workDirectory) / name;
+    error_code error;
+    filesystem::remove_all(directory, error);
+    filesystem::create_directories(directory, error);
+    return directory.string() + "/";
+}
+
+// =============================================================================
+// BENCHMARKS
+// =============================================================================
+
+// Check whether a benchmark was selected with --filter
+static bool selected(const BenchOptions& options, const string& name) {
+    return options.filter.empty() || name.find(options.filter) != string::npos;
+}
+
+// Transaction pipeline benchmarks against a ledger of the given size
+static void runLedgerBenchmarks(const BenchOptions& options, size_t records, vector<BenchResult>& results) {
+    string directory = prepareDirectory(options, "ledger_" + to_string(records));
+    string logFile = directory + "transactions.log";
+    size_t accounts = accountsFor(records);
+    mt19937_64 random(records);
+    uniform_int_distribution<size_t> pickAccount(0, accounts - 1);
+    string today = getCurrentDate();
+
+    {
+        unique_ptr<TransactionManager> manager;
+        {
+            QuietScope quiet;
+            manager.reset(new TransactionManager(logFile, directory + "archive/"));
+        }
+        populateLedger(*manager, records);
+
+        if (selected(options, "process_deposit")) {
+            results.push_back(measure("process_deposit", records, options.operations, [&](size_t i) {
+                manager->processDeposit(benchAccount(pickAccount(random)), 25.0, "Benchmark deposit",
+                                        100.0, 125.0, benchCustomer(i % accounts));
+            }));
+            displayResult(results.back());
+        }
+        if (selected(options, "process_transfer")) {
+            results.push_back(measure("process_transfer", records, options.operations, [&](size_t i) {
+                manager->processTransfer(benchAccount(pickAccount(random)), benchAccount(pickAccount(random)),
+                                         10.0, "Benchmark transfer", 100.0, 90.0, 50.0, 60.0,
+                                         benchCustomer(i % accounts));
+            }));
+            displayResult(results.back());
+        }
+        if (selected(options, "limit_check")) {
+            LimitEngine& limits = manager->getLimitEngine();
+            vector<string> accountNumbers;
+            for (size_t i = 0; i < accounts; i++) {
+                accountNumbers.push_back(benchAccount(i));
+            }
+            time_t now = time(nullptr);
+            results.push_back(measure("limit_check", records, options.operations, [&](size_t i) {
+                TransactionType type = i % 2 == 0 ? TransactionType::WITHDRAWAL : TransactionType::TRANSFER_OUT;
+                limits.check(accountNumbers[pickAccount(random)], type, 25.0, now);
+            }));
+            displayResult(results.back());
+        }
+        if (selected(options, "account_history")) {
+            results.push_back(measure("account_history", records, options.operations, [&](size_t) {
+                manager->getAccountHistory(benchAccount(pickAccount(random)), 50);
+            }));
+            displayResult(results.back());
+        }
+        if (selected(options, "date_range")) {
+            results.push_back(measure("date_range", records, options.repeat, [&](size_t) {
+                manager->getTransactionsByDateRange(today, today);
+            }));
+            displayResult(results.back());
+        }
+        if (selected(options, "export_csv")) {
+            string csvFile = directory + "export.csv";
+            results.push_back(measure("export_csv", records, options.repeat, [&](size_t) {
+                manager->exportTransactionsToCSV(csvFile);
+            }));
+            displayResult(results.back());
+        }
+        if (selected(options, "save_history")) {
+            results.push_back(measure("save_history", records, options.repeat, [&](size_t) {
+                manager->saveTransactionHistory();
+            }));
+            displayResult(results.back());
+        }
+        QuietScope quiet;
+        manager.reset(); // Saves the history file and writes the final checkpoint
+    }
+
+    // Startup from the plain history file (no checkpoint present); shutdown is not timed
+    if (selected(options, "load_history")) {
+        string loadDirectory = prepareDirectory(options, "load_" + to_string(records));
+        unique_ptr<TransactionManager> loaded;
+        auto setup = [&](size_t) {
+            loaded.reset();
+            error_code error;
+            filesystem::remove_all(loadDirectory, error);
+            filesystem::create_directories(loadDirectory, error);
+            filesystem::copy_file(logFile, loadDirectory + "transactions.log", error);
+        };
+        results.push_back(measure("load_history", records, options.repeat, setup, [&](size_t) {
+            loaded.reset(new TransactionManager(loadDirectory + "transactions.log", loadDirectory + "archive/"));
+        }));
+        {
+            QuietScope quiet;
+            loaded.reset();
+        }
+        displayResult(results.back());
+    }
+
+    // Startup from the checkpoint left by the runs above
+    if (selected(options, "recover_checkpoint")) {
+        unique_ptr<TransactionManager> recovered;
+        auto setup = [&](size_t) {
+            recovered.reset();
+        };
+        results.push_back(measure("recover_checkpoint", records, options.repeat, setup, [&](size_t) {
+            recovered.reset(new TransactionManager(logFile, directory + "archive/"));
+        }));
+        {
+            QuietScope quiet;
+            recovered.reset();
+        }
+        displayResult(results.back());
+    }
+}
+
+// =============================================================================
+// COPY CHECKS
+// =============================================================================
+
+// Heap allocations per processDeposit() with the given description, passed as an
+// rvalue (moveText) or as an lvalue the call has to copy
+static double depositAllocations(TransactionManager& manager, const string& description, bool moveText,
+                                 size_t operations) {
+    const string account = benchAccount(1);
+    const string customer = benchCustomer(1);
+    vector<string> descriptions(operations, description); // Allocated before counting starts
+    QuietScope quiet;
+    size_t before = allocationCount.load(memory_order_relaxed);
+    for (size_t i = 0; i < operations; i++) {
+        if (moveText) {
+            manager.processDeposit(account, 25.0, move(descriptions[i]), 100.0, 125.0, customer);
+        } else {
+            manager.processDeposit(account, 25.0, descriptions[i], 100.0, 125.0, customer);
+        }
+    }
+    return static_cast<double>(allocationCount.load(memory_order_relaxed) - before) / operations;
+}
+
+// Verify that a deposit's description is copied exactly once on its way into the
+// ledger: not at all when the caller moves it in, once when the caller keeps it.
+// A description too long for the inline string buffer costs one allocation per
+// copy, so copies are counted as the allocations it adds over a short one.
+static bool checkIngestionCopies(const BenchOptions& options) {
+    if (!selected(options, "ingest_copies")) {
+        return true;
+    }
+    string directory = prepareDirectory(options, "ingest_copies");
+    unique_ptr<TransactionManager> manager;
+    {
+        QuietScope quiet;
+        manager.reset(new TransactionManager(directory + "transactions.log", directory + "archive/"));
+    }
+    const string shortText = "Deposit";                                            // Fits inline
+    const string longText = "Benchmark deposit with a description too long to fit inline";
+    size_t operations = options.operations;
+    populateLedger(*manager, 10000);                           // Generated IDs have reached their usual length
+    depositAllocations(*manager, shortText, true, operations); // Warm up pools, indexes and metrics
+    double baseline = depositAllocations(*manager, shortText, true, operations);
+    double moved = depositAllocations(*manager, longText, true, operations) - baseline;
+    double copied = depositAllocations(*manager, longText, false, operations) - baseline;
+    {
+        QuietScope quiet;
+        manager.reset();
+    }
+
+    bool passed = llround(moved) == 0 && llround(copied) == 1;
+    cout << left << setw(24) << "ingest_copies" << right << fixed << setprecision(2)
+         << " description copies per deposit: moved " << moved << ", copied " << copied
+         << " (expected 0 and 1) " << (passed ? "PASS" : "FAIL") << endl;
+    return passed;
+}
+
+// Bank facade benchmarks with the given number of customers
+static void runBankBenchmarks(const BenchOptions& options, size_t customers, vector<BenchResult>& results) {
+    if (!selected(options, "bank_")) {
+        return;
+    }
+    unique_ptr<Bank> bank;
+    {
+        QuietScope quiet;
+        bank.reset(new Bank("Benchmark Bank", "BENCH01"));
+    }
+    vector<string> accountNumbers;
+    accountNumbers.reserve(customers);
+    results.push_back(measure("bank_open_account", customers, customers, [&](size_t i) {
+        string customerId = bank->createCustomer("Bench Customer " + to_string(i), "1 Bench Street",
+                                                 "555-0100", "bench@example.com", "1234");
+        accountNumbers.push_back(bank->createSavingsAccount(customerId, 1000.0));
+    }));
+    displayResult(results.back());
+
+    mt19937_64 random(customers);
+    uniform_int_distribution<size_t> pickAccount(0, accountNumbers.size() - 1);
+    results.push_back(measure("bank_deposit", customers, options.operations, [&](size_t) {
+        bank->deposit(accountNumbers[pickAccount(random)], 25.0);
+    }));
+    displayResult(results.back());
+    results.push_back(measure("bank_transfer", customers, options.operations, [&](size_t) {
+        bank->transfer(accountNumbers[pickAccount(random)], accountNumbers[pickAccount(random)], 1.0);
+    }));
+    displayResult(results.back());
+    QuietScope quiet;
+    bank.reset();
+}
+
+// =============================================================================
+// SERVER ROUND TRIPS
+// =============================================================================
+
+// Blocking loopback client speaking the binary protocol
+class ProtocolClient {
+private:
+    int socket;
+    string received;
+
+public:
+    explicit ProtocolClient(int port) : socket(::socket(AF_INET, SOCK_STREAM, 0)) {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        if (connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(socket);
+            socket = -1;
+            return;
+        }
+        int noDelay = 1;
+        setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+
+    ~ProtocolClient() {
+        if (socket >= 0) {
+            close(socket);
+        }
+    }
+
+    bool isConnected() const {
+        return socket >= 0;
+    }
+
+    bool send(const string& frames) {
+        size_t offset = 0;
+        while (offset < frames.size()) {
+            ssize_t written = ::send(socket, frames.data() + offset, frames.size() - offset, MSG_NOSIGNAL);
+            if (written <= 0) {
+                return false;
+            }
+            offset += static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    // Wait for the next reply frame and decode it
+    bool receive(BankReply& reply) {
+        char chunk[65536];
+        size_t size;
+        while ((size = BinaryProtocol::frameSize(received)) == BinaryProtocol::INCOMPLETE) {
+            ssize_t count = recv(socket, chunk, sizeof(chunk), 0);
+            if (count <= 0) {
+                return false;
+            }
+            received.append(chunk, static_cast<size_t>(count));
+        }
+        if (size == BinaryProtocol::MALFORMED) {
+            return false;
+        }
+        BankOperation operation;
+        uint64_t requestId;
+        bool decoded = BinaryProtocol::decodeReply(string_view(received).substr(0, size), operation, requestId, reply);
+        received.erase(0, size);
+        return decoded;
+    }
+};
+
+// Binary protocol round trips through a BankServer on loopback with the given
+// number of customers: one BALANCE at a time (server_balance_rtt), and batches
+// of PIPELINE_DEPTH mixed requests sent before any reply is read
+// (server_pipelined, counted per request; its latencies are per batch)
+static void runServerBenchmarks(const BenchOptions& options, size_t customers, vector<BenchResult>& results) {
+    const size_t PIPELINE_DEPTH = 64;
+    if (!selected(options, "server_")) {
+        return;
+    }
+    unique_ptr<Bank> bank;
+    unique_ptr<BankServer> server;
+    vector<string> accountNumbers;
+    {
+        QuietScope quiet;
+        bank.reset(new Bank("Benchmark Bank", "BENCH01"));
+        accountNumbers.reserve(customers);
+        for (size_t i = 0; i < customers; i++) {
+            string customerId = bank->createCustomer("Bench Customer " + to_string(i), "1 Bench Street",
+                                                     "555-0100", "bench@example.com", "1234");
+            accountNumbers.push_back(bank->createSavingsAccount(customerId, 1000000.0));
+        }
+        BankServerOptions serverOptions;
+        serverOptions.port = 0;
+        server.reset(new BankServer(*bank, serverOptions));
+        if (!server->start()) {
+            server.reset();
+        }
+    }
+    if (server == nullptr) {
+        cout << "Could not start the bank server; server benchmarks skipped." << endl;
+        QuietScope quiet;
+        bank.reset();
+        return;
+    }
+    ProtocolClient client(server->getPort());
+    if (!client.isConnected()) {
+        cout << "Could not connect to the bank server; server benchmarks skipped." << endl;
+    } else {
+        mt19937_64 random(customers);
+        uniform_int_distribution<size_t> pickAccount(0, accountNumbers.size() - 1);
+        uint64_t nextRequestId = 1;
+        size_t failures = 0;
+        string frames;
+        BankReply reply;
+
+        results.push_back(measure("server_balance_rtt", customers, options.operations, [&](size_t) {
+            frames.clear();
+            BankRequest request;
+            request.requestId = nextRequestId++;
+            request.operation = BankOperation::BALANCE;
+            request.account = accountNumbers[pickAccount(random)];
+            BinaryProtocol::encodeRequest(frames, request);
+            if (!client.send(frames) || !client.receive(reply)) {
+                failures++;
+            }
+        }));
+        displayResult(results.back());
+
+        size_t batches = max<size_t>(1, options.operations / PIPELINE_DEPTH);
+        BenchResult pipelined = measure("server_pipelined", customers, batches, [&](size_t) {
+            frames.clear();
+            for (size_t j = 0; j < PIPELINE_DEPTH; j++) {
+                BankRequest request;
+                request.requestId = nextRequestId++;
+                request.account = accountNumbers[pickAccount(random)];
+                string key = "bench-" + to_string(request.requestId); // Clients retry with the same key
+                if (j % 4 != 3) {
+                    request.idempotencyKey = key;
+                }
+                switch (j % 4) {
+                    case 0: request.operation = BankOperation::DEPOSIT; request.amount = 5.0; break;
+                    case 1: request.operation = BankOperation::WITHDRAW; request.amount = 1.0; break;
+                    case 2:
+                        request.operation = BankOperation::TRANSFER;
+                        request.toAccount = accountNumbers[pickAccount(random)];
+                        request.amount = 1.0;
+                        break;
+                    default: request.operation = BankOperation::BALANCE; break;
+                }
+                BinaryProtocol::encodeRequest(frames, request);
+            }
+            if (!client.send(frames)) {
+                failures++;
+                return;
+            }
+            for (size_t j = 0; j < PIPELINE_DEPTH; j++) {
+                if (!client.receive(reply)) {
+                    failures++;
+                    return;
+                }
+            }
+        });
+        pipelined.operations *= PIPELINE_DEPTH;
+        pipelined.operationsPerSecond *= PIPELINE_DEPTH;
+        pipelined.allocationsPerOperation /= PIPELINE_DEPTH;
+        results.push_back(pipelined);
+        displayResult(results.back());
+        if (failures > 0) {
+            cout << failures << " server round trips failed." << endl;
+        }
+    }
+    QuietScope quiet;
+    server.reset();
+    bank.reset();
+}
+
+// =============================================================================
+// OUTPUT
+// =============================================================================
+
+// Write all results as JSON
+static bool writeJson(const string& filename, const vector<BenchResult>& results) {
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cout << "Failed to open " << filename << " for writing." << endl;
+        return false;
+    }
+    file << "{\n  \"timestamp\": \"" << getCurrentDateTime() << "\",\n"
+         << "  \"hardware_threads\": " << thread::hardware_concurrency() << ",\n"
+         << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        file << "    {\"name\": \"" << r.name << "\", \"records\": " << r.records
+             << ", \"operations\": " << r.operations << fixed << setprecision(6)
+             << ", \"seconds\": " << r.seconds << setprecision(1)
+             << ", \"ops_per_sec\": " << r.operationsPerSecond
+             << ", \"allocs_per_op\": " << setprecision(2) << r.allocationsPerOperation
+             << ", \"latency_ns\": {\"p50\": " << r.p50 << ", \"p90\": " << r.p90
+             << ", \"p99\": " << r.p99 << ", \"p999\": " << r.p999 << ", \"max\": " << r.maxLatency << "}}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    file.close();
+    return !file.fail();
+}
+
+// Parse a comma separated list of sizes
+static vector<size_t> parseSizes(const string& text) {
+    vector<size_t> sizes;
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        size_t value = strtoull(item.c_str(), nullptr, 10);
+        if (value > 0) {
+            sizes.push_back(value);
+        }
+    }
+    return sizes;
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        string value = i + 1 < argc ? argv[i + 1] : "";
+        if (arg == "--sizes") {
+            options.sizes = parseSizes(value);
+            i++;
+        } else if (arg == "--ops") {
+            options.operations = max<size_t>(1, strtoull(value.c_str(), nullptr, 10));
+            i++;
+        } else if (arg == "--repeat") {
+            options.repeat = max<size_t>(1, strtoull(value.c_str(), nullptr, 10));
+            i++;
+        } else if (arg == "--filter") {
+            options.filter = value;
+            i++;
+        } else if (arg == "--output") {
+            options.outputFile = value;
+            i++;
+        } else if (arg == "--work-dir") {
+            options.workDirectory = value;
+            i++;
+        } else {
+            cout << "Usage: " << argv[0] << " [--sizes 1000,10000,100000] [--ops N] [--repeat N]"
+                 << " [--filter name] [--output file.json] [--work-dir dir]" << endl;
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    cout << "=== Banking System Benchmarks ===" << endl;
+    cout << left << setw(24) << "Benchmark" << right << setw(10) << "Records" << setw(10) << "Ops"
+         << setw(14) << "Ops/sec" << setw(12) << "p50" << setw(12) << "p99" << setw(12) << "Max"
+         << setw(10) << "Allocs" << endl;
+    cout << string(104, '-') << endl;
+
+    bool copiesPassed = checkIngestionCopies(options);
+
+    vector<BenchResult> results;
+    for (size_t records : options.sizes) {
+        runLedgerBenchmarks(options, records, results);
+        runBankBenchmarks(options, records, results);
+        runServerBenchmarks(options, records, results);
+    }
+
+    if (!writeJson(options.outputFile, results)) {
+        return 1;
+    }
+    cout << "Results written to: " << options.outputFile << endl;
+    return copiesPassed ? 0 : 1;
+}
@@ -0,0 +1,426 @@
+// Synthetic workload generator
+//
+// Opens customers and accounts through the Bank API, then writes a ledger of
+// synthetic transactions straight to the checkpoint file TransactionManager
+// recovers from (<ledger>.checkpoint, Transaction::toRecord rows), so very
+// large datasets can be produced without going through the commit path. The
+// checkpoint starts with the rows the Bank itself committed (the opening
+// deposits), and each account's saved balance is set to the closing balance of
+// its generated history, so accounts and ledger agree.
+//
+// Account activity follows a Zipf distribution, transfers produce the usual
+// TRANSFER_OUT/TRANSFER_IN pair, and the last days of every month carry a
+// configurable burst of extra traffic. Rows are written in timestamp order
+// with per-account running balances.
+//
+//   workload_generator [--customers N] [--transactions M] [--zipf 1.1]
+//                      [--mix deposit,withdrawal,transfer,fee,interest] [--days 90]
+//                      [--month-end-burst 3.0] [--checking-share 0.5] [--seed 42]
+//                      [--ledger data/transactions.log] [--threads N]
+
+#include "Bank.h"
+#include "Transaction.h"
+#include "LedgerSnapshot.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+
+using namespace std;
+
+// Rows formatted per block (each block becomes one sequential write)
+static const size_t GENERATOR_BLOCK_ROWS = 65536;
+
+// Generator settings from the command line
+struct GeneratorOptions {
+    size_t customers = 10000;
+    size_t transactions = 1000000;          // Ledger rows (a transfer is two rows)
+    double zipfExponent = 1.1;              // 0 = uniform activity
+    double mix[5] = {40, 25, 25, 5, 5};     // Deposit, withdrawal, transfer, fee, interest weights
+    int days = 90;                          // Days of history, ending today
+    double monthEndBurst = 3.0;             // Traffic multiplier for the last two days of a month
+    double checkingShare = 0.5;             // Customers that also get a checking account
+    double initialDeposit = 1000.0;
+    uint64_t seed = 42;
+    string ledgerFile = "data/transactions.log";
+    size_t threads = 0;                     // 0 = hardware concurrency
+};
+
+// One generated ledger row before formatting
+struct GeneratedRow {
+    uint32_t account;
+    uint32_t relatedAccount;                // Transfers only
+    TransactionType type;
+    double amount;
+    double balanceBefore;
+    double balanceAfter;
+    uint32_t day;                           // Index into the day table
+    uint32_t secondOfDay;
+    uint64_t sequence;                      // Transaction number
+};
+
+// =============================================================================
+// DISTRIBUTIONS
+// =============================================================================
+
+// Zipf sampler over [0, n): rank r is drawn with weight 1 / (r + 1)^s,
+// and ranks are shuffled onto accounts so the hot accounts are spread out
+class ZipfSampler {
+private:
+    vector<double> cumulative;
+    vector<uint32_t> rankToIndex;
+
+public:
+    ZipfSampler(size_t n, double exponent, mt19937_64& random) {
+        cumulative.resize(n);
+        double total = 0.0;
+        for (size_t r = 0; r < n; r++) {
+            total += 1.0 / pow(static_cast<double>(r + 1), exponent);
+            cumulative[r] = total;
+        }
+        for (double& value : cumulative) {
+            value /= total;
+        }
+        rankToIndex.resize(n);
+        iota(rankToIndex.begin(), rankToIndex.end(), 0);
+        shuffle(rankToIndex.begin(), rankToIndex.end(), random);
+    }
+
+    uint32_t sample(mt19937_64& random) const {
+        double u = uniform_real_distribution<double>(0.0, 1.0)(random);
+        size_t rank = upper_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin();
+        return rankToIndex[min(rank, rankToIndex.size() - 1)];
+    }
+};
+
+// Calendar day of the generated history
+struct GeneratedDay {
+    string date;                            // YYYY-MM-DD
+    string compactDate;                     // YYYYMMDD (used in transaction IDs)
+    size_t rows;
+};
+
+// Build the day table, spreading rows by weight (month-end days weigh more)
+static vector<GeneratedDay> buildDays(const GeneratorOptions& options) {
+    vector<GeneratedDay> days(options.days);
+    vector<double> weights(options.days);
+    time_t now = time(nullptr);
+    double totalWeight = 0.0;
+    for (int d = 0; d < options.days; d++) {
+        time_t dayTime = now - static_cast<time_t>(options.days - 1 - d) * 86400;
+        tm local = *localtime(&dayTime);
+        char buffer[16];
+        strftime(buffer, sizeof(buffer), "%Y-%m-%d", &local);
+        days[d].date = buffer;
+        strftime(buffer, sizeof(buffer), "%Y%m%d", &local);
+        days[d].compactDate = buffer;
+        // Tomorrow-or-the-day-after in a new month means this is one of the last two days
+        time_t twoDaysLater = dayTime + 2 * 86400;
+        tm later = *localtime(&twoDaysLater);
+        bool monthEnd = later.tm_mon != local.tm_mon;
+        weights[d] = monthEnd ? options.monthEndBurst : 1.0;
+        totalWeight += weights[d];
+    }
+    size_t assigned = 0;
+    for (int d = 0; d < options.days; d++) {
+        days[d].rows = static_cast<size_t>(options.transactions * weights[d] / totalWeight);
+        assigned += days[d].rows;
+    }
+    days.back().rows += options.transactions - assigned; // Rounding remainder
+    return days;
+}
+
+// =============================================================================
+// GENERATION
+// =============================================================================
+
+// Open customers and accounts through the Bank API; returns account numbers and owners
+static void createAccounts(const GeneratorOptions& options, Bank& bank, vector<string>& accountNumbers,
+                           vector<string>& accountCustomers, mt19937_64& random) {
+    cout << "Creating " << options.customers << " customers..." << endl;
+    bernoulli_distribution withChecking(options.checkingShare);
+    for (size_t c = 0; c < options.customers; c++) {
+        // Names may only contain letters and spaces
+        string suffix;
+        for (size_t n = c; ; n /= 26) {
+            suffix += static_cast<char>('A' + n % 26);
+            if (n < 26) {
+                break;
+            }
+        }
+        stringstream phone;
+        phone << "555" << setfill('0') << setw(7) << c % 10000000;
+        string customerId = bank.createCustomer("Customer " + suffix, to_string(c) + " Synthetic Street",
+                                                phone.str(), "customer" + to_string(c) + "@example.com", "1234");
+        if (customerId.empty()) {
+            continue;
+        }
+        string savings = bank.createSavingsAccount(customerId, options.initialDeposit);
+        if (!savings.empty()) {
+            accountNumbers.push_back(savings);
+            accountCustomers.push_back(customerId);
+        }
+        if (withChecking(random)) {
+            string checking = bank.createCheckingAccount(customerId, options.initialDeposit, 500.0);
+            if (!checking.empty()) {
+                accountNumbers.push_back(checking);
+                accountCustomers.push_back(customerId);
+            }
+        }
+    }
+    cout << "Created " << accountNumbers.size() << " accounts." << endl;
+}
+
+// Transaction number of a generated ID ("TXN" + YYYYMMDD + number); 0 for any other ID
+static uint64_t transactionNumber(const string& transactionId) {
+    if (transactionId.compare(0, 3, "TXN") != 0 || transactionId.size() <= 11) {
+        return 0;
+    }
+    return strtoull(transactionId.c_str() + 11, nullptr, 10);
+}
+
+// Description written for each generated type
+static string describe(TransactionType type) {
+    switch (type) {
+        case TransactionType::DEPOSIT: return "Synthetic deposit";
+        case TransactionType::WITHDRAWAL: return "Synthetic withdrawal";
+        case TransactionType::TRANSFER_OUT: return "Synthetic transfer";
+        case TransactionType::TRANSFER_IN: return "Synthetic transfer";
+        case TransactionType::FEE_CHARGE: return "Monthly maintenance fee";
+        case TransactionType::INTEREST_CREDIT: return "Interest credit";
+        default: return "Synthetic transaction";
+    }
+}
+
+// Format rows [begin, end) as checkpoint records
+static void formatRows(const vector<GeneratedRow>& rows, size_t begin, size_t end, const vector<GeneratedDay>& days,
+                       const vector<string>& accountNumbers, const vector<string>& accountCustomers, string& out) {
+    char clock[16];
+    for (size_t i = begin; i < end; i++) {
+        const GeneratedRow& row = rows[i];
+        const GeneratedDay& day = days[row.day];
+        snprintf(clock, sizeof(clock), " %02u:%02u:%02u", row.secondOfDay / 3600, row.secondOfDay / 60 % 60,
+                 row.secondOfDay % 60);
+        bool transfer = row.type == TransactionType::TRANSFER_OUT || row.type == TransactionType::TRANSFER_IN;
+        string sequence = to_string(row.sequence);
+        if (sequence.size() < 3) {
+            sequence.insert(0, 3 - sequence.size(), '0'); // Same minimum width as generateTransactionId()
+        }
+        Transaction txn("TXN" + day.compactDate + sequence, accountNumbers[row.account],
+                        transfer ? accountNumbers[row.relatedAccount] : string(), row.type, row.amount,
+                        day.date + clock, describe(row.type), row.balanceBefore, row.balanceAfter,
+                        TransactionStatus::COMPLETED, accountCustomers[row.account], "", "");
+        out += txn.toRecord();
+        out += '\n';
+    }
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        string value = i + 1 < argc ? argv[i + 1] : "";
+        if (arg == "--customers") {
+            options.customers = strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--transactions") {
+            options.transactions = strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--zipf") {
+            options.zipfExponent = strtod(value.c_str(), nullptr);
+        } else if (arg == "--mix") {
+            stringstream ss(value);
+            string weight;
+            for (int t = 0; t < 5 && getline(ss, weight, ','); t++) {
+                options.mix[t] = max(0.0, strtod(weight.c_str(), nullptr));
+            }
+        } else if (arg == "--days") {
+            options.days = max(1, atoi(value.c_str()));
+        } else if (arg == "--month-end-burst") {
+            options.monthEndBurst = max(0.0, strtod(value.c_str(), nullptr));
+        } else if (arg == "--checking-share") {
+            options.checkingShare = min(1.0, max(0.0, strtod(value.c_str(), nullptr)));
+        } else if (arg == "--seed") {
+            options.seed = strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--ledger") {
+            options.ledgerFile = value;
+        } else if (arg == "--threads") {
+            options.threads = strtoull(value.c_str(), nullptr, 10);
+        } else {
+            cout << "Usage: " << argv[0] << " [--customers N] [--transactions M] [--zipf S]"
+                 << " [--mix deposit,withdrawal,transfer,fee,interest] [--days D] [--month-end-burst X]"
+                 << " [--checking-share F] [--seed N] [--ledger file] [--threads N]" << endl;
+            return arg == "--help" ? 0 : 1;
+        }
+        i++;
+    }
+    auto start = chrono::steady_clock::now();
+    mt19937_64 random(options.seed);
+
+    unique_ptr<Bank> bank(new Bank("Synthetic Bank", "SYN001"));
+    vector<string> accountNumbers;
+    vector<string> accountCustomers;
+    createAccounts(options, *bank, accountNumbers, accountCustomers, random);
+    if (accountNumbers.size() < 2) {
+        cout << "At least two accounts are needed to generate a ledger." << endl;
+        return 1;
+    }
+
+    filesystem::path ledger(options.ledgerFile);
+    filesystem::path directory = ledger.has_parent_path() ? ledger.parent_path() : filesystem::path(".");
+    error_code error;
+    filesystem::create_directories(directory, error);
+    string checkpointPath = options.ledgerFile + ".checkpoint";
+    string tempPath = checkpointPath + ".generating"; // Not ".tmp": the Bank's own checkpoint writer uses that
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (file == nullptr) {
+        cout << "Failed to create " << tempPath << endl;
+        return 1;
+    }
+
+    // The Bank's own rows (opening deposits) come first; generated IDs continue after them
+    shared_ptr<const LedgerSnapshot> opening = bank->getLedgerSnapshot();
+    string header = "CHECKPOINT 0 " + to_string(opening->size() + options.transactions) + "\n";
+    fwrite(header.data(), 1, header.size(), file);
+    string openingRows;
+    uint64_t sequence = 1;
+    opening->forEach([&](const Transaction& txn) {
+        openingRows += txn.toRecord();
+        openingRows += '\n';
+        sequence = max(sequence, transactionNumber(txn.getTransactionId()) + 1);
+    });
+    fwrite(openingRows.data(), 1, openingRows.size(), file);
+
+    ZipfSampler accounts(accountNumbers.size(), options.zipfExponent, random);
+    discrete_distribution<int> pickType(begin(options.mix), end(options.mix));
+    lognormal_distribution<double> pickAmount(4.0, 1.0);       // Median around 55
+    vector<double> balances(accountNumbers.size(), options.initialDeposit);
+    vector<GeneratedDay> days = buildDays(options);
+
+    // Rows are decided serially (balances depend on order) and formatted in parallel, one wave at a time
+    ThreadPool pool(options.threads);
+    size_t waveRows = GENERATOR_BLOCK_ROWS * pool.getThreadCount() * 2;
+    vector<GeneratedRow> rows;
+    rows.reserve(waveRows + 1);
+    vector<string> blocks;
+    size_t written = 0;
+
+    auto flushWave = [&]() {
+        size_t blockCount = (rows.size() + GENERATOR_BLOCK_ROWS - 1) / GENERATOR_BLOCK_ROWS;
+        blocks.assign(blockCount, string());
+        pool.parallelFor(blockCount, [&](size_t first, size_t last, size_t) {
+            for (size_t b = first; b < last; b++) {
+                size_t rowBegin = b * GENERATOR_BLOCK_ROWS;
+                size_t rowEnd = min(rows.size(), rowBegin + GENERATOR_BLOCK_ROWS);
+                blocks[b].reserve((rowEnd - rowBegin) * 160);
+                formatRows(rows, rowBegin, rowEnd, days, accountNumbers, accountCustomers, blocks[b]);
+            }
+        });
+        for (const string& block : blocks) {
+            fwrite(block.data(), 1, block.size(), file);
+        }
+        written += rows.size();
+        rows.clear();
+        cout << "\rGenerated " << written << " / " << options.transactions << " rows" << flush;
+    };
+
+    for (uint32_t d = 0; d < days.size(); d++) {
+        size_t dayRows = days[d].rows;
+        for (size_t k = 0; k < dayRows; k++) {
+            GeneratedRow row;
+            row.day = d;
+            row.secondOfDay = static_cast<uint32_t>(k * 86400 / dayRows);
+            row.account = accounts.sample(random);
+            row.relatedAccount = row.account;
+            row.amount = round(pickAmount(random) * 100.0) / 100.0;
+            row.balanceBefore = balances[row.account];
+            int type = pickType(random);
+            if (type == 2 && (k + 1 == dayRows || row.balanceBefore < 1.0)) {
+                type = 0; // No room left in the day for the second row, or nothing to send
+            }
+            if (type == 2) {
+                // Transfer: two rows with the same timestamp
+                row.relatedAccount = accounts.sample(random);
+                if (row.relatedAccount == row.account) {
+                    row.relatedAccount = (row.account + 1) % accountNumbers.size();
+                }
+                row.amount = min(row.amount, floor(row.balanceBefore * 100.0) / 100.0);
+                row.type = TransactionType::TRANSFER_OUT;
+                row.balanceAfter = row.balanceBefore - row.amount;
+                row.sequence = sequence++;
+                balances[row.account] = row.balanceAfter;
+                GeneratedRow incoming = row;
+                swap(incoming.account, incoming.relatedAccount);
+                incoming.type = TransactionType::TRANSFER_IN;
+                incoming.balanceBefore = balances[incoming.account];
+                incoming.balanceAfter = incoming.balanceBefore + incoming.amount;
+                incoming.sequence = sequence++;
+                balances[incoming.account] = incoming.balanceAfter;
+                rows.push_back(row);
+                rows.push_back(incoming);
+                k++;
+            } else {
+                if (type == 1 && row.balanceBefore < row.amount) {
+                    type = 0; // Not enough money: the customer deposits instead
+                }
+                switch (type) {
+                    case 0: row.type = TransactionType::DEPOSIT; break;
+                    case 1: row.type = TransactionType::WITHDRAWAL; break;
+                    case 3: row.type = TransactionType::FEE_CHARGE; row.amount = min(2.50, row.balanceBefore); break;
+                    default: row.type = TransactionType::INTEREST_CREDIT;
+                             row.amount = round(row.balanceBefore * 0.0005 * 100.0) / 100.0; break;
+                }
+                bool credit = row.type == TransactionType::DEPOSIT || row.type == TransactionType::INTEREST_CREDIT;
+                row.balanceAfter = row.balanceBefore + (credit ? row.amount : -row.amount);
+                row.sequence = sequence++;
+                balances[row.account] = row.balanceAfter;
+                rows.push_back(row);
+            }
+            if (rows.size() >= waveRows) {
+                flushWave();
+            }
+        }
+    }
+    flushWave();
+    cout << endl;
+
+    bool ok = fflush(file) == 0;
+    fclose(file);
+
+    // Saved balances are the closing balances of the generated history. The Bank
+    // is closed before the checkpoint is put in place: on shutdown it writes its
+    // own checkpoint of the ledger, which the generated one has to replace.
+    for (size_t a = 0; a < accountNumbers.size(); a++) {
+        Account* account = bank->findAccount(accountNumbers[a]);
+        if (account != nullptr) {
+            account->updateBalance(balances[a]);
+        }
+    }
+    ok = bank->saveAllData() && ok;
+    bank.reset();
+
+    // WAL segments (the Bank's and earlier runs') would replay on top of the generated checkpoint
+    string walPrefix = ledger.filename().string() + ".wal.";
+    for (const auto& entry : filesystem::directory_iterator(directory, error)) {
+        if (entry.path().filename().string().compare(0, walPrefix.size(), walPrefix) == 0) {
+            filesystem::remove(entry.path(), error);
+        }
+    }
+    if (!ok || rename(tempPath.c_str(), checkpointPath.c_str()) != 0) {
+        cout << "Failed to write " << checkpointPath << endl;
+        return 1;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Wrote " << written << " transactions for " << accountNumbers.size() << " accounts to "
+         << checkpointPath << " in " << fixed << setprecision(2) << seconds << " s ("
+         << setprecision(0) << written / max(seconds, 1e-9) << " rows/s)." << endl;
+    return 0;
+}